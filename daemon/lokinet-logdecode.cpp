@@ -0,0 +1,39 @@
+#include <util/logging/binary_logger.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+/// print a log written with the binary log type as text
+int
+main(int argc, char* argv[])
+{
+  if (argc > 2
+      or (argc == 2 and (std::strcmp(argv[1], "-h") == 0 or std::strcmp(argv[1], "--help") == 0)))
+  {
+    std::cerr << "usage: " << argv[0] << " [logfile]" << std::endl;
+    std::cerr << "reads standard input if no logfile is given" << std::endl;
+    return 1;
+  }
+  FILE* in = stdin;
+  if (argc == 2)
+  {
+    in = std::fopen(argv[1], "rb");
+    if (in == nullptr)
+    {
+      std::cerr << "could not open " << argv[1] << ": " << std::strerror(errno) << std::endl;
+      return 1;
+    }
+  }
+  const bool ok = llarp::DecodeBinaryLog(in, std::cout);
+  std::cout << std::flush;
+  if (in != stdin)
+    std::fclose(in);
+  if (not ok)
+  {
+    std::cerr << "not a binary log, or it ends in the middle of a record" << std::endl;
+    return 2;
+  }
+  return 0;
+}
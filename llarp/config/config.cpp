@@ -187,6 +187,49 @@ namespace llarp
           m_workerThreads = arg;
         });
 
+    conf.defineOption<int>(
+        "router",
+        "udp-batch-size",
+        Default{0},
+        Comment{
+            "How many UDP datagrams to read or write per syscall on our links, using",
+            "recvmmsg/sendmmsg. 0 or 1 disables batching. Only supported on Linux.",
+        },
+        [this](int arg) {
+          if (arg < 0 or arg > 1024)
+            throw std::invalid_argument("udp-batch-size must be between 0 and 1024");
+
+          m_UDPBatchSize = arg;
+        });
+
+    conf.defineOption<bool>(
+        "router",
+        "pmtu-discovery",
+        Default{false},
+        AssignmentAcceptor(m_PMTUDiscovery),
+        Comment{
+            "Probe each link session's path MTU and use bigger packets where the path allows.",
+            "This sets the don't fragment bit on everything our link sockets send, so if a",
+            "path's MTU shrinks its packets are dropped rather than fragmented until the next",
+            "search, every 10 minutes, settles on a smaller size.",
+        });
+
+    conf.defineOption<int>(
+        "router",
+        "transit-shards",
+        Default{0},
+        Comment{
+            "How many dedicated threads do the crypto for transit path traffic. Each path is",
+            "pinned to one of these threads by its path id so its traffic stays in order, the",
+            "main thread still forwards it. 0 does transit crypto on the worker threads.",
+        },
+        [this](int arg) {
+          if (arg < 0 or arg > 256)
+            throw std::invalid_argument("transit-shards must be between 0 and 256");
+
+          m_transitShards = arg;
+        });
+
     // Hidden option because this isn't something that should ever be turned off occasionally when
     // doing dev/testing work.
     conf.defineOption<bool>(
@@ -502,6 +545,33 @@ namespace llarp
         },
         AssignmentAcceptor(m_ifname));
 
+    conf.defineOption<int>(
+        "network",
+        "tun-queues",
+        Default{1},
+        Comment{
+            "How many queues to open on the interface. Each queue is read and written by",
+            "threads of its own, and the packets of one flow stay on one queue. More than 1",
+            "needs multi-queue tun support and is only supported on Linux.",
+        },
+        [this](int arg) {
+          if (arg < 1 or arg > 256)
+            throw std::invalid_argument("[network]:tun-queues must be between 1 and 256");
+
+          m_tunQueues = arg;
+        });
+
+    conf.defineOption<bool>(
+        "network",
+        "tun-offload",
+        Default{false},
+        AssignmentAcceptor(m_tunOffload),
+        Comment{
+            "Have the interface hand lokinet TCP and UDP super packets of up to 64KiB, which",
+            "lokinet cuts into packets that fit a path, and coalesce consecutive TCP segments",
+            "of a flow written to the interface. Only supported on Linux.",
+        });
+
     conf.defineOption<std::string>(
         "network",
         "ifaddr",
@@ -948,6 +1018,7 @@ namespace llarp
             "  file - plaintext formatting",
             "  json - json-formatted log statements",
             "  syslog - logs directed to syslog",
+            "  binary - compact binary records, read them with lokinet-logdecode",
         });
 
     conf.defineOption<std::string>(
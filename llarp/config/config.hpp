@@ -58,6 +58,12 @@ namespace llarp
 
     size_t m_JobQueueSize = 0;
 
+    size_t m_UDPBatchSize = 0;
+
+    bool m_PMTUDiscovery = false;
+
+    size_t m_transitShards = 0;
+
     std::string m_routerContactFile;
     std::string m_encryptionKeyFile;
     std::string m_identityKeyFile;
@@ -75,6 +81,8 @@ namespace llarp
     std::string m_strictConnect;
     std::string m_ifname;
     IPRange m_ifaddr;
+    size_t m_tunQueues = 1;
+    bool m_tunOffload = false;
 
     std::optional<fs::path> m_keyfile;
     std::string m_endpointType;
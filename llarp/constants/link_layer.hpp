@@ -6,6 +6,9 @@
 #include <cstdlib>
 
 constexpr size_t MAX_LINK_MSG_SIZE = 8192;
+/// largest single link layer datagram we send or accept, big enough for the largest fragment
+/// a link may negotiate on a jumbo frame path
+constexpr size_t MAX_LINK_PACKET_SIZE = 4096 + 256;
 static constexpr auto DefaultLinkSessionLifetime = 1min;
 constexpr size_t MaxSendQueueSize = 1024;
 #endif
@@ -37,6 +37,23 @@ namespace llarp
     xchacha20_alt(
         const llarp_buffer_t&, const llarp_buffer_t&, const SharedSecret&, const byte_t*) = 0;
 
+    /// xchacha symmetric cipher with many keys, same result as calling xchacha20 once for each
+    /// (key, nonce) pair but applies every key to a chunk while it is still in cache
+    virtual bool
+    xchacha20_multi(
+        const llarp_buffer_t&, const SharedSecret* keys, const TunnelNonce* nonces, size_t num) = 0;
+
+    /// encrypt then keyed hash a batch of packets laid out as hmac | nonce | payload, all with
+    /// the same key; payload is xchacha20'd in place and hmac covers nonce | payload
+    virtual bool
+    encrypt_hmac_batch(const ManagedBuffer* pkts, size_t num, const SharedSecret&) = 0;
+
+    /// check the keyed hash then decrypt a batch of packets laid out as above, all with the same
+    /// key; valid[i] says if pkts[i] authenticated, only those are decrypted
+    virtual void
+    verify_decrypt_batch(
+        const ManagedBuffer* pkts, size_t num, const SharedSecret&, bool* valid) = 0;
+
     /// path dh creator's side
     virtual bool
     dh_client(SharedSecret&, const PubKey&, const SecretKey&, const TunnelNonce&) = 0;
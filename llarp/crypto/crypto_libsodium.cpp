@@ -4,6 +4,9 @@
 #include <sodium/crypto_scalarmult.h>
 #include <sodium/crypto_scalarmult_ed25519.h>
 #include <sodium/crypto_stream_xchacha20.h>
+#include <sodium/crypto_stream_chacha20.h>
+#include <sodium/crypto_core_hchacha20.h>
+#include <sodium/crypto_verify_32.h>
 #include <sodium/crypto_core_ed25519.h>
 #include <sodium/crypto_aead_xchacha20poly1305.h>
 #include <sodium/randombytes.h>
@@ -11,6 +14,7 @@
 #include <util/mem.hpp>
 #include <util/endian.hpp>
 #include <util/str.hpp>
+#include <array>
 #include <cassert>
 #include <cstring>
 
@@ -144,6 +148,118 @@ namespace llarp
       return crypto_stream_xchacha20_xor(out.base, in.base, in.sz, n, k.data()) == 0;
     }
 
+    bool
+    CryptoLibSodium::xchacha20_multi(
+        const llarp_buffer_t& buff, const SharedSecret* keys, const TunnelNonce* nonces, size_t num)
+    {
+      // keys applied per pass over the buffer, covers the longest path we build
+      static constexpr size_t MaxKeys = 8;
+      // bytes every key is applied to before moving on, small enough to stay in L1
+      static constexpr size_t ChunkSize = 4096;
+      // chacha20 block size, the keystream counter counts these
+      static constexpr size_t BlockSize = 64;
+      static_assert(ChunkSize % BlockSize == 0);
+
+      if (num == 1)
+        return xchacha20(buff, keys[0], nonces[0]);
+
+      // xchacha20 is chacha20 keyed by hchacha20(key, nonce[0:16]) using nonce[16:24], derive
+      // the subkeys once up front so each chunk only costs the keystream itself
+      std::array<SharedSecret, MaxKeys> subkeys;
+      bool ok = true;
+      for (size_t first = 0; ok and first < num; first += MaxKeys)
+      {
+        const size_t numKeys = std::min(MaxKeys, num - first);
+        for (size_t idx = 0; ok and idx < numKeys; ++idx)
+        {
+          ok = crypto_core_hchacha20(
+                   subkeys[idx].data(),
+                   nonces[first + idx].data(),
+                   keys[first + idx].data(),
+                   nullptr)
+              == 0;
+        }
+        for (size_t pos = 0; ok and pos < buff.sz; pos += ChunkSize)
+        {
+          const size_t len = std::min(ChunkSize, buff.sz - pos);
+          for (size_t idx = 0; ok and idx < numKeys; ++idx)
+          {
+            ok = crypto_stream_chacha20_xor_ic(
+                     buff.base + pos,
+                     buff.base + pos,
+                     len,
+                     nonces[first + idx].data() + crypto_core_hchacha20_INPUTBYTES,
+                     pos / BlockSize,
+                     subkeys[idx].data())
+                == 0;
+          }
+        }
+      }
+      sodium_memzero(subkeys.data(), sizeof(subkeys));
+      return ok;
+    }
+
+    bool
+    CryptoLibSodium::encrypt_hmac_batch(
+        const ManagedBuffer* pkts, size_t num, const SharedSecret& key)
+    {
+      static_assert(HMACSIZE == crypto_verify_32_BYTES);
+      // keying blake2b is the same for every packet so do it once and copy the state
+      crypto_generichash_blake2b_state keyed;
+      if (crypto_generichash_blake2b_init(&keyed, key.data(), HMACSECSIZE, HMACSIZE) != 0)
+        return false;
+      bool ok = true;
+      for (size_t idx = 0; idx < num; ++idx)
+      {
+        const llarp_buffer_t& pkt = pkts[idx];
+        if (pkt.sz < HMACSIZE + TUNNONCESIZE)
+        {
+          ok = false;
+          continue;
+        }
+        byte_t* const nonce = pkt.base + HMACSIZE;
+        byte_t* const body = nonce + TUNNONCESIZE;
+        const size_t bodysz = pkt.sz - (HMACSIZE + TUNNONCESIZE);
+        auto state = keyed;
+        ok = crypto_stream_xchacha20_xor(body, body, bodysz, nonce, key.data()) == 0
+            and crypto_generichash_blake2b_update(&state, nonce, pkt.sz - HMACSIZE) == 0
+            and crypto_generichash_blake2b_final(&state, pkt.base, HMACSIZE) == 0 and ok;
+      }
+      sodium_memzero(&keyed, sizeof(keyed));
+      return ok;
+    }
+
+    void
+    CryptoLibSodium::verify_decrypt_batch(
+        const ManagedBuffer* pkts, size_t num, const SharedSecret& key, bool* valid)
+    {
+      crypto_generichash_blake2b_state keyed;
+      if (crypto_generichash_blake2b_init(&keyed, key.data(), HMACSECSIZE, HMACSIZE) != 0)
+      {
+        std::fill_n(valid, num, false);
+        return;
+      }
+      for (size_t idx = 0; idx < num; ++idx)
+      {
+        const llarp_buffer_t& pkt = pkts[idx];
+        valid[idx] = false;
+        if (pkt.sz < HMACSIZE + TUNNONCESIZE)
+          continue;
+        byte_t* const nonce = pkt.base + HMACSIZE;
+        byte_t* const body = nonce + TUNNONCESIZE;
+        const size_t bodysz = pkt.sz - (HMACSIZE + TUNNONCESIZE);
+        std::array<byte_t, HMACSIZE> digest;
+        auto state = keyed;
+        if (crypto_generichash_blake2b_update(&state, nonce, pkt.sz - HMACSIZE) != 0
+            or crypto_generichash_blake2b_final(&state, digest.data(), digest.size()) != 0)
+          continue;
+        if (crypto_verify_32(digest.data(), pkt.base) != 0)
+          continue;
+        valid[idx] = crypto_stream_xchacha20_xor(body, body, bodysz, nonce, key.data()) == 0;
+      }
+      sodium_memzero(&keyed, sizeof(keyed));
+    }
+
     bool
     CryptoLibSodium::dh_client(
         llarp::SharedSecret& shared, const PubKey& pk, const SecretKey& sk, const TunnelNonce& n)
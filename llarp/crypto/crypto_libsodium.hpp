@@ -30,6 +30,23 @@ namespace llarp
           const SharedSecret&,
           const byte_t*) override;
 
+      /// xchacha symmetric cipher (multikey)
+      bool
+      xchacha20_multi(
+          const llarp_buffer_t&,
+          const SharedSecret* keys,
+          const TunnelNonce* nonces,
+          size_t num) override;
+
+      /// encrypt then keyed hash a batch of packets with one key
+      bool
+      encrypt_hmac_batch(const ManagedBuffer* pkts, size_t num, const SharedSecret&) override;
+
+      /// check keyed hash then decrypt a batch of packets with one key
+      void
+      verify_decrypt_batch(
+          const ManagedBuffer* pkts, size_t num, const SharedSecret&, bool* valid) override;
+
       /// path dh creator's side
       bool
       dh_client(SharedSecret&, const PubKey&, const SecretKey&, const TunnelNonce&) override;
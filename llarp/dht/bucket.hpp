@@ -3,9 +3,9 @@
 
 #include <dht/kademlia.hpp>
 #include <dht/key.hpp>
+#include <dht/xor_trie.hpp>
 #include <util/status.hpp>
 
-#include <map>
 #include <set>
 #include <vector>
 
@@ -16,20 +16,19 @@ namespace llarp
     template <typename Val_t>
     struct Bucket
     {
-      using BucketStorage_t = std::map<Key_t, Val_t, XorMetric>;
+      using BucketStorage_t = XorTrie<Val_t>;
       using Random_t = std::function<uint64_t()>;
 
-      Bucket(const Key_t& us, Random_t r) : nodes(XorMetric(us)), random(std::move(r))
+      Bucket([[maybe_unused]] const Key_t& us, Random_t r) : random(std::move(r))
       {}
 
       util::StatusObject
       ExtractStatus() const
       {
         util::StatusObject obj{};
-        for (const auto& item : nodes)
-        {
-          obj[item.first.ToString()] = item.second.ExtractStatus();
-        }
+        nodes.ForEach([&obj](const Key_t& key, const Val_t& val) {
+          obj[key.ToString()] = val.ExtractStatus();
+        });
         return obj;
       }
 
@@ -39,56 +38,31 @@ namespace llarp
         return nodes.size();
       }
 
-      struct SetIntersector
-      {
-        bool
-        operator()(const typename BucketStorage_t::value_type& lhs, const Key_t& rhs)
-        {
-          return lhs.first < rhs;
-        }
-
-        bool
-        operator()(const Key_t& lhs, const typename BucketStorage_t::value_type& rhs)
-        {
-          return lhs < rhs.first;
-        }
-      };
-
       bool
       GetRandomNodeExcluding(Key_t& result, const std::set<Key_t>& exclude) const
       {
-        std::vector<typename BucketStorage_t::value_type> candidates;
-        std::set_difference(
-            nodes.begin(),
-            nodes.end(),
-            exclude.begin(),
-            exclude.end(),
-            std::back_inserter(candidates),
-            SetIntersector());
+        std::vector<Key_t> candidates;
+        nodes.ForEach([&candidates, &exclude](const Key_t& key, const Val_t&) {
+          if (exclude.count(key) == 0)
+            candidates.push_back(key);
+        });
 
         if (candidates.empty())
         {
           return false;
         }
-        result = candidates[random() % candidates.size()].first;
+        result = candidates[random() % candidates.size()];
         return true;
       }
 
       bool
       FindClosest(const Key_t& target, Key_t& result) const
       {
-        Key_t mindist;
-        mindist.Fill(0xff);
-        for (const auto& item : nodes)
-        {
-          auto curDist = item.first ^ target;
-          if (curDist < mindist)
-          {
-            mindist = curDist;
-            result = item.first;
-          }
-        }
-        return nodes.size() > 0;
+        const auto closest = nodes.FindClosest(target, 1);
+        if (closest.empty())
+          return false;
+        result = closest[0].first;
+        return true;
       }
 
       bool
@@ -99,22 +73,19 @@ namespace llarp
           llarp::LogWarn("Not enough dht nodes, have ", nodes.size(), " want ", N);
           return false;
         }
+        std::vector<Key_t> keys;
+        keys.reserve(nodes.size());
+        nodes.ForEach([&keys](const Key_t& key, const Val_t&) { keys.push_back(key); });
         if (nodes.size() == N)
         {
-          std::transform(
-              nodes.begin(), nodes.end(), std::inserter(result, result.end()), [](const auto& a) {
-                return a.first;
-              });
-
+          result.insert(keys.begin(), keys.end());
           return true;
         }
         size_t expecting = N;
-        size_t sz = nodes.size();
+        size_t sz = keys.size();
         while (N)
         {
-          auto itr = nodes.begin();
-          std::advance(itr, random() % sz);
-          if (result.insert(itr->first).second)
+          if (result.insert(keys[random() % sz]).second)
           {
             --N;
           }
@@ -127,23 +98,17 @@ namespace llarp
       {
         Key_t maxdist;
         maxdist.Fill(0xff);
-        Key_t mindist;
-        mindist.Fill(0xff);
-        for (const auto& item : nodes)
-        {
-          if (exclude.count(item.first))
-          {
-            continue;
-          }
-
-          auto curDist = item.first ^ target;
-          if (curDist < mindist)
-          {
-            mindist = curDist;
-            result = item.first;
-          }
-        }
-        return mindist < maxdist;
+        bool found = false;
+        nodes.VisitClosest(target, [&](const Key_t& key, const Val_t&) {
+          if (exclude.count(key))
+            return true;
+          // the furthest possible key never counted as close
+          found = (key ^ target) < maxdist;
+          if (found)
+            result = key;
+          return false;
+        });
+        return found;
       }
 
       bool
@@ -153,45 +118,49 @@ namespace llarp
           size_t N,
           const std::set<Key_t>& exclude) const
       {
-        std::set<Key_t> s(exclude.begin(), exclude.end());
-
-        Key_t peer;
-        while (N--)
-        {
-          if (!FindCloseExcluding(target, peer, s))
-          {
+        if (N == 0)
+          return true;
+        Key_t maxdist;
+        maxdist.Fill(0xff);
+        size_t found = 0;
+        nodes.VisitClosest(target, [&](const Key_t& key, const Val_t&) {
+          if (exclude.count(key))
+            return true;
+          if (not((key ^ target) < maxdist))
             return false;
-          }
-          s.insert(peer);
-          result.insert(peer);
-        }
-        return true;
+          result.insert(key);
+          return ++found < N;
+        });
+        return found == N;
       }
 
       void
       PutNode(const Val_t& val)
       {
-        auto itr = nodes.find(val.ID);
-        if (itr == nodes.end() || itr->second < val)
+        const auto* existing = nodes.Find(val.ID);
+        if (existing == nullptr || *existing < val)
         {
-          nodes[val.ID] = val;
+          nodes.Insert(val.ID, val);
         }
       }
 
       void
       DelNode(const Key_t& key)
       {
-        auto itr = nodes.find(key);
-        if (itr != nodes.end())
-        {
-          nodes.erase(itr);
-        }
+        nodes.Erase(key);
       }
 
       bool
       HasNode(const Key_t& key) const
       {
-        return nodes.find(key) != nodes.end();
+        return nodes.Has(key);
+      }
+
+      /// get a node by its key or nullptr if we do not have it
+      const Val_t*
+      GetNode(const Key_t& key) const
+      {
+        return nodes.Find(key);
       }
 
       // remove all nodes who's key matches a predicate
@@ -199,30 +168,26 @@ namespace llarp
       void
       RemoveIf(Predicate pred)
       {
-        auto itr = nodes.begin();
-        while (itr != nodes.end())
-        {
-          if (pred(itr->first))
-            itr = nodes.erase(itr);
-          else
-            ++itr;
-        }
+        std::vector<Key_t> remove;
+        nodes.ForEach([&remove, &pred](const Key_t& key, const Val_t&) {
+          if (pred(key))
+            remove.push_back(key);
+        });
+        for (const auto& key : remove)
+          nodes.Erase(key);
       }
 
       template <typename Visit_t>
       void
       ForEachNode(Visit_t visit)
       {
-        for (const auto& item : nodes)
-        {
-          visit(item.second);
-        }
+        nodes.ForEach([&visit](const Key_t&, const Val_t& val) { visit(val); });
       }
 
       void
       Clear()
       {
-        nodes.clear();
+        nodes.Clear();
       }
 
       BucketStorage_t nodes;
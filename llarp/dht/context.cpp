@@ -42,7 +42,7 @@ namespace llarp
       void
       StoreRC(const RouterContact rc) const override
       {
-        GetRouter()->rcLookupHandler().CheckRC(rc);
+        GetRouter()->rcLookupHandler().CheckRCs({rc}, nullptr);
       }
 
       void
@@ -342,17 +342,13 @@ namespace llarp
       if (_services)
       {
         // expire intro sets
-        auto& nodes = _services->nodes;
-        auto itr = nodes.begin();
-        while (itr != nodes.end())
-        {
-          if (itr->second.introset.IsExpired(now))
-          {
-            itr = nodes.erase(itr);
-          }
-          else
-            ++itr;
-        }
+        std::vector<Key_t> expired;
+        _services->ForEachNode([now, &expired](const ISNode& node) {
+          if (node.introset.IsExpired(now))
+            expired.push_back(node.ID);
+        });
+        for (const auto& key : expired)
+          _services->DelNode(key);
       }
       ScheduleCleanupTimer();
     }
@@ -420,10 +416,9 @@ namespace llarp
     std::optional<llarp::service::EncryptedIntroSet>
     Context::GetIntroSetByLocation(const Key_t& key) const
     {
-      auto itr = _services->nodes.find(key);
-      if (itr == _services->nodes.end())
-        return {};
-      return itr->second.introset;
+      if (const auto* node = _services->GetNode(key))
+        return node->introset;
+      return {};
     }
 
     void
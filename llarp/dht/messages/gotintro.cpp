@@ -5,6 +5,7 @@
 #include <memory>
 #include <path/path_context.hpp>
 #include <router/abstractrouter.hpp>
+#include <router/signature_verifier.hpp>
 #include <routing/dht_message.hpp>
 #include <tooling/dht_event.hpp>
 #include <utility>
@@ -30,34 +31,54 @@ namespace llarp
           (found.size() > 0 ? found[0] : llarp::service::EncryptedIntroSet{}),
           txid);
 
-      for (const auto& introset : found)
-      {
-        if (!introset.Verify(dht.Now()))
-        {
-          LogWarn(
-              "Invalid introset while handling direct GotIntro "
-              "from ",
-              From);
-          return false;
-        }
-      }
       TXOwner owner(From, txid);
 
-      auto serviceLookup = dht.pendingIntrosetLookups().GetPendingLookupFrom(owner);
-      if (serviceLookup)
+      if (not dht.pendingIntrosetLookups().HasPendingLookupFrom(owner))
+      {
+        LogError("no pending TX for GIM from ", From, " txid=", txid);
+        return false;
+      }
+      if (found.empty())
       {
-        if (not found.empty())
-        {
-          dht.pendingIntrosetLookups().Found(owner, serviceLookup->target, found);
-        }
-        else
-        {
-          dht.pendingIntrosetLookups().NotFound(owner, nullptr);
-        }
+        dht.pendingIntrosetLookups().NotFound(owner, nullptr);
         return true;
       }
-      LogError("no pending TX for GIM from ", From, " txid=", txid);
-      return false;
+      // check the signatures on the workers and finish the lookup once they are all done
+      router->signatureVerifier().VerifyIntroSets(
+          found,
+          dht.Now(),
+          [ctx, owner](std::vector<service::EncryptedIntroSet> introsets, std::vector<bool> valid) {
+            FinishLookup(
+                ctx->impl->pendingIntrosetLookups(), owner, std::move(introsets), valid);
+          });
+      return true;
+    }
+
+    void
+    GotIntroMessage::FinishLookup(
+        PendingLookups_t& pending,
+        const TXOwner& owner,
+        std::vector<service::EncryptedIntroSet> introsets,
+        const std::vector<bool>& valid)
+    {
+      const auto* lookup = pending.GetPendingLookupFrom(owner);
+      if (lookup == nullptr)
+        return;
+      std::vector<service::EncryptedIntroSet> good;
+      for (size_t idx = 0; idx < introsets.size(); ++idx)
+      {
+        if (valid[idx])
+          good.emplace_back(std::move(introsets[idx]));
+      }
+      if (good.size() < introsets.size())
+        LogWarn(
+            introsets.size() - good.size(),
+            " invalid introsets while handling direct GotIntro from ",
+            owner.node);
+      if (good.empty())
+        pending.NotFound(owner, nullptr);
+      else
+        pending.Found(owner, lookup->target, good);
     }
 
     bool
@@ -2,6 +2,7 @@
 #define LLARP_DHT_MESSAGES_GOT_INTRO_HPP
 
 #include <dht/message.hpp>
+#include <dht/txholder.hpp>
 #include <service/intro_set.hpp>
 #include <util/copy_or_nullptr.hpp>
 
@@ -49,6 +50,17 @@ namespace llarp
 
       bool
       HandleMessage(llarp_dht_context* ctx, std::vector<IMessage::Ptr_t>& replies) const override;
+
+      using PendingLookups_t = TXHolder<TXOwner, service::EncryptedIntroSet, TXOwner::Hash>;
+
+      /// finish the lookup pending from owner with the introsets that passed verification,
+      /// if none of them did the lookup is finished as not found
+      static void
+      FinishLookup(
+          PendingLookups_t& pending,
+          const TXOwner& owner,
+          std::vector<service::EncryptedIntroSet> introsets,
+          const std::vector<bool>& valid);
     };
 
     struct RelayedGotIntroMessage final : public GotIntroMessage
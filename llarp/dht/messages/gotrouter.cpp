@@ -117,22 +117,23 @@ namespace llarp
           dht.pendingRouterLookups().Found(owner, foundRCs[0].pubkey, foundRCs);
         return true;
       }
-      // store if valid
-      for (const auto& rc : foundRCs)
-      {
-        if (not dht.GetRouter()->rcLookupHandler().CheckRC(rc))
-          return false;
-        if (txid == 0)  // txid == 0 on gossip
-        {
-          auto* router = dht.GetRouter();
-          router->NotifyRouterEvent<tooling::RCGossipReceivedEvent>(router->pubkey(), rc);
-          router->GossipRCIfNeeded(rc);
+      // store if valid, the signatures are checked on the workers so a big dump does not stall us
+      auto* router = dht.GetRouter();
+      const bool gossip = txid == 0;  // txid == 0 on gossip
+      router->rcLookupHandler().CheckRCs(
+          foundRCs, [router, gossip](std::vector<RouterContact> rcs) {
+            if (not gossip)
+              return;
+            for (const auto& rc : rcs)
+            {
+              router->NotifyRouterEvent<tooling::RCGossipReceivedEvent>(router->pubkey(), rc);
+              router->GossipRCIfNeeded(rc);
 
-          auto peerDb = router->peerDb();
-          if (peerDb)
-            peerDb->handleGossipedRC(rc);
-        }
-      }
+              auto peerDb = router->peerDb();
+              if (peerDb)
+                peerDb->handleGossipedRC(rc);
+            }
+          });
       return true;
     }
   }  // namespace dht
@@ -0,0 +1,276 @@
+#ifndef LLARP_DHT_XOR_TRIE_HPP
+#define LLARP_DHT_XOR_TRIE_HPP
+
+#include <dht/key.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace dht
+  {
+    /// map from Key_t to Val_t kept as a compressed binary trie (crit-bit tree) over the key bits
+    ///
+    /// walking the trie towards a target visits keys in order of increasing xor distance, so the
+    /// k closest keys to any target come out in O(k + log n) without sorting anything.
+    ///
+    /// nodes are immutable and shared between copies, a change copies only the path from the root
+    /// to the changed leaf; copying a whole trie is O(1), which lets it live in rcu snapshots.
+    template <typename Val_t>
+    class XorTrie
+    {
+      struct Node;
+      using Node_ptr = std::shared_ptr<const Node>;
+
+      struct Node
+      {
+        /// the leaf's key, unused on inner nodes
+        Key_t key;
+        /// set on leaves only
+        std::optional<Val_t> value;
+        /// index of the first bit where the two subtrees differ, msb of byte 0 is bit 0
+        size_t bit = 0;
+        Node_ptr child[2];
+
+        bool
+        IsLeaf() const
+        {
+          return value.has_value();
+        }
+      };
+
+      static constexpr size_t NumBits = Key_t::SIZE * 8;
+
+      static bool
+      Bit(const Key_t& key, size_t bit)
+      {
+        return (key[bit / 8] >> (7 - (bit % 8))) & 1;
+      }
+
+      /// first bit where a and b differ, NumBits if they are equal
+      static size_t
+      FirstDifference(const Key_t& a, const Key_t& b)
+      {
+        for (size_t idx = 0; idx < Key_t::SIZE; ++idx)
+        {
+          const unsigned diff = a[idx] ^ b[idx];
+          if (diff == 0)
+            continue;
+          size_t bit = idx * 8;
+          for (unsigned mask = 0x80; (diff & mask) == 0; mask >>= 1)
+            ++bit;
+          return bit;
+        }
+        return NumBits;
+      }
+
+      static Node_ptr
+      MakeLeaf(const Key_t& key, Val_t val)
+      {
+        auto leaf = std::make_shared<Node>();
+        leaf->key = key;
+        leaf->value.emplace(std::move(val));
+        return leaf;
+      }
+
+      /// insert a key that differs from every key in the trie first at bit diff
+      static Node_ptr
+      InsertAt(const Node_ptr& node, const Key_t& key, Val_t val, size_t diff)
+      {
+        if (node->IsLeaf() or node->bit > diff)
+        {
+          auto inner = std::make_shared<Node>();
+          inner->bit = diff;
+          const bool dir = Bit(key, diff);
+          inner->child[dir] = MakeLeaf(key, std::move(val));
+          inner->child[not dir] = node;
+          return inner;
+        }
+        auto copy = std::make_shared<Node>(*node);
+        const bool dir = Bit(key, node->bit);
+        copy->child[dir] = InsertAt(node->child[dir], key, std::move(val), diff);
+        return copy;
+      }
+
+      /// replace the value of a key we already have
+      static Node_ptr
+      Replace(const Node_ptr& node, const Key_t& key, Val_t val)
+      {
+        if (node->IsLeaf())
+          return MakeLeaf(key, std::move(val));
+        auto copy = std::make_shared<Node>(*node);
+        const bool dir = Bit(key, node->bit);
+        copy->child[dir] = Replace(node->child[dir], key, std::move(val));
+        return copy;
+      }
+
+      static Node_ptr
+      EraseFrom(const Node_ptr& node, const Key_t& key, bool& erased)
+      {
+        if (node->IsLeaf())
+        {
+          erased = node->key == key;
+          return erased ? nullptr : node;
+        }
+        const bool dir = Bit(key, node->bit);
+        auto child = EraseFrom(node->child[dir], key, erased);
+        if (not erased)
+          return node;
+        // an inner node always has 2 children, collapse it if one went away
+        if (child == nullptr)
+          return node->child[not dir];
+        auto copy = std::make_shared<Node>(*node);
+        copy->child[dir] = std::move(child);
+        return copy;
+      }
+
+      /// the leaf we end up at following key's bits, the only leaf that can equal key
+      const Node*
+      BestLeaf(const Key_t& key) const
+      {
+        const Node* node = m_Root.get();
+        while (node and not node->IsLeaf())
+          node = node->child[Bit(key, node->bit)].get();
+        return node;
+      }
+
+     public:
+      size_t
+      size() const
+      {
+        return m_Size;
+      }
+
+      bool
+      empty() const
+      {
+        return m_Size == 0;
+      }
+
+      void
+      Clear()
+      {
+        m_Root.reset();
+        m_Size = 0;
+      }
+
+      /// get the value for key or nullptr if we do not have it
+      const Val_t*
+      Find(const Key_t& key) const
+      {
+        const Node* leaf = BestLeaf(key);
+        if (leaf and leaf->key == key)
+          return &*leaf->value;
+        return nullptr;
+      }
+
+      bool
+      Has(const Key_t& key) const
+      {
+        return Find(key) != nullptr;
+      }
+
+      /// add key or replace its value
+      void
+      Insert(const Key_t& key, Val_t val)
+      {
+        const Node* leaf = BestLeaf(key);
+        if (leaf == nullptr)
+        {
+          m_Root = MakeLeaf(key, std::move(val));
+          m_Size = 1;
+          return;
+        }
+        const auto diff = FirstDifference(key, leaf->key);
+        if (diff == NumBits)
+        {
+          m_Root = Replace(m_Root, key, std::move(val));
+          return;
+        }
+        m_Root = InsertAt(m_Root, key, std::move(val), diff);
+        ++m_Size;
+      }
+
+      /// remove key, returns false if we did not have it
+      bool
+      Erase(const Key_t& key)
+      {
+        if (m_Root == nullptr)
+          return false;
+        bool erased = false;
+        auto root = EraseFrom(m_Root, key, erased);
+        if (erased)
+        {
+          m_Root = std::move(root);
+          --m_Size;
+        }
+        return erased;
+      }
+
+      /// call visit(key, value) on entries in order of increasing xor distance to target until it
+      /// returns false
+      template <typename Visit>
+      void
+      VisitClosest(const Key_t& target, Visit visit) const
+      {
+        if (m_Root == nullptr)
+          return;
+        // inner node bits strictly increase going down so the stack never gets deeper than this
+        std::array<const Node*, NumBits + 1> stack;
+        size_t depth = 0;
+        stack[depth++] = m_Root.get();
+        while (depth > 0)
+        {
+          const Node* node = stack[--depth];
+          if (node->IsLeaf())
+          {
+            if (not visit(node->key, *node->value))
+              return;
+            continue;
+          }
+          // every key on target's side is closer than every key on the other side
+          const bool near = Bit(target, node->bit);
+          stack[depth++] = node->child[not near].get();
+          stack[depth++] = node->child[near].get();
+        }
+      }
+
+      /// visit every entry in ascending key order
+      template <typename Visit>
+      void
+      ForEach(Visit visit) const
+      {
+        VisitClosest(Key_t{}, [&visit](const Key_t& key, const Val_t& val) {
+          visit(key, val);
+          return true;
+        });
+      }
+
+      /// the n entries closest to target, closest first
+      std::vector<std::pair<Key_t, Val_t>>
+      FindClosest(const Key_t& target, size_t n) const
+      {
+        std::vector<std::pair<Key_t, Val_t>> closest;
+        if (n == 0)
+          return closest;
+        closest.reserve(std::min(n, m_Size));
+        VisitClosest(target, [&closest, n](const Key_t& key, const Val_t& val) {
+          closest.emplace_back(key, val);
+          return closest.size() < n;
+        });
+        return closest;
+      }
+
+     private:
+      Node_ptr m_Root;
+      size_t m_Size = 0;
+    };
+  }  // namespace dht
+}  // namespace llarp
+
+#endif
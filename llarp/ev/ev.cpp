@@ -71,3 +71,45 @@ llarp_ev_udp_sendto(struct llarp_udp_io* udp, const llarp::SockAddr& to, const l
 {
   return udp->sendto(udp, to, buf.base, buf.sz);
 }
+
+int
+llarp_ev_udp_sendmanyto(
+    struct llarp_udp_io* udp, const llarp::SockAddr& to, const ManagedBuffer* pkts, size_t num)
+{
+  return udp->sendmanyto(udp, to, pkts, num);
+}
+
+namespace
+{
+  size_t
+  BatchBucket(size_t numpkts)
+  {
+    size_t bucket = 0;
+    while (numpkts > 1 and bucket + 1 < llarp_udp_batch_stats::NumBuckets)
+    {
+      numpkts >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+}  // namespace
+
+void
+llarp_udp_batch_stats::RecordRecv(size_t numpkts)
+{
+  if (numpkts == 0)
+    return;
+  recvCalls.fetch_add(1, std::memory_order_relaxed);
+  recvPackets.fetch_add(numpkts, std::memory_order_relaxed);
+  recvBatchSizes[BatchBucket(numpkts)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+llarp_udp_batch_stats::RecordSend(size_t numpkts)
+{
+  if (numpkts == 0)
+    return;
+  sendCalls.fetch_add(1, std::memory_order_relaxed);
+  sendPackets.fetch_add(numpkts, std::memory_order_relaxed);
+  sendBatchSizes[BatchBucket(numpkts)].fetch_add(1, std::memory_order_relaxed);
+}
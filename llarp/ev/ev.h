@@ -15,6 +15,8 @@
 #endif
 #include <net/net_if.hpp>
 
+#include <array>
+#include <atomic>
 #include <memory>
 
 #include <cstdint>
@@ -56,6 +58,26 @@ llarp_ev_loop_time_now_ms(const llarp_ev_loop_ptr& ev);
 void
 llarp_ev_loop_stop(const llarp_ev_loop_ptr& ev);
 
+/// counters for how many datagrams each udp syscall carried
+struct llarp_udp_batch_stats
+{
+  /// number of histogram buckets, bucket n counts batches of [2^n, 2^(n+1)) datagrams
+  static constexpr size_t NumBuckets = 8;
+
+  std::atomic<uint64_t> recvCalls{0};
+  std::atomic<uint64_t> recvPackets{0};
+  std::atomic<uint64_t> sendCalls{0};
+  std::atomic<uint64_t> sendPackets{0};
+  std::array<std::atomic<uint64_t>, NumBuckets> recvBatchSizes{};
+  std::array<std::atomic<uint64_t>, NumBuckets> sendBatchSizes{};
+
+  void
+  RecordRecv(size_t numpkts);
+
+  void
+  RecordSend(size_t numpkts);
+};
+
 /// UDP handling configuration
 struct llarp_udp_io
 {
@@ -65,12 +87,27 @@ struct llarp_udp_io
   void* impl;
   llarp::EventLoop* parent;
 
+  /// max datagrams to move per syscall, values <= 1 disable batched io
+  /// set before adding, batching is only available on linux
+  size_t batchSize = 0;
+
+  /// set the don't fragment bit on outbound datagrams so oversized ones are dropped instead of
+  /// fragmented, needed for path mtu probing. set before adding, cleared by parent if the
+  /// platform does not support it
+  bool dontFragment = false;
+
+  /// filled in by parent
+  llarp_udp_batch_stats batchStats;
+
   /// called every event loop tick after reads
   void (*tick)(struct llarp_udp_io*);
 
   void (*recvfrom)(struct llarp_udp_io*, const llarp::SockAddr& source, ManagedBuffer);
   /// set by parent
   int (*sendto)(struct llarp_udp_io*, const llarp::SockAddr&, const byte_t*, size_t);
+  /// set by parent, send many datagrams to the same destination
+  /// returns the number of datagrams sent or -1 on error
+  int (*sendmanyto)(struct llarp_udp_io*, const llarp::SockAddr&, const ManagedBuffer*, size_t);
 };
 
 /// add UDP handler
@@ -81,6 +118,11 @@ llarp_ev_add_udp(const llarp_ev_loop_ptr& ev, struct llarp_udp_io* udp, const ll
 int
 llarp_ev_udp_sendto(struct llarp_udp_io* udp, const llarp::SockAddr& to, const llarp_buffer_t& pkt);
 
+/// send many UDP packets to one destination, batched into as few syscalls as we can
+int
+llarp_ev_udp_sendmanyto(
+    struct llarp_udp_io* udp, const llarp::SockAddr& to, const ManagedBuffer* pkts, size_t num);
+
 /// close UDP handler
 int
 llarp_ev_close_udp(struct llarp_udp_io* udp);
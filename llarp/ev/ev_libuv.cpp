@@ -3,8 +3,19 @@
 #include <util/thread/logic.hpp>
 #include <util/thread/queue.hpp>
 
+#include <cerrno>
 #include <cstring>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <netinet/in.h>
+#endif
+
 namespace libuv
 {
 #define LoopCall(h, ...)    \
@@ -13,6 +24,33 @@ namespace libuv
     __f();                  \
   }
 
+#if !defined(_WIN32) && !defined(_WIN64)
+  /// have the kernel set DF on everything we send from this socket and not fragment locally
+  static bool
+  SetDontFragment(int fd)
+  {
+#if defined(IP_MTU_DISCOVER) && defined(IP_PMTUDISC_PROBE)
+    // probe rather than do: we track the path mtu per session ourselves and the kernel's cached
+    // value would refuse the probes we use to find it
+    int val = IP_PMTUDISC_PROBE;
+    const int ret = setsockopt(fd, IPPROTO_IP, IP_MTU_DISCOVER, &val, sizeof(val));
+#elif defined(IP_DONTFRAG)
+    int val = 1;
+    const int ret = setsockopt(fd, IPPROTO_IP, IP_DONTFRAG, &val, sizeof(val));
+#else
+    (void)fd;
+    const int ret = -1;
+    errno = ENOTSUP;
+#endif
+    if (ret == -1)
+    {
+      llarp::LogWarn("cannot set don't fragment on udp socket: ", strerror(errno));
+      return false;
+    }
+    return true;
+  }
+#endif
+
   struct glue
   {
     virtual ~glue() = default;
@@ -180,6 +218,21 @@ namespace libuv
           &self->m_Handle, &buf, 1, (const sockaddr*)static_cast<const sockaddr_in*>(to));
     }
 
+    /// no batching available, one syscall per datagram
+    static int
+    SendManyTo(llarp_udp_io* udp, const llarp::SockAddr& to, const ManagedBuffer* pkts, size_t num)
+    {
+      int sent = 0;
+      for (size_t idx = 0; idx < num; ++idx)
+      {
+        if (SendTo(udp, to, pkts[idx].underlying.base, pkts[idx].underlying.sz) < 0)
+          break;
+        sent++;
+      }
+      udp->batchStats.RecordSend(sent);
+      return sent;
+    }
+
     bool
     Bind()
     {
@@ -201,11 +254,15 @@ namespace libuv
         return false;
       }
 #if defined(_WIN32) || defined(_WIN64)
+      m_UDP->dontFragment = false;
 #else
       if (uv_fileno((const uv_handle_t*)&m_Handle, &m_UDP->fd))
         return false;
+      if (m_UDP->dontFragment)
+        m_UDP->dontFragment = SetDontFragment(m_UDP->fd);
 #endif
       m_UDP->sendto = &SendTo;
+      m_UDP->sendmanyto = &SendManyTo;
       m_UDP->impl = this;
       return true;
     }
@@ -230,6 +287,199 @@ namespace libuv
     }
   };
 
+#ifdef __linux__
+  /// udp glue that moves datagrams in batches using recvmmsg/sendmmsg
+  struct udp_mmsg_glue : public glue
+  {
+    /// largest datagram we will accept, anything bigger is truncated and dropped
+    static constexpr size_t MaxDatagramSize = 9216;
+    /// how many datagrams we put into a single sendmmsg call
+    static constexpr size_t MaxSendBatch = 64;
+
+    uv_poll_t m_Handle;
+    uv_check_t m_Ticker;
+    llarp_udp_io* const m_UDP;
+    llarp::SockAddr m_Addr;
+    const size_t m_BatchSize;
+    int m_FD = -1;
+
+    std::vector<byte_t> m_Buffer;
+    std::vector<iovec> m_IOVs;
+    std::vector<sockaddr_in> m_Sources;
+    std::vector<mmsghdr> m_Msgs;
+
+    udp_mmsg_glue(uv_loop_t* loop, llarp_udp_io* udp, const llarp::SockAddr& src)
+        : m_UDP{udp}
+        , m_Addr{src}
+        , m_BatchSize{udp->batchSize}
+        , m_Buffer(udp->batchSize * MaxDatagramSize)
+        , m_IOVs(udp->batchSize)
+        , m_Sources(udp->batchSize)
+        , m_Msgs(udp->batchSize)
+    {
+      m_Handle.data = this;
+      m_Ticker.data = this;
+      uv_check_init(loop, &m_Ticker);
+      for (size_t idx = 0; idx < m_BatchSize; ++idx)
+      {
+        m_IOVs[idx].iov_base = m_Buffer.data() + (idx * MaxDatagramSize);
+        m_IOVs[idx].iov_len = MaxDatagramSize;
+      }
+    }
+
+    static void
+    OnPoll(uv_poll_t* h, int status, int events)
+    {
+      if (status < 0)
+        return;
+      if (events & UV_READABLE)
+        static_cast<udp_mmsg_glue*>(h->data)->Drain();
+    }
+
+    /// read up to m_BatchSize datagrams in one syscall and hand them up
+    void
+    Drain()
+    {
+      for (size_t idx = 0; idx < m_BatchSize; ++idx)
+      {
+        auto& hdr = m_Msgs[idx].msg_hdr;
+        hdr.msg_name = &m_Sources[idx];
+        hdr.msg_namelen = sizeof(sockaddr_in);
+        hdr.msg_iov = &m_IOVs[idx];
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = nullptr;
+        hdr.msg_controllen = 0;
+        hdr.msg_flags = 0;
+        m_Msgs[idx].msg_len = 0;
+      }
+      const int num = recvmmsg(m_FD, m_Msgs.data(), m_BatchSize, MSG_DONTWAIT, nullptr);
+      if (num <= 0)
+        return;
+      m_UDP->batchStats.RecordRecv(num);
+      if (m_UDP->recvfrom == nullptr)
+        return;
+      for (int idx = 0; idx < num; ++idx)
+      {
+        const auto& msg = m_Msgs[idx];
+        if (msg.msg_len == 0 or (msg.msg_hdr.msg_flags & MSG_TRUNC))
+          continue;
+        const llarp_buffer_t pkt{static_cast<const byte_t*>(m_IOVs[idx].iov_base), msg.msg_len};
+        m_UDP->recvfrom(m_UDP, llarp::SockAddr{m_Sources[idx]}, ManagedBuffer{pkt});
+      }
+    }
+
+    static void
+    OnTick(uv_check_t* t)
+    {
+      auto* self = static_cast<udp_mmsg_glue*>(t->data);
+      if (self->m_UDP && self->m_UDP->tick)
+        self->m_UDP->tick(self->m_UDP);
+    }
+
+    static int
+    SendTo(llarp_udp_io* udp, const llarp::SockAddr& to, const byte_t* ptr, size_t sz)
+    {
+      const ManagedBuffer pkt{llarp_buffer_t{ptr, sz}};
+      return SendManyTo(udp, to, &pkt, 1) == 1 ? 0 : -1;
+    }
+
+    /// send all datagrams with as few sendmmsg calls as possible
+    /// safe to call from any thread, no state is shared between calls
+    static int
+    SendManyTo(llarp_udp_io* udp, const llarp::SockAddr& to, const ManagedBuffer* pkts, size_t num)
+    {
+      auto* self = static_cast<udp_mmsg_glue*>(udp->impl);
+      if (self == nullptr)
+        return -1;
+      const sockaddr_in* dst = to;
+      std::array<mmsghdr, MaxSendBatch> msgs{};
+      std::array<iovec, MaxSendBatch> iovs{};
+      size_t sent = 0;
+      while (sent < num)
+      {
+        const size_t batch = std::min(num - sent, MaxSendBatch);
+        for (size_t idx = 0; idx < batch; ++idx)
+        {
+          iovs[idx].iov_base = pkts[sent + idx].underlying.base;
+          iovs[idx].iov_len = pkts[sent + idx].underlying.sz;
+          auto& hdr = msgs[idx].msg_hdr;
+          hdr.msg_name = const_cast<sockaddr_in*>(dst);
+          hdr.msg_namelen = sizeof(sockaddr_in);
+          hdr.msg_iov = &iovs[idx];
+          hdr.msg_iovlen = 1;
+        }
+        const int ret = sendmmsg(self->m_FD, msgs.data(), batch, MSG_DONTWAIT);
+        if (ret <= 0)
+          break;
+        udp->batchStats.RecordSend(ret);
+        sent += ret;
+      }
+      return sent;
+    }
+
+    bool
+    Bind(uv_loop_t* loop)
+    {
+      m_FD = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (m_FD == -1)
+      {
+        llarp::LogError("failed to create udp socket: ", strerror(errno));
+        return false;
+      }
+      const sockaddr_in* addr = m_Addr;
+      if (bind(m_FD, (const sockaddr*)addr, sizeof(sockaddr_in)) == -1)
+      {
+        llarp::LogError("failed to bind to ", m_Addr, " ", strerror(errno));
+        return false;
+      }
+      if (uv_poll_init(loop, &m_Handle, m_FD))
+      {
+        llarp::LogError("failed to initialize polling on ", m_Addr);
+        return false;
+      }
+      if (uv_poll_start(&m_Handle, UV_READABLE, &OnPoll))
+      {
+        llarp::LogError("failed to start recving packets via ", m_Addr);
+        return false;
+      }
+      if (uv_check_start(&m_Ticker, &OnTick))
+      {
+        llarp::LogError("failed to start ticker");
+        return false;
+      }
+      if (m_UDP->dontFragment)
+        m_UDP->dontFragment = SetDontFragment(m_FD);
+      m_UDP->fd = m_FD;
+      m_UDP->sendto = &SendTo;
+      m_UDP->sendmanyto = &SendManyTo;
+      m_UDP->impl = this;
+      llarp::LogInfo("batched udp io on ", m_Addr, " with up to ", m_BatchSize, " datagrams");
+      return true;
+    }
+
+    static void
+    OnClosed(uv_handle_t* h)
+    {
+      auto* self = static_cast<udp_mmsg_glue*>(h->data);
+      if (self)
+      {
+        h->data = nullptr;
+        ::close(self->m_FD);
+        delete self;
+      }
+    }
+
+    void
+    Close() override
+    {
+      m_UDP->impl = nullptr;
+      uv_check_stop(&m_Ticker);
+      uv_poll_stop(&m_Handle);
+      uv_close((uv_handle_t*)&m_Handle, &OnClosed);
+    }
+  };
+#endif
+
   struct tun_glue : public glue
   {
     uv_poll_t m_Handle;
@@ -267,7 +517,9 @@ namespace libuv
     Read()
     {
       auto pkt = m_NetIf->ReadNextPacket();
-      LogDebug("got packet ", pkt.sz);
+      LogDebug("got packet ", pkt.size());
+      if (pkt.empty())
+        return;
       if (m_Handler)
         m_Handler(std::move(pkt));
     }
@@ -550,6 +802,20 @@ namespace libuv
   bool
   Loop::udp_listen(llarp_udp_io* udp, const llarp::SockAddr& src)
   {
+#ifdef __linux__
+    if (udp->batchSize > 1)
+    {
+      auto* impl = new udp_mmsg_glue(&m_Impl, udp, src);
+      udp->impl = impl;
+      if (impl->Bind(&m_Impl))
+        return true;
+      llarp::LogError("Loop::udp_listen failed to bind batched udp");
+      if (impl->m_FD != -1)
+        ::close(impl->m_FD);
+      delete impl;
+      return false;
+    }
+#endif
     auto* impl = new udp_glue(&m_Impl, udp, src);
     udp->impl = impl;
     if (impl->Bind())
@@ -591,7 +857,7 @@ namespace libuv
   {
     if (udp == nullptr)
       return false;
-    auto* glue = static_cast<udp_glue*>(udp->impl);
+    auto* glue = static_cast<libuv::glue*>(udp->impl);
     if (glue == nullptr)
       return false;
     glue->Close();
@@ -2,7 +2,10 @@
 
 #include <net/ip_range.hpp>
 #include <net/ip_packet.hpp>
+
+#include <chrono>
 #include <set>
+#include <vector>
 
 namespace llarp
 {
@@ -29,6 +32,10 @@ namespace llarp::vpn
     std::string ifname;
     huint32_t dnsaddr;
     std::set<InterfaceAddress> addrs;
+    /// how many queues to open on the interface, platforms without multi-queue support open one
+    size_t queues = 1;
+    /// have the interface hand us and take tcp and udp super packets where the platform can
+    bool offload = false;
   };
 
   /// a vpn network interface
@@ -62,6 +69,50 @@ namespace llarp::vpn
     /// returns false if we dropped it
     virtual bool
     WritePacket(net::IPPacket pkt) = 0;
+
+    /// write packets to a queue of the interface in order, which it may coalesce
+    /// returns how many of them we wrote
+    virtual size_t
+    WritePacketsTo(size_t queue, std::vector<net::IPPacket> pkts)
+    {
+      size_t written = 0;
+      for (auto& pkt : pkts)
+      {
+        if (WritePacketTo(queue, std::move(pkt)))
+          written++;
+      }
+      return written;
+    }
+
+    /// how many queues the interface has, each of which can be read and written on its own thread
+    virtual size_t
+    NumQueues() const
+    {
+      return 1;
+    }
+
+    /// read the next ip packet of a queue without blocking, empty if none is waiting
+    virtual net::IPPacket
+    ReadNextPacketFrom(size_t)
+    {
+      return ReadNextPacket();
+    }
+
+    /// block until a queue has a packet to read or the timeout passed
+    /// returns true if it has one
+    virtual bool
+    WaitForPacket(size_t, std::chrono::milliseconds)
+    {
+      return true;
+    }
+
+    /// write a packet to a queue of the interface
+    /// returns false if we dropped it
+    virtual bool
+    WritePacketTo(size_t, net::IPPacket pkt)
+    {
+      return WritePacket(std::move(pkt));
+    }
   };
 
   /// a vpn platform
@@ -138,7 +138,7 @@ namespace llarp
       {
         return false;
       }
-      m_UpstreamQueue.emplace(pkt, counter);
+      m_UpstreamQueue.emplace(std::move(pkt), counter);
       m_TxRate += buf.underlying.sz;
       m_LastActive = m_Parent->Now();
       return true;
@@ -188,7 +188,9 @@ namespace llarp
       // flush upstream queue
       while (m_UpstreamQueue.size())
       {
-        m_Parent->QueueOutboundTraffic(m_UpstreamQueue.top().pkt);
+        // the queue is ordered by counter alone so moving the packet out of the top is safe
+        auto& top = const_cast<UpstreamBuffer&>(m_UpstreamQueue.top());
+        m_Parent->QueueOutboundTraffic(std::move(top.pkt));
         m_UpstreamQueue.pop();
       }
       // flush downstream queue
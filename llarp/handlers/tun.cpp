@@ -73,6 +73,8 @@ namespace llarp
       obj["ourIP"] = m_OurIP.ToString();
       obj["nextIP"] = m_NextIP.ToString();
       obj["maxIP"] = m_MaxIP.ToString();
+      if (m_QueueWorkers)
+        obj["tunQueues"] = m_QueueWorkers->ExtractStatus();
       return obj;
     }
 
@@ -178,6 +180,8 @@ namespace llarp
           throw std::runtime_error("cannot find free interface name");
         m_IfName = *maybe;
       }
+      m_TunQueues = conf.m_tunQueues;
+      m_TunOffload = conf.m_tunOffload;
 
       m_OurRange = conf.m_ifaddr;
       if (!m_OurRange.addr.h)
@@ -207,11 +211,25 @@ namespace llarp
       FlushSend();
       Pump(Now());
       // flush network to user
+      if (m_NetworkToUserPktQueue.empty())
+        return;
+      std::vector<net::IPPacket> pkts;
+      pkts.reserve(m_NetworkToUserPktQueue.size());
       while (not m_NetworkToUserPktQueue.empty())
       {
-        m_NetIf->WritePacket(m_NetworkToUserPktQueue.top().pkt);
+        // the queue is ordered by seqno alone so moving the packet out of the top is safe
+        auto& top = const_cast<WritePacket&>(m_NetworkToUserPktQueue.top());
+        pkts.emplace_back(std::move(top.pkt));
         m_NetworkToUserPktQueue.pop();
       }
+      if (not m_QueueWorkers)
+      {
+        // in one go so an offloading interface can coalesce them
+        m_NetIf->WritePacketsTo(0, std::move(pkts));
+        return;
+      }
+      for (auto& pkt : pkts)
+        m_QueueWorkers->WritePacket(std::move(pkt));
     }
 
     static bool
@@ -722,6 +740,8 @@ namespace llarp
 
       info.ifname = m_IfName;
       info.dnsaddr.FromString(m_LocalResolverAddr.toHost());
+      info.queues = m_TunQueues;
+      info.offload = m_TunOffload;
 
       LogInfo(Name(), " setting up network...");
 
@@ -742,8 +762,26 @@ namespace llarp
       LogInfo(Name(), " got network interface ", m_IfName);
 
       auto netloop = Router()->netloop();
-      if (not netloop->add_network_interface(
-              m_NetIf, [&](net::IPPacket pkt) { HandleGotUserPacket(std::move(pkt)); }))
+      if (m_NetIf->NumQueues() > 1)
+      {
+        // the queue workers read on threads of their own, only the packets they read come to the
+        // logic thread, at most one flush at a time
+        m_QueueWorkers = std::make_unique<vpn::QueueWorkers>(
+            m_NetIf, [this, netloop](std::vector<net::IPPacket> pkts) {
+              for (auto& pkt : pkts)
+                HandleGotUserPacket(std::move(pkt));
+              if (m_UserPacketsFlushQueued.exchange(true))
+                return;
+              netloop->call_soon([this]() {
+                m_UserPacketsFlushQueued = false;
+                Flush();
+              });
+            });
+        m_QueueWorkers->Start();
+        LogInfo(Name(), " reading ", m_QueueWorkers->NumQueues(), " queues of ", m_IfName);
+      }
+      else if (not netloop->add_network_interface(
+                   m_NetIf, [&](net::IPPacket pkt) { HandleGotUserPacket(std::move(pkt)); }))
       {
         LogError(Name(), " failed to add network interface");
         return false;
@@ -807,6 +845,8 @@ namespace llarp
     {
       if (m_Resolver)
         m_Resolver->Stop();
+      if (m_QueueWorkers)
+        m_QueueWorkers->Stop();
       return llarp::service::Endpoint::Stop();
     }
 
@@ -870,7 +910,8 @@ namespace llarp
             MarkAddressOutbound(addr);
             EnsurePathToService(
                 addr,
-                [addr, pkt, self = this](service::Address, service::OutboundContext* ctx) {
+                [addr, pkt = std::move(pkt), self = this](
+                    service::Address, service::OutboundContext* ctx) {
                   if (ctx)
                   {
                     ctx->sendTimeout = 5s;
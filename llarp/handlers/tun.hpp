@@ -10,7 +10,9 @@
 #include <service/endpoint.hpp>
 #include <util/codel.hpp>
 #include <util/thread/threading.hpp>
+#include <vpn/queue_workers.hpp>
 
+#include <atomic>
 #include <future>
 #include <queue>
 
@@ -256,8 +258,16 @@ namespace llarp
       /// use v6?
       bool m_UseV6;
       std::string m_IfName;
+      /// how many queues we ask the interface for
+      size_t m_TunQueues = 1;
+      /// do we ask the interface for tcp and udp super packets
+      bool m_TunOffload = false;
 
       std::shared_ptr<vpn::NetworkInterface> m_NetIf;
+      /// drains the interface when it has more than one queue, the event loop does otherwise
+      std::unique_ptr<vpn::QueueWorkers> m_QueueWorkers;
+      /// a flush for packets read by the queue workers is already queued on the logic thread
+      std::atomic<bool> m_UserPacketsFlushQueued{false};
     };
 
   }  // namespace handlers
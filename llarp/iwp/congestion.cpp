@@ -0,0 +1,162 @@
+#include <iwp/congestion.hpp>
+
+#include <algorithm>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// how many packets may go out back to back after an idle period
+    static constexpr size_t PacingBurst = CongestionControl::InitialWindow;
+
+    bool
+    CongestionControl::CanSend(size_t inFlight, size_t fragments) const
+    {
+      return inFlight == 0 or inFlight + fragments <= m_Window;
+    }
+
+    void
+    CongestionControl::OnRTTSample(llarp_time_t rtt)
+    {
+      // rfc 6298
+      m_Backoff = 0;
+      if (not m_HaveRTT)
+      {
+        m_SRTT = rtt;
+        m_RTTVar = rtt / 2;
+        m_HaveRTT = true;
+        return;
+      }
+      const auto delta = m_SRTT > rtt ? m_SRTT - rtt : rtt - m_SRTT;
+      m_RTTVar = (m_RTTVar * 3 + delta) / 4;
+      m_SRTT = (m_SRTT * 7 + rtt) / 8;
+    }
+
+    void
+    CongestionControl::OnAcked(size_t fragments)
+    {
+      if (m_Window < m_SSThresh)
+      {
+        m_Window = std::min(m_Window + fragments, MaxWindow);
+        return;
+      }
+      m_AckedSinceGrow += fragments;
+      while (m_AckedSinceGrow >= m_Window and m_Window < MaxWindow)
+      {
+        m_AckedSinceGrow -= m_Window;
+        m_Window++;
+      }
+    }
+
+    void
+    CongestionControl::OnLoss(llarp_time_t now)
+    {
+      if (now < m_RecoveryUntil)
+        return;
+      m_LossEvents++;
+      m_SSThresh = std::max(m_Window / 2, MinWindow);
+      m_Window = m_SSThresh;
+      m_AckedSinceGrow = 0;
+      m_RecoveryUntil = now + (m_HaveRTT ? m_SRTT : RTO());
+    }
+
+    void
+    CongestionControl::OnTimeout(llarp_time_t now)
+    {
+      m_Timeouts++;
+      if (now >= m_RecoveryUntil)
+        m_SSThresh = std::max(m_Window / 2, MinWindow);
+      m_Window = MinWindow;
+      m_AckedSinceGrow = 0;
+      m_RecoveryUntil = now + RTO();
+    }
+
+    void
+    CongestionControl::OnRetransmit(size_t fragments)
+    {
+      m_Retransmits += fragments;
+    }
+
+    void
+    CongestionControl::OnRTOExpired(llarp_time_t now)
+    {
+      if (now < m_BackoffUntil)
+        return;
+      m_Backoff = std::min(m_Backoff + 1, MaxBackoff);
+      m_BackoffUntil = now + RTO();
+    }
+
+    llarp_time_t
+    CongestionControl::BaseRTO() const
+    {
+      if (not m_HaveRTT)
+        return InitialRTO;
+      return std::clamp(m_SRTT + std::max(m_RTTVar * 4, llarp_time_t{1ms}), MinRTO, MaxRTO);
+    }
+
+    llarp_time_t
+    CongestionControl::RTO() const
+    {
+      return std::min(BaseRTO() * (1 << m_Backoff), MaxRTO);
+    }
+
+    double
+    CongestionControl::PacingRate() const
+    {
+      // go faster than the window while probing in slow start so the window can actually grow
+      const double gain = m_Window < m_SSThresh ? 2.0 : 1.25;
+      const auto srtt = std::max(m_SRTT, llarp_time_t{1ms});
+      return gain * m_Window * m_PacketSize / srtt.count();
+    }
+
+    void
+    CongestionControl::SetPacketSize(size_t bytes)
+    {
+      m_PacketSize = std::max<size_t>(bytes, 1);
+    }
+
+    void
+    CongestionControl::Refill(llarp_time_t now)
+    {
+      const double maxBudget = PacingBurst * m_PacketSize;
+      if (m_LastRefill == 0s or now < m_LastRefill)
+      {
+        m_PacingBudget = maxBudget;
+        m_LastRefill = now;
+        return;
+      }
+      m_PacingBudget =
+          std::min(m_PacingBudget + PacingRate() * (now - m_LastRefill).count(), maxBudget);
+      m_LastRefill = now;
+    }
+
+    bool
+    CongestionControl::TakePacingBudget(size_t bytes)
+    {
+      // nothing to pace against until we have seen a round trip
+      if (not m_HaveRTT)
+        return true;
+      // let the budget go negative so a packet bigger than what is left is not stuck forever
+      if (m_PacingBudget <= 0)
+        return false;
+      m_PacingBudget -= bytes;
+      return true;
+    }
+
+    util::StatusObject
+    CongestionControl::ExtractStatus() const
+    {
+      return {
+          {"cwnd", m_Window},
+          {"ssthresh", m_SSThresh},
+          {"packetSize", m_PacketSize},
+          {"srtt", to_json(m_SRTT)},
+          {"rttvar", to_json(m_RTTVar)},
+          {"rto", to_json(RTO())},
+          {"backoff", m_Backoff},
+          {"retransmits", m_Retransmits},
+          {"lossEvents", m_LossEvents},
+          {"timeouts", m_Timeouts}};
+    }
+  }  // namespace iwp
+}  // namespace llarp
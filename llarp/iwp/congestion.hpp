@@ -0,0 +1,140 @@
+#ifndef LLARP_IWP_CONGESTION_HPP
+#define LLARP_IWP_CONGESTION_HPP
+
+#include <util/status.hpp>
+#include <util/time.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// per session rtt estimate, congestion window and pacing for outbound fragments.
+    /// the window is counted in fragments, grows like reno (slow start then one fragment per
+    /// window acked) and halves at most once per round trip when we have to retransmit.
+    /// the retransmit timeout follows rfc 6298, backing off exponentially while retransmits go
+    /// unanswered until a fresh rtt sample comes in.
+    struct CongestionControl
+    {
+      /// fragments we may have in flight before we have any feedback
+      static constexpr size_t InitialWindow = 10;
+      static constexpr size_t MinWindow = 2;
+      static constexpr size_t MaxWindow = 1024;
+
+      /// retransmit timeout before we have any rtt sample, the old fixed flush interval
+      static constexpr llarp_time_t InitialRTO = 400ms;
+      /// retransmit timeout bounds, the rto is never below the smoothed rtt whatever MinRTO says
+      static constexpr llarp_time_t MinRTO = 100ms;
+      static constexpr llarp_time_t MaxRTO = 60s;
+      /// most times the rto is doubled for retransmits that went unanswered
+      static constexpr size_t MaxBackoff = 6;
+      /// packet size we pace by until the session tells us its own
+      static constexpr size_t InitialPacketSize = 1500;
+
+      /// can we start sending a message of this many fragments with this many in flight?
+      /// one message is always allowed when nothing is in flight so big messages still go out
+      bool
+      CanSend(size_t inFlight, size_t fragments) const;
+
+      /// feed a round trip time measured from an xmit that was never retransmitted, this also
+      /// undoes any backoff
+      void
+      OnRTTSample(llarp_time_t rtt);
+
+      /// this many fragments were acked for the first time
+      void
+      OnAcked(size_t fragments);
+
+      /// we had to retransmit, shrinks the window once per round trip
+      void
+      OnLoss(llarp_time_t now);
+
+      /// a message was dropped undelivered, falls back to the minimum window
+      void
+      OnTimeout(llarp_time_t now);
+
+      /// count fragments we sent again
+      void
+      OnRetransmit(size_t fragments);
+
+      /// the retransmit timer went off and we resent, doubles the rto at most once per rto so
+      /// many messages expiring together count once
+      void
+      OnRTOExpired(llarp_time_t now);
+
+      /// when to retransmit unacked fragments, with backoff
+      llarp_time_t
+      RTO() const;
+
+      /// the rto from the rtt estimate alone, without backoff
+      llarp_time_t
+      BaseRTO() const;
+
+      llarp_time_t
+      SRTT() const
+      {
+        return m_SRTT;
+      }
+
+      size_t
+      Window() const
+      {
+        return m_Window;
+      }
+
+      /// size of the full sized packets the session currently sends, the window is paced and the
+      /// burst sized in these
+      void
+      SetPacketSize(size_t bytes);
+
+      size_t
+      PacketSize() const
+      {
+        return m_PacketSize;
+      }
+
+      /// refill the pacing budget for the time elapsed since the last refill
+      void
+      Refill(llarp_time_t now);
+
+      /// take a packet of this size out of the pacing budget, returns false if it has to wait
+      bool
+      TakePacingBudget(size_t bytes);
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      /// bytes per millisecond we pace at, spreads one window over one smoothed rtt
+      double
+      PacingRate() const;
+
+      bool m_HaveRTT = false;
+      llarp_time_t m_SRTT = 0s;
+      llarp_time_t m_RTTVar = 0s;
+      /// how many times the rto was doubled since the last rtt sample
+      size_t m_Backoff = 0;
+      /// no further doubling until this time
+      llarp_time_t m_BackoffUntil = 0s;
+
+      size_t m_Window = InitialWindow;
+      size_t m_SSThresh = MaxWindow;
+      /// fragments acked towards the next window increase in congestion avoidance
+      size_t m_AckedSinceGrow = 0;
+      /// no further decrease until this time so one burst of losses counts once
+      llarp_time_t m_RecoveryUntil = 0s;
+
+      size_t m_PacketSize = InitialPacketSize;
+      double m_PacingBudget = 0;
+      llarp_time_t m_LastRefill = 0s;
+
+      uint64_t m_Retransmits = 0;
+      uint64_t m_LossEvents = 0;
+      uint64_t m_Timeouts = 0;
+    };
+  }  // namespace iwp
+}  // namespace llarp
+
+#endif
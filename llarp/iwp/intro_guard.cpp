@@ -0,0 +1,103 @@
+#include <iwp/intro_guard.hpp>
+
+#include <crypto/crypto.hpp>
+#include <net/net_bits.hpp>
+#include <util/mem.h>
+
+#include <cstring>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    IntroGuard::IntroGuard()
+    {
+      m_Secret.Randomize();
+      CryptoManager::instance()->randbytes(
+          reinterpret_cast<byte_t*>(&m_RateSeed), sizeof(m_RateSeed));
+    }
+
+    size_t
+    IntroGuard::RateSlot(const SockAddr& from) const
+    {
+      static constexpr auto v4Map = huint128_t{0x0000'ffff'0000'0000UL};
+      static constexpr auto v4Mask = netmask_ipv6_bits(96);
+      const auto ip = from.asIPv6();
+      // ipv4 is mapped into the last 32 bits, keep the /24 of it, otherwise keep the /48
+      const bool mapped = (ip & v4Mask) == v4Map;
+      const auto prefix = ip & netmask_ipv6_bits(mapped ? 120 : 48);
+      // seeded so nobody can pick prefixes that share a slot with someone else
+      uint64_t h = (prefix.h.upper ^ m_RateSeed) * 0x9E3779B97F4A7C15ULL;
+      h = (h ^ prefix.h.lower ^ (h >> 29)) * 0xBF58476D1CE4E5B9ULL;
+      return (h ^ (h >> 32)) % RateTableSize;
+    }
+
+    bool
+    IntroGuard::AllowIntro(const SockAddr& from, llarp_time_t now)
+    {
+      if (now >= m_ResetCountsAt)
+      {
+        m_IntroCounts.fill(0);
+        m_ResetCountsAt = now + RateInterval;
+      }
+      auto& count = m_IntroCounts[RateSlot(from)];
+      if (count >= MaxIntrosPerPrefix)
+      {
+        rateLimited++;
+        return false;
+      }
+      count++;
+      return true;
+    }
+
+    IntroGuard::Cookie_t
+    IntroGuard::MakeCookie(const SockAddr& from, uint64_t epoch) const
+    {
+      const auto ip = from.asIPv6();
+      const uint16_t port = from.getPort();
+      // [u64 epoch][u64 upper address][u64 lower address][u16 port], all in host order
+      std::array<byte_t, sizeof(epoch) + 2 * sizeof(uint64_t) + sizeof(port)> data;
+      byte_t* ptr = data.data();
+      std::memcpy(ptr, &epoch, sizeof(epoch));
+      ptr += sizeof(epoch);
+      std::memcpy(ptr, &ip.h.upper, sizeof(uint64_t));
+      ptr += sizeof(uint64_t);
+      std::memcpy(ptr, &ip.h.lower, sizeof(uint64_t));
+      ptr += sizeof(uint64_t);
+      std::memcpy(ptr, &port, sizeof(port));
+      std::array<byte_t, HMACSIZE> digest;
+      CryptoManager::instance()->hmac(
+          digest.data(), llarp_buffer_t{data.data(), data.size()}, m_Secret);
+      return Cookie_t{digest.data()};
+    }
+
+    IntroGuard::Cookie_t
+    IntroGuard::MakeCookie(const SockAddr& from, llarp_time_t now) const
+    {
+      return MakeCookie(from, now / CookieInterval);
+    }
+
+    bool
+    IntroGuard::CheckCookie(const SockAddr& from, const Cookie_t& cookie, llarp_time_t now) const
+    {
+      const uint64_t epoch = now / CookieInterval;
+      for (const auto e : {epoch, epoch - 1})
+      {
+        const auto expected = MakeCookie(from, e);
+        if (llarp_eq(expected.data(), cookie.data(), cookie.size()))
+          return true;
+      }
+      return false;
+    }
+
+    util::StatusObject
+    IntroGuard::ExtractStatus() const
+    {
+      return util::StatusObject{{"rateLimited", rateLimited},
+                                {"retriesSent", retriesSent},
+                                {"cookiesAccepted", cookiesAccepted},
+                                {"cookiesRejected", cookiesRejected},
+                                {"badIntros", badIntros}};
+    }
+  }  // namespace iwp
+}  // namespace llarp
@@ -0,0 +1,81 @@
+#ifndef LLARP_IWP_INTRO_GUARD_HPP
+#define LLARP_IWP_INTRO_GUARD_HPP
+
+#include <crypto/types.hpp>
+#include <net/sock_addr.hpp>
+#include <util/aligned.hpp>
+#include <util/status.hpp>
+#include <util/time.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// keeps floods of inbound intros from costing us a session each
+    ///
+    /// intros are rate limited per source prefix. once enough sessions are pending we answer
+    /// intros without a valid cookie with a retry that carries one instead of a session. a cookie
+    /// is a keyed hash of the source address and the time, so checking one needs no state and a
+    /// spoofed source never gets to see it.
+    ///
+    /// the link layer owning it only touches it from the logic thread, so neither the rate table
+    /// nor the counters are synchronized.
+    class IntroGuard
+    {
+     public:
+      using Cookie_t = AlignedBuffer<24>;
+
+      /// a cookie is good for the interval it was made in and the one after
+      static constexpr auto CookieInterval = 10s;
+      /// how often the per prefix intro counts start over
+      static constexpr auto RateInterval = 1s;
+      /// slots in the per prefix intro count table, prefixes that hash to the same slot share it
+      static constexpr size_t RateTableSize = 4096;
+      /// intros a /24 (ipv4) or /48 (ipv6) may send per RateInterval
+      static constexpr uint16_t MaxIntrosPerPrefix = 64;
+      /// pending sessions before we make intros prove their source address with a cookie
+      static constexpr size_t PendingBeforeCookies = 16;
+      /// pending sessions we never go past, even with cookies
+      static constexpr size_t MaxPendingSessions = 1024;
+
+      IntroGuard();
+
+      /// count an intro from this source, false if its prefix sent too many already
+      bool
+      AllowIntro(const SockAddr& from, llarp_time_t now);
+
+      Cookie_t
+      MakeCookie(const SockAddr& from, llarp_time_t now) const;
+
+      /// is this a cookie we made for this source address recently enough
+      bool
+      CheckCookie(const SockAddr& from, const Cookie_t& cookie, llarp_time_t now) const;
+
+      util::StatusObject
+      ExtractStatus() const;
+
+      uint64_t rateLimited = 0;
+      uint64_t retriesSent = 0;
+      uint64_t cookiesAccepted = 0;
+      uint64_t cookiesRejected = 0;
+      uint64_t badIntros = 0;
+
+     private:
+      Cookie_t
+      MakeCookie(const SockAddr& from, uint64_t epoch) const;
+
+      size_t
+      RateSlot(const SockAddr& from) const;
+
+      SharedSecret m_Secret;
+      uint64_t m_RateSeed;
+      std::array<uint16_t, RateTableSize> m_IntroCounts{};
+      llarp_time_t m_ResetCountsAt = 0s;
+    };
+  }  // namespace iwp
+}  // namespace llarp
+
+#endif
@@ -1,6 +1,7 @@
 #include <iwp/linklayer.hpp>
 #include <iwp/session.hpp>
 #include <config/key_manager.hpp>
+#include <array>
 #include <memory>
 #include <unordered_set>
 
@@ -50,18 +51,20 @@ namespace llarp::iwp
   {
     std::shared_ptr<ILinkSession> session;
     auto itr = m_AuthedAddrs.find(from);
-    bool isNewSession = false;
     if (itr == m_AuthedAddrs.end())
     {
-      Lock_t lock(m_PendingMutex);
-      if (m_Pending.count(from) == 0)
       {
-        if (not permitInbound)
-          return;
-        isNewSession = true;
-        m_Pending.insert({from, std::make_shared<Session>(this, from)});
+        Lock_t lock(m_PendingMutex);
+        auto pending = m_Pending.find(from);
+        if (pending != m_Pending.end())
+          session = pending->second;
+      }
+      if (not session)
+      {
+        if (permitInbound)
+          HandleNewIntro(from, std::move(pkt));
+        return;
       }
-      session = m_Pending.find(from)->second;
     }
     else
     {
@@ -70,14 +73,80 @@ namespace llarp::iwp
       session = range.first->second;
     }
     if (session)
+      session->Recv_LL(std::move(pkt));
+  }
+
+  void
+  LinkLayer::HandleNewIntro(const SockAddr& from, ILinkSession::Packet_t pkt)
+  {
+    const auto now = Now();
+    if (not m_IntroGuard.AllowIntro(from, now))
+      return;
+    // intros are keyed with a hash of our identity key, anyone with our rc can make one
+    SharedSecret introKey;
+    CryptoManager::instance()->shorthash(introKey, llarp_buffer_t(GetOurRC().pubkey));
+    ManagedBuffer buf{llarp_buffer_t{pkt}};
+    bool valid = false;
+    if (pkt.size() >= PacketOverhead + Introduction::SIZE)
+      CryptoManager::instance()->verify_decrypt_batch(&buf, 1, introKey, &valid);
+    if (not valid)
+    {
+      m_IntroGuard.badIntros++;
+      LogDebug("bad intro from ", from);
+      return;
+    }
+    std::optional<IntroGuard::Cookie_t> cookie;
+    if (pkt.size() >= PacketOverhead + Introduction::SIZE + IntroGuard::Cookie_t::SIZE)
     {
-      bool success = session->Recv_LL(std::move(pkt));
-      if (!success and isNewSession)
+      cookie.emplace(pkt.data() + PacketOverhead + Introduction::SIZE);
+      if (m_IntroGuard.CheckCookie(from, *cookie, now))
+        m_IntroGuard.cookiesAccepted++;
+      else
       {
-        LogWarn("Brand new session failed; removing from pending sessions list");
-        m_Pending.erase(m_Pending.find(from));
+        m_IntroGuard.cookiesRejected++;
+        cookie.reset();
       }
     }
+    const auto numPending = NumberOfPendingSessions();
+    if (numPending >= IntroGuard::MaxPendingSessions)
+    {
+      LogWarn("dropping intro from ", from, ", ", numPending, " sessions pending already");
+      return;
+    }
+    if (not cookie and numPending >= IntroGuard::PendingBeforeCookies)
+    {
+      SendRetry(from, introKey, now);
+      return;
+    }
+    auto session = std::make_shared<Session>(this, from);
+    if (not session->AcceptIntro(std::move(pkt), std::move(cookie)))
+      return;
+    Lock_t lock(m_PendingMutex);
+    m_Pending.emplace(from, std::move(session));
+  }
+
+  void
+  LinkLayer::SendRetry(const SockAddr& to, const SharedSecret& introKey, llarp_time_t now)
+  {
+    std::array<byte_t, PacketOverhead + RetrySize> retry;
+    CryptoManager::instance()->randbytes(retry.data() + HMACSIZE, TUNNONCESIZE);
+    byte_t* ptr = retry.data() + PacketOverhead;
+    htobe32buf(ptr, RetryMagic);
+    const auto cookie = m_IntroGuard.MakeCookie(to, now);
+    std::copy_n(cookie.data(), cookie.size(), ptr + sizeof(RetryMagic));
+    ManagedBuffer buf{llarp_buffer_t{retry.data(), retry.size()}};
+    CryptoManager::instance()->encrypt_hmac_batch(&buf, 1, introKey);
+    SendTo_LL(to, llarp_buffer_t{retry.data(), retry.size()});
+    m_IntroGuard.retriesSent++;
+    LogDebug("sent retry to ", to);
+  }
+
+  util::StatusObject
+  LinkLayer::ExtractStatus() const
+  {
+    auto obj = ILinkLayer::ExtractStatus();
+    obj["intros"] = m_IntroGuard.ExtractStatus();
+    return obj;
   }
 
   bool
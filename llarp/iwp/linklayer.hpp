@@ -5,6 +5,7 @@
 #include <crypto/crypto.hpp>
 #include <crypto/encrypted.hpp>
 #include <crypto/types.hpp>
+#include <iwp/intro_guard.hpp>
 #include <link/server.hpp>
 #include <config/key_manager.hpp>
 
@@ -47,6 +48,9 @@ namespace llarp::iwp
     void
     RecvFrom(const SockAddr& from, ILinkSession::Packet_t pkt) override;
 
+    util::StatusObject
+    ExtractStatus() const override;
+
     bool
     MapAddr(const RouterID& pk, ILinkSession* s) override;
 
@@ -63,10 +67,20 @@ namespace llarp::iwp
     void
     HandleWakeupPlaintext();
 
+    /// an intro from an address we have no session with, only makes a session once the intro
+    /// checks out and, under load, carries a cookie
+    void
+    HandleNewIntro(const SockAddr& from, ILinkSession::Packet_t pkt);
+
+    /// answer an intro with a cookie to send it again with
+    void
+    SendRetry(const SockAddr& to, const SharedSecret& introKey, llarp_time_t now);
+
     EventLoopWakeup* const m_Wakeup;
     std::unordered_map<SockAddr, std::weak_ptr<Session>, SockAddr::Hash> m_PlaintextRecv;
     std::unordered_map<SockAddr, RouterID, SockAddr::Hash> m_AuthedAddrs;
     const bool permitInbound;
+    IntroGuard m_IntroGuard;
   };
 
   using LinkLayer_ptr = std::shared_ptr<LinkLayer>;
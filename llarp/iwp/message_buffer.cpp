@@ -2,6 +2,8 @@
 #include <iwp/session.hpp>
 #include <crypto/crypto.hpp>
 
+#include <algorithm>
+
 namespace llarp
 {
   namespace iwp
@@ -10,9 +12,11 @@ namespace llarp
         uint64_t msgid,
         ILinkSession::Message_t msg,
         llarp_time_t now,
-        ILinkSession::CompletionHandler handler)
+        ILinkSession::CompletionHandler handler,
+        size_t fragmentSize)
         : m_Data{std::move(msg)}
         , m_MsgID{msgid}
+        , m_FragmentSize{fragmentSize}
         , m_Completed{handler}
         , m_LastFlush{now}
         , m_StartedAt{now}
@@ -25,7 +29,7 @@ namespace llarp
     ILinkSession::Packet_t
     OutboundMessage::XMIT() const
     {
-      size_t extra = std::min(m_Data.size(), FragmentSize);
+      size_t extra = std::min(m_Data.size(), m_FragmentSize);
       auto xmit = CreatePacket(Command::eXMIT, 10 + 32 + extra, 0, 0);
       htobe16buf(xmit.data() + CommandOverhead + PacketOverhead, m_Data.size());
       htobe64buf(xmit.data() + 2 + CommandOverhead + PacketOverhead, m_MsgID);
@@ -46,30 +50,54 @@ namespace llarp
     }
 
     bool
-    OutboundMessage::ShouldFlush(llarp_time_t now) const
+    OutboundMessage::ShouldFlush(llarp_time_t now, llarp_time_t interval) const
     {
-      return now - m_LastFlush >= TXFlushInterval;
+      return now - m_LastFlush >= interval;
     }
 
-    void
-    OutboundMessage::Ack(byte_t bitmask)
+    size_t
+    OutboundMessage::NumFragments() const
     {
-      m_Acks = std::bitset<8>(bitmask);
+      return std::max<size_t>(1, (m_Data.size() + m_FragmentSize - 1) / m_FragmentSize);
+    }
+
+    size_t
+    OutboundMessage::NumUnAcked() const
+    {
+      // the bit for the xmit fragment is set up front so FlushUnAcked skips it, it only counts
+      // as acked once the remote has told us what it has
+      if (not m_GotAck)
+        return NumFragments();
+      size_t unacked = 0;
+      for (size_t idx = 0; idx < NumFragments(); ++idx)
+      {
+        if (not m_Acks.test(idx))
+          unacked++;
+      }
+      return unacked;
     }
 
     void
+    OutboundMessage::Ack(uint16_t bitmask)
+    {
+      m_Acks = std::bitset<MaxFragments>(bitmask);
+      m_GotAck = true;
+    }
+
+    size_t
     OutboundMessage::FlushUnAcked(
         std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now)
     {
       /// overhead for a data packet in plaintext
       static constexpr size_t Overhead = 10;
+      size_t sent = 0;
       uint16_t idx = 0;
       const auto datasz = m_Data.size();
       while (idx < datasz)
       {
-        if (not m_Acks[idx / FragmentSize])
+        if (not m_Acks[idx / m_FragmentSize])
         {
-          const size_t fragsz = idx + FragmentSize < datasz ? FragmentSize : datasz - idx;
+          const size_t fragsz = idx + m_FragmentSize < datasz ? m_FragmentSize : datasz - idx;
           auto frag = CreatePacket(Command::eDATA, fragsz + Overhead, 0, 0);
           htobe16buf(frag.data() + 2 + PacketOverhead, idx);
           htobe64buf(frag.data() + 4 + PacketOverhead, m_MsgID);
@@ -78,29 +106,29 @@ namespace llarp
               m_Data.begin() + idx + fragsz,
               frag.data() + PacketOverhead + Overhead + 2);
           sendpkt(std::move(frag));
+          sent++;
         }
-        idx += FragmentSize;
+        idx += m_FragmentSize;
       }
       m_LastFlush = now;
+      return sent;
     }
 
     bool
     OutboundMessage::IsTransmitted() const
     {
-      const auto sz = m_Data.size();
-      for (uint16_t idx = 0; idx < sz; idx += FragmentSize)
+      for (size_t idx = 0; idx < NumFragments(); ++idx)
       {
-        if (not m_Acks.test(idx / FragmentSize))
+        if (not m_Acks.test(idx))
           return false;
       }
       return true;
     }
 
     bool
-    OutboundMessage::IsTimedOut(const llarp_time_t now) const
+    OutboundMessage::IsTimedOut(const llarp_time_t now, const llarp_time_t timeout) const
     {
-      // TODO: make configurable by outbound message deliverer
-      return now > m_StartedAt && now - m_StartedAt > DeliveryTimeout;
+      return now > m_StartedAt && now - m_StartedAt > timeout;
     }
 
     void
@@ -113,47 +141,63 @@ namespace llarp
       m_Completed = nullptr;
     }
 
-    InboundMessage::InboundMessage(uint64_t msgid, uint16_t sz, ShortHash h, llarp_time_t now)
-        : m_Data(size_t{sz}), m_Digset{std::move(h)}, m_MsgID(msgid), m_LastActiveAt{now}
+    InboundMessage::InboundMessage(
+        uint64_t msgid, uint16_t sz, ShortHash h, llarp_time_t now, size_t fragmentSize)
+        : m_Data(size_t{sz})
+        , m_Digset{std::move(h)}
+        , m_MsgID(msgid)
+        , m_LastActiveAt{now}
+        , m_FragmentSize{fragmentSize}
     {}
 
     void
     InboundMessage::HandleData(uint16_t idx, const llarp_buffer_t& buf, llarp_time_t now)
     {
-      if (idx + buf.sz > m_Data.size())
+      if (idx + buf.sz > m_Data.size() or idx % m_FragmentSize or buf.sz > m_FragmentSize)
       {
         LogWarn("invalid fragment offset ", idx);
         return;
       }
       byte_t* dst = m_Data.data() + idx;
       std::copy_n(buf.base, buf.sz, dst);
-      m_Acks.set(idx / FragmentSize);
-      LogDebug("got fragment ", idx / FragmentSize);
+      m_Acks.set(idx / m_FragmentSize);
+      LogDebug("got fragment ", idx / m_FragmentSize);
       m_LastActiveAt = now;
     }
 
     ILinkSession::Packet_t
     InboundMessage::ACKS() const
     {
-      auto acks = CreatePacket(Command::eACKS, 9);
+      // the second mask byte only goes out for messages that need it, which a peer can only
+      // send us after it has seen our probe acks, so old peers always get the one byte form
+      const bool wide = NumFragments() > 8;
+      auto acks = CreatePacket(Command::eACKS, wide ? 10 : 9);
       htobe64buf(acks.data() + CommandOverhead + PacketOverhead, m_MsgID);
-      acks[PacketOverhead + 10] = AcksBitmask();
+      const auto mask = AcksBitmask();
+      acks[PacketOverhead + 10] = mask & 0xff;
+      if (wide)
+        acks[PacketOverhead + 11] = mask >> 8;
       return acks;
     }
 
-    byte_t
+    uint16_t
     InboundMessage::AcksBitmask() const
     {
-      return byte_t{(byte_t)m_Acks.to_ulong()};
+      return static_cast<uint16_t>(m_Acks.to_ulong());
+    }
+
+    size_t
+    InboundMessage::NumFragments() const
+    {
+      return std::max<size_t>(1, (m_Data.size() + m_FragmentSize - 1) / m_FragmentSize);
     }
 
     bool
     InboundMessage::IsCompleted() const
     {
-      const auto sz = m_Data.size();
-      for (size_t idx = 0; idx < sz; idx += FragmentSize)
+      for (size_t idx = 0; idx < NumFragments(); ++idx)
       {
-        if (not m_Acks.test(idx / FragmentSize))
+        if (not m_Acks.test(idx))
           return false;
       }
       return true;
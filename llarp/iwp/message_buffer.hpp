@@ -29,8 +29,14 @@ namespace llarp
       eCLOS = 0xff,
     };
 
-    /// max size of data fragments
-    static constexpr size_t FragmentSize = 1024;
+    /// size of data fragments until path mtu discovery found something better,
+    /// the only size peers without path mtu discovery understand
+    static constexpr size_t DefaultFragmentSize = 1024;
+    /// bounds for the fragment size a sender may pick
+    static constexpr size_t MinFragmentSize = 512;
+    static constexpr size_t MaxFragmentSize = 4096;
+    /// most fragments a message can have
+    static constexpr size_t MaxFragments = MAX_LINK_MSG_SIZE / MinFragmentSize;
     /// plaintext header overhead size
     static constexpr size_t CommandOverhead = 2;
 
@@ -41,27 +47,47 @@ namespace llarp
           uint64_t msgid,
           ILinkSession::Message_t data,
           llarp_time_t now,
-          ILinkSession::CompletionHandler handler);
+          ILinkSession::CompletionHandler handler,
+          size_t fragmentSize = DefaultFragmentSize);
 
       ILinkSession::Message_t m_Data;
       uint64_t m_MsgID = 0;
-      std::bitset<MAX_LINK_MSG_SIZE / FragmentSize> m_Acks;
+      /// fragment size this message is sent with, fixed for its lifetime
+      size_t m_FragmentSize = DefaultFragmentSize;
+      std::bitset<MaxFragments> m_Acks;
       ILinkSession::CompletionHandler m_Completed;
       llarp_time_t m_LastFlush = 0s;
       ShortHash m_Digest;
       llarp_time_t m_StartedAt = 0s;
+      /// when the xmit first went out, zero while the message waits for the congestion window
+      llarp_time_t m_SentAt = 0s;
+      /// did we ever send any of it twice, such messages give no rtt sample
+      bool m_Retransmitted = false;
+      /// have we had an ACKS for it yet
+      bool m_GotAck = false;
+      /// when the earliest timer we armed for it fires, zero if none is armed
+      llarp_time_t m_TimerAt = 0s;
 
       ILinkSession::Packet_t
       XMIT() const;
 
-      void
-      Ack(byte_t bitmask);
+      /// number of fragments including the one carried in the xmit
+      size_t
+      NumFragments() const;
+
+      /// number of fragments the remote has not acked yet
+      size_t
+      NumUnAcked() const;
 
       void
+      Ack(uint16_t bitmask);
+
+      /// returns how many fragments were sent
+      size_t
       FlushUnAcked(std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now);
 
       bool
-      ShouldFlush(llarp_time_t now) const;
+      ShouldFlush(llarp_time_t now, llarp_time_t interval) const;
 
       void
       Completed();
@@ -70,7 +96,7 @@ namespace llarp
       IsTransmitted() const;
 
       bool
-      IsTimedOut(llarp_time_t now) const;
+      IsTimedOut(llarp_time_t now, llarp_time_t timeout) const;
 
       void
       InformTimeout();
@@ -79,14 +105,23 @@ namespace llarp
     struct InboundMessage
     {
       InboundMessage() = default;
-      InboundMessage(uint64_t msgid, uint16_t sz, ShortHash h, llarp_time_t now);
+      InboundMessage(
+          uint64_t msgid,
+          uint16_t sz,
+          ShortHash h,
+          llarp_time_t now,
+          size_t fragmentSize = DefaultFragmentSize);
 
       ILinkSession::Message_t m_Data;
       ShortHash m_Digset;
       uint64_t m_MsgID = 0;
       llarp_time_t m_LastACKSent = 0s;
       llarp_time_t m_LastActiveAt = 0s;
-      std::bitset<MAX_LINK_MSG_SIZE / FragmentSize> m_Acks;
+      /// fragment size the sender uses, learned from the xmit
+      size_t m_FragmentSize = DefaultFragmentSize;
+      std::bitset<MaxFragments> m_Acks;
+      /// when the earliest timer we armed for it fires, zero if none is armed
+      llarp_time_t m_TimerAt = 0s;
 
       void
       HandleData(uint16_t idx, const llarp_buffer_t& buf, llarp_time_t now);
@@ -94,13 +129,16 @@ namespace llarp
       bool
       IsCompleted() const;
 
+      size_t
+      NumFragments() const;
+
       bool
       IsTimedOut(llarp_time_t now) const;
 
       bool
       Verify() const;
 
-      byte_t
+      uint16_t
       AcksBitmask() const;
 
       bool
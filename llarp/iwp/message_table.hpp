@@ -0,0 +1,131 @@
+#ifndef LLARP_IWP_MESSAGE_TABLE_HPP
+#define LLARP_IWP_MESSAGE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// flat ring of in flight messages keyed by msgid
+    ///
+    /// msgids are handed out in sequence so the live ones sit in a small window and land in
+    /// distinct slots of a power of two ring. when two of them do collide the ring doubles,
+    /// once it would grow past the max size the new message is refused.
+    template <typename Msg_t>
+    class MessageTable
+    {
+     public:
+      explicit MessageTable(size_t maxSize) : m_MaxSize{maxSize}, m_Slots(InitialSize)
+      {}
+
+      Msg_t*
+      Find(uint64_t id)
+      {
+        auto& slot = Slot(id);
+        return slot.msg and slot.id == id ? &*slot.msg : nullptr;
+      }
+
+      const Msg_t*
+      Find(uint64_t id) const
+      {
+        const auto& slot = m_Slots[id & (m_Slots.size() - 1)];
+        return slot.msg and slot.id == id ? &*slot.msg : nullptr;
+      }
+
+      /// returns the stored message, nullptr if id is already in the table or it is full
+      Msg_t*
+      Emplace(uint64_t id, Msg_t msg)
+      {
+        while (Slot(id).msg)
+        {
+          if (Slot(id).id == id or not Grow())
+            return nullptr;
+        }
+        auto& slot = Slot(id);
+        slot.id = id;
+        slot.msg.emplace(std::move(msg));
+        m_Size++;
+        return &*slot.msg;
+      }
+
+      void
+      Erase(uint64_t id)
+      {
+        auto& slot = Slot(id);
+        if (not slot.msg or slot.id != id)
+          return;
+        slot.msg.reset();
+        m_Size--;
+      }
+
+      size_t
+      size() const
+      {
+        return m_Size;
+      }
+
+      bool
+      empty() const
+      {
+        return m_Size == 0;
+      }
+
+     private:
+      static constexpr size_t InitialSize = 8;
+
+      struct Slot_t
+      {
+        uint64_t id = 0;
+        std::optional<Msg_t> msg;
+      };
+
+      Slot_t&
+      Slot(uint64_t id)
+      {
+        return m_Slots[id & (m_Slots.size() - 1)];
+      }
+
+      /// double the ring until every message has a slot of its own, false if that is too big
+      bool
+      Grow()
+      {
+        for (size_t sz = m_Slots.size() * 2; sz <= m_MaxSize; sz *= 2)
+        {
+          std::vector<bool> used(sz);
+          bool collided = false;
+          for (const auto& slot : m_Slots)
+          {
+            if (not slot.msg)
+              continue;
+            const auto idx = slot.id & (sz - 1);
+            collided = used[idx];
+            if (collided)
+              break;
+            used[idx] = true;
+          }
+          if (collided)
+            continue;
+          std::vector<Slot_t> slots(sz);
+          for (auto& slot : m_Slots)
+          {
+            if (slot.msg)
+              slots[slot.id & (sz - 1)] = std::move(slot);
+          }
+          m_Slots = std::move(slots);
+          return true;
+        }
+        return false;
+      }
+
+      const size_t m_MaxSize;
+      std::vector<Slot_t> m_Slots;
+      size_t m_Size = 0;
+    };
+  }  // namespace iwp
+}  // namespace llarp
+
+#endif
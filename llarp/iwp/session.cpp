@@ -4,6 +4,8 @@
 #include <messages/discard.hpp>
 #include <util/meta/memfn.hpp>
 
+#include <algorithm>
+
 namespace llarp
 {
   namespace iwp
@@ -28,6 +30,15 @@ namespace llarp
 
     constexpr size_t PlaintextQueueSize = 32;
 
+    /// a ping body starting with this is a path mtu probe or probe ack, otherwise it is padding
+    static constexpr uint32_t PMTUProbeMagic = 0x706d7475;
+    /// [u32 magic][u8 kind][u16 fragment size]
+    static constexpr size_t PMTUProbeHeaderSize = 7;
+    static constexpr byte_t PMTUProbe = 1;
+    static constexpr byte_t PMTUProbeAck = 2;
+    /// plaintext overhead of an xmit, a probe is as big as an xmit carrying one whole fragment
+    static constexpr size_t XMITHeaderSize = sizeof(uint16_t) + sizeof(uint64_t) + ShortHash::SIZE;
+
     Session::Session(LinkLayer* p, const RouterContact& rc, const AddressInfo& ai)
         : m_State{State::Initial}
         , m_Inbound{false}
@@ -41,6 +52,7 @@ namespace llarp
       token.Zero();
       GotLIM = util::memFn(&Session::GotOutboundLIM, this);
       CryptoManager::instance()->shorthash(m_SessionKey, llarp_buffer_t(rc.pubkey));
+      SetTXFragmentSize(DefaultFragmentSize);
     }
 
     Session::Session(LinkLayer* p, const SockAddr& from)
@@ -55,6 +67,7 @@ namespace llarp
       GotLIM = util::memFn(&Session::GotInboundLIM, this);
       const PubKey pk = m_Parent->GetOurRC().pubkey;
       CryptoManager::instance()->shorthash(m_SessionKey, llarp_buffer_t(pk));
+      SetTXFragmentSize(DefaultFragmentSize);
     }
 
     void
@@ -142,23 +155,53 @@ namespace llarp
       }
     }
 
+    void
+    Session::PacedSend(ILinkSession::Packet_t data)
+    {
+      m_PacedNext.emplace_back(std::move(data));
+      DrainPaced(m_Parent->Now());
+    }
+
+    void
+    Session::DrainPaced(llarp_time_t now)
+    {
+      if (m_PacedNext.empty())
+        return;
+      m_CC.Refill(now);
+      while (not m_PacedNext.empty() and m_CC.TakePacingBudget(m_PacedNext.front().size()))
+      {
+        EncryptAndSend(std::move(m_PacedNext.front()));
+        m_PacedNext.pop_front();
+      }
+    }
+
+    void
+    Session::SendMany_LL(const CryptoQueue_t& pkts)
+    {
+      std::vector<ManagedBuffer> bufs;
+      bufs.reserve(pkts.size());
+      size_t sz = 0;
+      for (const auto& pkt : pkts)
+      {
+        bufs.emplace_back(llarp_buffer_t{pkt});
+        sz += pkt.size();
+      }
+      LogDebug("send ", pkts.size(), " packets with ", sz, " bytes to ", m_RemoteAddr);
+      m_Parent->SendManyTo_LL(m_RemoteAddr, bufs);
+      m_LastTX = time_now_ms();
+      m_TXRate += sz;
+    }
+
     void
     Session::EncryptWorker(CryptoQueue_t msgs)
     {
       LogDebug("encrypt worker ", msgs.size(), " messages");
+      std::vector<ManagedBuffer> bufs;
+      bufs.reserve(msgs.size());
       for (auto& pkt : msgs)
-      {
-        llarp_buffer_t pktbuf{pkt};
-        const TunnelNonce nonce_ptr{pkt.data() + HMACSIZE};
-        pktbuf.base += PacketOverhead;
-        pktbuf.cur = pktbuf.base;
-        pktbuf.sz -= PacketOverhead;
-        CryptoManager::instance()->xchacha20(pktbuf, m_SessionKey, nonce_ptr);
-        pktbuf.base = pkt.data() + HMACSIZE;
-        pktbuf.sz = pkt.size() - HMACSIZE;
-        CryptoManager::instance()->hmac(pkt.data(), pktbuf, m_SessionKey);
-        Send_LL(pkt.data(), pkt.size());
-      }
+        bufs.emplace_back(llarp_buffer_t{pkt});
+      CryptoManager::instance()->encrypt_hmac_batch(bufs.data(), bufs.size(), m_SessionKey);
+      SendMany_LL(msgs);
     }
 
     void
@@ -181,20 +224,250 @@ namespace llarp
       if (m_TXMsgs.size() >= MaxSendQueueSize)
         return false;
       const auto now = m_Parent->Now();
-      const auto msgid = m_TXID++;
-      const auto bufsz = buf.size();
-      auto& msg = m_TXMsgs.emplace(msgid, OutboundMessage{msgid, std::move(buf), now, completed})
-                      .first->second;
-      EncryptAndSend(msg.XMIT());
-      if (bufsz > FragmentSize)
-      {
-        msg.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
-      }
+      const auto msgid = m_TXID;
+      auto* msg = m_TXMsgs.Emplace(
+          msgid, OutboundMessage{msgid, std::move(buf), now, completed, m_TXFragmentSize});
+      if (msg == nullptr)
+        return false;
+      m_TXID++;
+      ArmTimer(msg->m_TimerAt, now + TXTimeout(), eTXTimer, msgid);
+      m_TXWaiting.emplace_back(msgid);
       m_Stats.totalInFlightTX++;
       LogDebug("send message ", msgid);
+      StartWaitingMessages(now);
       return true;
     }
 
+    void
+    Session::StartWaitingMessages(llarp_time_t now)
+    {
+      while (not m_TXWaiting.empty())
+      {
+        auto* msg = m_TXMsgs.Find(m_TXWaiting.front());
+        if (msg == nullptr)
+        {
+          // timed out before it got a turn
+          m_TXWaiting.pop_front();
+          continue;
+        }
+        if (not m_CC.CanSend(m_TXFragsInFlight, msg->NumFragments()))
+          return;
+        m_TXWaiting.pop_front();
+        m_TXFragsInFlight += msg->NumFragments();
+        msg->m_SentAt = now;
+        PacedSend(msg->XMIT());
+        msg->FlushUnAcked(util::memFn(&Session::PacedSend, this), now);
+        ArmTimer(msg->m_TimerAt, now + RetransmitTimeout(), eTXTimer, msg->m_MsgID);
+      }
+    }
+
+    void
+    Session::ArmTimer(llarp_time_t& armedAt, llarp_time_t when, TimerKind kind, uint64_t id)
+    {
+      if (armedAt != 0s and armedAt <= when)
+        return;
+      armedAt = when;
+      m_Parent->ScheduleTimer(weak_from_this(), when, kind, id);
+    }
+
+    llarp_time_t
+    Session::TXTimeout() const
+    {
+      return std::max<llarp_time_t>(DeliveryTimeout, m_CC.BaseRTO() * 2);
+    }
+
+    llarp_time_t
+    Session::RetransmitTimeout() const
+    {
+      // the base rto is at least the srtt so this never fires before an ack could be back
+      return std::min(m_CC.RTO(), TXTimeout() / 2);
+    }
+
+    void
+    Session::HandleTimer(llarp_time_t now, uint8_t kind, uint64_t id)
+    {
+      if (m_State == State::Closed)
+        return;
+      switch (kind)
+      {
+        case eTXTimer:
+          if (auto* msg = m_TXMsgs.Find(id))
+            TXTimer(now, *msg);
+          break;
+        case eRXTimer:
+          if (auto* msg = m_RXMsgs.Find(id))
+            RXTimer(now, *msg);
+          break;
+        default:
+          break;
+      }
+    }
+
+    void
+    Session::TXTimer(llarp_time_t now, OutboundMessage& msg)
+    {
+      // an earlier timer was armed after this one, it has dealt with the message
+      if (now < msg.m_TimerAt)
+        return;
+      msg.m_TimerAt = 0s;
+      const auto timeout = TXTimeout();
+      if (msg.IsTimedOut(now, timeout))
+      {
+        m_Stats.totalDroppedTX++;
+        m_Stats.totalInFlightTX--;
+        LogDebug("Dropped unacked packet to ", m_RemoteAddr);
+        if (msg.m_SentAt > 0s)
+        {
+          FinishOutbound(msg);
+          m_CC.OnTimeout(now);
+        }
+        // take it out first, the handler may queue more messages
+        auto dropped = std::move(msg);
+        m_TXMsgs.Erase(dropped.m_MsgID);
+        dropped.InformTimeout();
+        return;
+      }
+      const auto rto = RetransmitTimeout();
+      if (msg.m_SentAt > 0s and msg.ShouldFlush(now, rto)
+          and (m_State == State::Ready or m_State == State::LinkIntro))
+      {
+        size_t resent = msg.FlushUnAcked(util::memFn(&Session::PacedSend, this), now);
+        if (not msg.m_GotAck)
+        {
+          // we never heard back so the xmit itself may be what got lost
+          PacedSend(msg.XMIT());
+          resent++;
+        }
+        if (resent > 0)
+        {
+          msg.m_Retransmitted = true;
+          m_CC.OnRetransmit(resent);
+          m_CC.OnLoss(now);
+          m_CC.OnRTOExpired(now);
+        }
+      }
+      auto next = msg.m_StartedAt + timeout + 1ms;
+      if (msg.m_SentAt > 0s)
+        next = std::min(next, msg.m_LastFlush + rto);
+      ArmTimer(msg.m_TimerAt, std::max<llarp_time_t>(next, now + 1ms), eTXTimer, msg.m_MsgID);
+    }
+
+    void
+    Session::RXTimer(llarp_time_t now, InboundMessage& msg)
+    {
+      if (now < msg.m_TimerAt)
+        return;
+      msg.m_TimerAt = 0s;
+      if (msg.IsTimedOut(now))
+      {
+        RememberRXID(msg.m_MsgID);
+        m_RXMsgs.Erase(msg.m_MsgID);
+        return;
+      }
+      if (msg.ShouldSendACKS(now) and (m_State == State::Ready or m_State == State::LinkIntro))
+        msg.SendACKS(util::memFn(&Session::EncryptAndSend, this), now);
+      const auto next = std::min(
+          msg.m_LastActiveAt + DeliveryTimeout, msg.m_LastACKSent + ACKResendInterval);
+      ArmTimer(msg.m_TimerAt, next + 1ms, eRXTimer, msg.m_MsgID);
+    }
+
+    bool
+    Session::RememberRXID(uint64_t rxid)
+    {
+      return m_ReplayFilter.Insert(rxid);
+    }
+
+    void
+    Session::FinishOutbound(OutboundMessage& msg)
+    {
+      if (msg.m_SentAt == 0s)
+        return;
+      m_TXFragsInFlight -= std::min(msg.NumUnAcked(), m_TXFragsInFlight);
+    }
+
+    void
+    Session::SampleRTT(OutboundMessage& msg, llarp_time_t now)
+    {
+      // karn: an ack for something we sent twice could be for either copy
+      if (msg.m_GotAck or msg.m_Retransmitted or msg.m_SentAt == 0s)
+        return;
+      m_CC.OnRTTSample(now - msg.m_SentAt);
+    }
+
+    void
+    Session::TickPMTU(llarp_time_t now)
+    {
+      if (now < m_NextPMTUProbe)
+        return;
+      if (m_PMTURound < PMTUProbeRounds)
+      {
+        for (size_t idx = 0; idx < PMTUProbeSizes.size(); ++idx)
+        {
+          if (not m_PMTUAcked.test(idx))
+            SendPMTUProbe(PMTUProbeSizes[idx]);
+        }
+        m_PMTURound++;
+        m_NextPMTUProbe = now + PMTUProbeInterval;
+        return;
+      }
+      // no acks at all means the remote does not probe, it only understands the default
+      size_t fragsz = DefaultFragmentSize;
+      for (size_t idx = 0; idx < PMTUProbeSizes.size(); ++idx)
+      {
+        if (m_PMTUAcked.test(idx))
+          fragsz = PMTUProbeSizes[idx];
+      }
+      if (fragsz != m_TXFragmentSize)
+        LogInfo("using ", fragsz, " byte fragments to ", m_RemoteAddr);
+      SetTXFragmentSize(fragsz);
+      m_PMTURound = 0;
+      m_PMTUAcked.reset();
+      m_NextPMTUProbe = now + PMTUSearchInterval;
+    }
+
+    void
+    Session::SendPMTUProbe(size_t fragsz)
+    {
+      CryptoQueue_t probe;
+      probe.emplace_back(CreatePacket(
+          Command::ePING, PMTUProbeHeaderSize, XMITHeaderSize + fragsz - PMTUProbeHeaderSize, 0));
+      byte_t* ptr = probe.back().data() + PacketOverhead + CommandOverhead;
+      htobe32buf(ptr, PMTUProbeMagic);
+      ptr[4] = PMTUProbe;
+      htobe16buf(ptr + 5, fragsz);
+      // sent on its own so a probe the local interface refuses cannot take other packets with it,
+      // on the same worker as our other batches
+      const auto affinity = reinterpret_cast<uintptr_t>(this);
+      m_Parent->QueueWork(
+          affinity, [self = shared_from_this(), probe = std::move(probe)]() mutable {
+            self->EncryptWorker(std::move(probe));
+          });
+    }
+
+    void
+    Session::HandlePMTUProbeAck(size_t fragsz)
+    {
+      if (m_PMTURound == 0)
+        return;
+      const auto itr = std::find(PMTUProbeSizes.begin(), PMTUProbeSizes.end(), fragsz);
+      if (itr == PMTUProbeSizes.end())
+        return;
+      m_PMTUAcked.set(itr - PMTUProbeSizes.begin());
+      // it got through so use it right away, going down waits for the search to finish
+      if (fragsz > m_TXFragmentSize)
+      {
+        LogDebug("path to ", m_RemoteAddr, " fits ", fragsz, " byte fragments");
+        SetTXFragmentSize(fragsz);
+      }
+    }
+
+    void
+    Session::SetTXFragmentSize(size_t fragsz)
+    {
+      m_TXFragmentSize = fragsz;
+      m_CC.SetPacketSize(PacketOverhead + CommandOverhead + XMITHeaderSize + fragsz);
+    }
+
     void
     Session::SendMACK()
     {
@@ -228,33 +501,28 @@ namespace llarp
       {
         if (ShouldPing())
           SendKeepAlive();
-        for (auto& item : m_RXMsgs)
-        {
-          if (item.second.ShouldSendACKS(now))
-          {
-            item.second.SendACKS(util::memFn(&Session::EncryptAndSend, this), now);
-          }
-        }
-        for (auto& item : m_TXMsgs)
-        {
-          if (item.second.ShouldFlush(now))
-          {
-            item.second.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
-          }
-        }
+        // acks, retransmits and timeouts run off timers on the link layer
+        StartWaitingMessages(now);
       }
+      DrainPaced(now);
       auto self = shared_from_this();
       assert(self.use_count() > 1);
+      // a session's batches stay on one worker while it keeps up
+      const auto affinity = reinterpret_cast<uintptr_t>(this);
       if (not m_EncryptNext.empty())
       {
-        m_Parent->QueueWork([self, data = m_EncryptNext] { self->EncryptWorker(data); });
+        m_Parent->QueueWork(affinity, [self, data = std::move(m_EncryptNext)]() mutable {
+          self->EncryptWorker(std::move(data));
+        });
         m_EncryptNext.clear();
       }
 
       if (not m_DecryptNext.empty())
       {
         m_Parent->AddWakeup(weak_from_this());
-        m_Parent->QueueWork([self, data = m_DecryptNext] { self->DecryptWorker(data); });
+        m_Parent->QueueWork(affinity, [self, data = std::move(m_DecryptNext)]() mutable {
+          self->DecryptWorker(std::move(data));
+        });
         m_DecryptNext.clear();
       }
     }
@@ -310,8 +578,13 @@ namespace llarp
 
               {"state", StateToString(m_State)},
               {"inbound", m_Inbound},
-              {"replayFilter", m_ReplayFilter.size()},
+              {"replayFilter", m_ReplayFilter.Size()},
               {"txMsgQueueSize", m_TXMsgs.size()},
+              {"txMsgsWaiting", m_TXWaiting.size()},
+              {"txFragsInFlight", m_TXFragsInFlight},
+              {"txFragsPaced", m_PacedNext.size()},
+              {"congestion", m_CC.ExtractStatus()},
+              {"txFragmentSize", m_TXFragmentSize},
               {"rxMsgQueueSize", m_RXMsgs.size()},
               {"remoteAddr", m_RemoteAddr.toString()},
               {"remoteRC", m_RemoteRC.ExtractStatus()},
@@ -352,63 +625,18 @@ namespace llarp
         ResetRates();
         m_ResetRatesAt = now + 1s;
       }
-      // remove pending outbound messsages that timed out
-      // inform waiters
-      {
-        auto itr = m_TXMsgs.begin();
-        while (itr != m_TXMsgs.end())
-        {
-          if (itr->second.IsTimedOut(now))
-          {
-            m_Stats.totalDroppedTX++;
-            m_Stats.totalInFlightTX--;
-            LogDebug("Dropped unacked packet to ", m_RemoteAddr);
-            itr->second.InformTimeout();
-            itr = m_TXMsgs.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
-      {
-        // remove pending inbound messages that timed out
-        auto itr = m_RXMsgs.begin();
-        while (itr != m_RXMsgs.end())
-        {
-          if (itr->second.IsTimedOut(now))
-          {
-            m_ReplayFilter.emplace(itr->first, now);
-            itr = m_RXMsgs.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
-      {
-        // decay replay window
-        auto itr = m_ReplayFilter.begin();
-        while (itr != m_ReplayFilter.end())
-        {
-          if (itr->second + ReplayWindow <= now)
-          {
-            itr = m_ReplayFilter.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
+      if (m_State == State::Ready and m_Parent->PMTUDiscovery())
+        TickPMTU(now);
     }
 
-    using Introduction =
-        AlignedBuffer<PubKey::SIZE + PubKey::SIZE + TunnelNonce::SIZE + Signature::SIZE>;
-
     void
     Session::GenerateAndSendIntro()
     {
       TunnelNonce N;
       N.Randomize();
       {
-        ILinkSession::Packet_t req(Introduction::SIZE + PacketOverhead);
+        const size_t cookieSize = m_Cookie ? m_Cookie->size() : 0;
+        ILinkSession::Packet_t req(Introduction::SIZE + cookieSize + PacketOverhead);
         const auto pk = m_Parent->GetOurRC().pubkey;
         const auto e_pk = m_Parent->RouterEncryptionSecret().toPublic();
         auto itr = req.data() + PacketOverhead;
@@ -424,6 +652,9 @@ namespace llarp
             Z.data(),
             Z.size(),
             req.data() + PacketOverhead + (Introduction::SIZE - Signature::SIZE));
+        if (m_Cookie)
+          std::copy_n(
+              m_Cookie->data(), cookieSize, req.data() + PacketOverhead + Introduction::SIZE);
         CryptoManager::instance()->randbytes(req.data() + HMACSIZE, TUNNONCESIZE);
         EncryptAndSend(std::move(req));
       }
@@ -467,13 +698,23 @@ namespace llarp
       SendOurLIM();
     }
 
-    void
+    bool
+    Session::AcceptIntro(Packet_t pkt, std::optional<IntroGuard::Cookie_t> cookie)
+    {
+      m_RXRate += pkt.size();
+      m_Stats.totalPacketsRX++;
+      if (cookie)
+        token = *cookie;
+      return HandleGotIntro(std::move(pkt));
+    }
+
+    bool
     Session::HandleGotIntro(Packet_t pkt)
     {
       if (pkt.size() < (Introduction::SIZE + PacketOverhead))
       {
         LogWarn("intro too small from ", m_RemoteAddr);
-        return;
+        return false;
       }
       byte_t* ptr = pkt.data() + PacketOverhead;
       TunnelNonce N;
@@ -490,7 +731,7 @@ namespace llarp
       if (!CryptoManager::instance()->verify(m_ExpectedIdent, verifybuf, Z))
       {
         LogError("intro verify failed from ", m_RemoteAddr);
-        return;
+        return false;
       }
       const PubKey pk = m_Parent->TransportSecretKey().toPublic();
       LogDebug(
@@ -504,7 +745,7 @@ namespace llarp
               m_SessionKey, m_RemoteOnionKey, m_Parent->TransportSecretKey(), N))
       {
         LogError("failed to transport_dh_server on inbound intro from ", m_RemoteAddr);
-        return;
+        return false;
       }
       Packet_t reply(token.size() + PacketOverhead);
       // random nonce
@@ -515,11 +756,17 @@ namespace llarp
       EncryptAndSend(std::move(reply));
       LogDebug("sent intro ack to ", m_RemoteAddr);
       m_State = State::Introduction;
+      return true;
     }
 
     void
     Session::HandleGotIntroAck(Packet_t pkt)
     {
+      if (pkt.size() == RetrySize + PacketOverhead)
+      {
+        HandleRetry(std::move(pkt));
+        return;
+      }
       if (pkt.size() < (token.size() + PacketOverhead))
       {
         LogError(
@@ -547,6 +794,30 @@ namespace llarp
       m_State = State::LinkIntro;
     }
 
+    void
+    Session::HandleRetry(Packet_t pkt)
+    {
+      // anyone who knows our address can make a retry, do not let them keep us sending intros
+      if (m_IntroRetries >= MaxIntroRetries)
+        return;
+      SharedSecret introKey;
+      CryptoManager::instance()->shorthash(introKey, llarp_buffer_t(m_RemoteRC.pubkey));
+      ManagedBuffer buf{llarp_buffer_t{pkt}};
+      bool valid = false;
+      CryptoManager::instance()->verify_decrypt_batch(&buf, 1, introKey, &valid);
+      if (not valid or bufbe32toh(pkt.data() + PacketOverhead) != RetryMagic)
+      {
+        LogWarn("bad retry from ", m_RemoteAddr);
+        return;
+      }
+      m_IntroRetries++;
+      m_Cookie.emplace(pkt.data() + PacketOverhead + sizeof(RetryMagic));
+      LogDebug("got retry from ", m_RemoteAddr, ", sending our intro again with its cookie");
+      // the intro goes out under the key it went out with the first time
+      m_SessionKey = introKey;
+      GenerateAndSendIntro();
+    }
+
     bool
     Session::DecryptMessageInPlace(Packet_t& pkt)
     {
@@ -605,13 +876,21 @@ namespace llarp
     void
     Session::DecryptWorker(CryptoQueue_t msgs)
     {
-      auto itr = msgs.begin();
-      while (itr != msgs.end())
+      std::vector<ManagedBuffer> bufs;
+      bufs.reserve(msgs.size());
+      for (auto& pkt : msgs)
+        bufs.emplace_back(llarp_buffer_t{pkt});
+      std::unique_ptr<bool[]> valid{new bool[msgs.size()]};
+      CryptoManager::instance()->verify_decrypt_batch(
+          bufs.data(), bufs.size(), m_SessionKey, valid.get());
+
+      CryptoQueue_t plaintext;
+      plaintext.reserve(msgs.size());
+      for (size_t idx = 0; idx < msgs.size(); ++idx)
       {
-        auto& pkt = *itr;
-        if (not DecryptMessageInPlace(pkt))
+        auto& pkt = msgs[idx];
+        if (not valid[idx] or pkt.size() <= PacketOverhead)
         {
-          itr = msgs.erase(itr);
           LogError("failed to decrypt session data from ", m_RemoteAddr);
           continue;
         }
@@ -619,12 +898,11 @@ namespace llarp
         {
           LogError(
               "protocol version mismatch ", int(pkt[PacketOverhead]), " != ", LLARP_PROTO_VERSION);
-          itr = msgs.erase(itr);
           continue;
         }
-        ++itr;
+        plaintext.emplace_back(std::move(pkt));
       }
-      m_PlaintextRecv.tryPushBack(std::move(msgs));
+      m_PlaintextRecv.tryPushBack(std::move(plaintext));
       m_Parent->WakeupPlaintext();
     }
 
@@ -672,6 +950,7 @@ namespace llarp
     void
     Session::HandleMACK(Packet_t data)
     {
+      const auto now = m_Parent->Now();
       if (data.size() < (3 + PacketOverhead))
       {
         LogError("impossibly short mack from ", m_RemoteAddr);
@@ -689,13 +968,17 @@ namespace llarp
       {
         uint64_t acked = bufbe64toh(ptr);
         LogDebug("mack containing txid=", acked, " from ", m_RemoteAddr);
-        auto itr = m_TXMsgs.find(acked);
-        if (itr != m_TXMsgs.end())
+        if (auto* msg = m_TXMsgs.Find(acked))
         {
           m_Stats.totalAckedTX++;
           m_Stats.totalInFlightTX--;
-          itr->second.Completed();
-          m_TXMsgs.erase(itr);
+          SampleRTT(*msg, now);
+          m_CC.OnAcked(msg->NumUnAcked());
+          FinishOutbound(*msg);
+          // take it out first, the handler may queue more messages
+          auto sent = std::move(*msg);
+          m_TXMsgs.Erase(acked);
+          sent.Completed();
         }
         else
         {
@@ -716,10 +999,12 @@ namespace llarp
       }
       uint64_t txid = bufbe64toh(data.data() + CommandOverhead + PacketOverhead);
       LogDebug("got nack on ", txid, " from ", m_RemoteAddr);
-      auto itr = m_TXMsgs.find(txid);
-      if (itr != m_TXMsgs.end())
+      auto* msg = m_TXMsgs.Find(txid);
+      if (msg and msg->m_SentAt > 0s)
       {
-        EncryptAndSend(itr->second.XMIT());
+        msg->m_Retransmitted = true;
+        m_CC.OnRetransmit(1);
+        PacedSend(msg->XMIT());
       }
       m_LastRX = m_Parent->Now();
     }
@@ -727,9 +1012,7 @@ namespace llarp
     void
     Session::HandleXMIT(Packet_t data)
     {
-      static constexpr size_t XMITOverhead =
-          (CommandOverhead + PacketOverhead + sizeof(uint16_t) + sizeof(uint64_t)
-           + ShortHash::SIZE);
+      static constexpr size_t XMITOverhead = CommandOverhead + PacketOverhead + XMITHeaderSize;
       if (data.size() < XMITOverhead)
       {
         LogError("short XMIT from ", m_RemoteAddr);
@@ -743,8 +1026,7 @@ namespace llarp
       m_LastRX = m_Parent->Now();
       {
         // check for replay
-        auto itr = m_ReplayFilter.find(rxid);
-        if (itr != m_ReplayFilter.end())
+        if (m_ReplayFilter.Contains(rxid))
         {
           m_SendMACKs.emplace(rxid);
           LogDebug("duplicate rxid=", rxid, " from ", m_RemoteAddr);
@@ -753,34 +1035,53 @@ namespace llarp
       }
       {
         const auto now = m_Parent->Now();
-        auto itr = m_RXMsgs.find(rxid);
-        if (itr == m_RXMsgs.end())
+        if (m_RXMsgs.Find(rxid) == nullptr)
         {
-          itr =
-              m_RXMsgs.emplace(rxid, InboundMessage{rxid, sz, std::move(h), m_Parent->Now()}).first;
-          sz = std::min(sz, uint16_t{FragmentSize});
-          if ((data.size() - XMITOverhead) == sz)
+          if (sz > MAX_LINK_MSG_SIZE)
+          {
+            LogError("XMIT too big from ", m_RemoteAddr, " sz=", sz);
+            return;
+          }
+          // the xmit carries the first fragment, when there is more to come it is a whole one
+          // and tells us the fragment size the sender picked for this message
+          const size_t payload = data.size() - XMITOverhead;
+          const size_t fragsz = sz > payload ? payload : std::max(payload, DefaultFragmentSize);
+          if (fragsz < MinFragmentSize or fragsz > MaxFragmentSize)
+          {
+            LogError("bad XMIT fragment size from ", m_RemoteAddr, " ", fragsz);
+            return;
+          }
+          auto* rx = m_RXMsgs.Emplace(rxid, InboundMessage{rxid, sz, std::move(h), now, fragsz});
+          if (rx == nullptr)
+          {
+            LogWarn("too many inbound messages from ", m_RemoteAddr, " dropping rxid=", rxid);
+            return;
+          }
+          // ack right away
+          ArmTimer(rx->m_TimerAt, now, eRXTimer, rxid);
+          sz = std::min<size_t>(sz, fragsz);
+          if (payload == sz)
           {
             {
               const llarp_buffer_t buf(data.data() + (data.size() - sz), sz);
-              itr->second.HandleData(0, buf, now);
-              if (not itr->second.IsCompleted())
+              rx->HandleData(0, buf, now);
+              if (not rx->IsCompleted())
               {
                 return;
               }
 
-              if (not itr->second.Verify())
+              if (not rx->Verify())
               {
                 LogError("bad short xmit hash from ", m_RemoteAddr);
                 return;
               }
             }
-            auto msg = std::move(itr->second);
+            auto msg = std::move(*rx);
+            m_RXMsgs.Erase(rxid);
             const llarp_buffer_t buf(msg.m_Data);
             m_Parent->HandleMessage(this, buf);
-            if (m_ReplayFilter.emplace(rxid, m_Parent->Now()).second)
+            if (RememberRXID(rxid))
               m_SendMACKs.emplace(rxid);
-            m_RXMsgs.erase(rxid);
           }
         }
         else
@@ -799,10 +1100,10 @@ namespace llarp
       m_LastRX = m_Parent->Now();
       uint16_t sz = bufbe16toh(data.data() + CommandOverhead + PacketOverhead);
       uint64_t rxid = bufbe64toh(data.data() + CommandOverhead + sizeof(uint16_t) + PacketOverhead);
-      auto itr = m_RXMsgs.find(rxid);
-      if (itr == m_RXMsgs.end())
+      auto* rx = m_RXMsgs.Find(rxid);
+      if (rx == nullptr)
       {
-        if (m_ReplayFilter.find(rxid) == m_ReplayFilter.end())
+        if (not m_ReplayFilter.Contains(rxid))
         {
           LogDebug("no rxid=", rxid, " for ", m_RemoteAddr);
           auto nack = CreatePacket(Command::eNACK, 8);
@@ -820,24 +1121,24 @@ namespace llarp
       {
         const llarp_buffer_t buf(
             data.data() + PacketOverhead + 12, data.size() - (PacketOverhead + 12));
-        itr->second.HandleData(sz, buf, m_Parent->Now());
+        rx->HandleData(sz, buf, m_Parent->Now());
       }
 
-      if (itr->second.IsCompleted())
+      if (rx->IsCompleted())
       {
-        if (itr->second.Verify())
+        auto msg = std::move(*rx);
+        m_RXMsgs.Erase(rxid);
+        if (msg.Verify())
         {
-          auto msg = std::move(itr->second);
           const llarp_buffer_t buf(msg.m_Data);
           m_Parent->HandleMessage(this, buf);
-          if (m_ReplayFilter.emplace(itr->first, m_Parent->Now()).second)
-            m_SendMACKs.emplace(itr->first);
+          if (RememberRXID(rxid))
+            m_SendMACKs.emplace(rxid);
         }
         else
         {
-          LogError("hash mismatch for message ", itr->first);
+          LogError("hash mismatch for message ", rxid);
         }
-        m_RXMsgs.erase(itr);
       }
     }
 
@@ -852,23 +1153,53 @@ namespace llarp
       const auto now = m_Parent->Now();
       m_LastRX = now;
       uint64_t txid = bufbe64toh(data.data() + 2 + PacketOverhead);
-      auto itr = m_TXMsgs.find(txid);
-      if (itr == m_TXMsgs.end())
+      auto* found = m_TXMsgs.Find(txid);
+      if (found == nullptr)
       {
         LogDebug("no txid=", txid, " for ", m_RemoteAddr);
         return;
       }
-      itr->second.Ack(data[10 + PacketOverhead]);
+      auto& msg = *found;
+      uint16_t mask = data[10 + PacketOverhead];
+      if (msg.NumFragments() > 8)
+      {
+        // padding follows a one byte mask so only look for the second byte when we need it
+        if (data.size() < (12 + PacketOverhead))
+        {
+          LogError("short ACKS from ", m_RemoteAddr);
+          return;
+        }
+        mask |= uint16_t{data[11 + PacketOverhead]} << 8;
+      }
+      SampleRTT(msg, now);
+      const auto unacked = msg.NumUnAcked();
+      msg.Ack(mask);
+      const auto stillUnacked = msg.NumUnAcked();
+      if (msg.m_SentAt > 0s and stillUnacked < unacked)
+      {
+        m_CC.OnAcked(unacked - stillUnacked);
+        m_TXFragsInFlight -= std::min(unacked - stillUnacked, m_TXFragsInFlight);
+      }
 
-      if (itr->second.IsTransmitted())
+      if (msg.IsTransmitted())
       {
-        LogDebug("sent message ", itr->first);
-        itr->second.Completed();
-        itr = m_TXMsgs.erase(itr);
+        LogDebug("sent message ", txid);
+        FinishOutbound(msg);
+        // take it out first, the handler may queue more messages
+        auto sent = std::move(msg);
+        m_TXMsgs.Erase(txid);
+        sent.Completed();
       }
-      else
+      else if (msg.ShouldFlush(now, m_CC.SRTT()))
       {
-        itr->second.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
+        // resend the gaps once the missing fragments have had a round trip to show up
+        const auto resent = msg.FlushUnAcked(util::memFn(&Session::PacedSend, this), now);
+        if (resent > 0)
+        {
+          msg.m_Retransmitted = true;
+          m_CC.OnRetransmit(resent);
+          m_CC.OnLoss(now);
+        }
       }
     }
 
@@ -878,9 +1209,32 @@ namespace llarp
       Close();
     }
 
-    void Session::HandlePING(Packet_t)
+    void
+    Session::HandlePING(Packet_t data)
     {
       m_LastRX = m_Parent->Now();
+      if (data.size() < (CommandOverhead + PacketOverhead + PMTUProbeHeaderSize))
+        return;
+      const byte_t* ptr = data.data() + CommandOverhead + PacketOverhead;
+      if (bufbe32toh(ptr) != PMTUProbeMagic)
+        return;
+      const size_t fragsz = bufbe16toh(ptr + 5);
+      if (ptr[4] == PMTUProbeAck)
+      {
+        HandlePMTUProbeAck(fragsz);
+        return;
+      }
+      if (ptr[4] != PMTUProbe
+          or data.size() != CommandOverhead + PacketOverhead + XMITHeaderSize + fragsz)
+        return;
+      if (fragsz < MinFragmentSize or fragsz > MaxFragmentSize)
+        return;
+      auto ack = CreatePacket(Command::ePING, PMTUProbeHeaderSize);
+      byte_t* ackptr = ack.data() + CommandOverhead + PacketOverhead;
+      htobe32buf(ackptr, PMTUProbeMagic);
+      ackptr[4] = PMTUProbeAck;
+      htobe16buf(ackptr + 5, fragsz);
+      EncryptAndSend(std::move(ack));
     }
 
     bool
@@ -910,20 +1264,7 @@ namespace llarp
       switch (m_State)
       {
         case State::Initial:
-          if (m_Inbound)
-          {
-            // initial data
-            // enter introduction phase
-            if (DecryptMessageInPlace(data))
-            {
-              HandleGotIntro(std::move(data));
-            }
-            else
-            {
-              LogWarn("bad intro from ", m_RemoteAddr);
-              return false;
-            }
-          }
+          // inbound sessions start at AcceptIntro, the link has checked their intro already
           break;
         case State::Introduction:
           if (m_Inbound)
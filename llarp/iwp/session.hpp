@@ -2,12 +2,18 @@
 #define LLARP_IWP_SESSION_HPP
 
 #include <link/session.hpp>
+#include <iwp/congestion.hpp>
 #include <iwp/linklayer.hpp>
 #include <iwp/message_buffer.hpp>
+#include <iwp/message_table.hpp>
 #include <net/ip_address.hpp>
+#include <util/replay_filter.hpp>
 
+#include <array>
+#include <bitset>
 #include <unordered_set>
 #include <deque>
+#include <optional>
 #include <queue>
 
 #include <util/thread/queue.hpp>
@@ -25,16 +31,32 @@ namespace llarp
     static constexpr std::chrono::milliseconds DeliveryTimeout = 500ms;
     /// Time how long we wait to recieve a message
     static constexpr auto ReceivalTimeout = (DeliveryTimeout * 8) / 5;
-    /// How long to keep a replay window for
-    static constexpr auto ReplayWindow = (ReceivalTimeout * 3) / 2;
+    /// How many msgids below the highest one the replay window covers, a few send queues worth
+    static constexpr size_t ReplayWindow = 4096;
     /// How often to acks RX messages
     static constexpr auto ACKResendInterval = DeliveryTimeout / 2;
-    /// How often to retransmit TX fragments
-    static constexpr auto TXFlushInterval = (DeliveryTimeout / 5) * 4;
     /// How often we send a keepalive
     static constexpr std::chrono::milliseconds PingInterval = 5s;
     /// How long we wait for a session to die with no tx from them
     static constexpr auto SessionAliveTimeout = PingInterval * 5;
+    /// fragment sizes we probe the path for, 1344 is the largest that fits a 1500 byte mtu
+    /// over ipv6 and 4096 needs jumbo frames
+    static constexpr std::array<size_t, 5> PMTUProbeSizes{512, 768, 1024, 1344, 4096};
+    /// how long we wait for probe acks before probing again
+    static constexpr auto PMTUProbeInterval = 1s;
+    /// rounds of probes per search, a size counts as too big if none of its probes got acked
+    static constexpr size_t PMTUProbeRounds = 3;
+    /// how often we search again in case the path changed
+    static constexpr auto PMTUSearchInterval = 10min;
+    /// identity key, onion key, nonce and signature; a cookie from a retry may follow it
+    using Introduction =
+        AlignedBuffer<PubKey::SIZE + PubKey::SIZE + TunnelNonce::SIZE + Signature::SIZE>;
+    /// a retry is [u32 magic][cookie], keyed like an intro so only who we sent the intro to can
+    /// read it
+    static constexpr uint32_t RetryMagic = 0x72747279;
+    static constexpr size_t RetrySize = sizeof(uint32_t) + IntroGuard::Cookie_t::SIZE;
+    /// retries an outbound session follows before it waits for a real intro ack
+    static constexpr size_t MaxIntroRetries = 2;
 
     struct Session : public ILinkSession, public std::enable_shared_from_this<Session>
     {
@@ -56,14 +78,24 @@ namespace llarp
       void
       Tick(llarp_time_t now) override;
 
+      void
+      HandleTimer(llarp_time_t now, uint8_t kind, uint64_t id) override;
+
       bool
       SendMessageBuffer(ILinkSession::Message_t msg, CompletionHandler resultHandler) override;
 
       void
       Send_LL(const byte_t* buf, size_t sz);
 
+      /// send many encrypted packets at once so the link can batch them into one syscall
+      void
+      SendMany_LL(const std::vector<Packet_t>& pkts);
+
       void EncryptAndSend(ILinkSession::Packet_t);
 
+      /// queue a message fragment to go out as fast as the pacing allows
+      void PacedSend(ILinkSession::Packet_t);
+
       void
       Start() override;
 
@@ -72,6 +104,11 @@ namespace llarp
 
       bool Recv_LL(ILinkSession::Packet_t) override;
 
+      /// first packet of an inbound session, an intro the link decrypted already. a cookie the
+      /// intro carried becomes our token, the peer has shown it gets packets sent to its address
+      bool
+      AcceptIntro(Packet_t pkt, std::optional<IntroGuard::Cookie_t> cookie);
+
       bool
       SendKeepAlive() override;
 
@@ -163,7 +200,10 @@ namespace llarp
       /// session key
       SharedSecret m_SessionKey;
       /// session token
-      AlignedBuffer<24> token;
+      IntroGuard::Cookie_t token;
+      /// cookie to send along with our intro, from a retry
+      std::optional<IntroGuard::Cookie_t> m_Cookie;
+      size_t m_IntroRetries = 0;
 
       PubKey m_ExpectedIdent;
       PubKey m_RemoteOnionKey;
@@ -185,11 +225,58 @@ namespace llarp
       void
       ResetRates();
 
-      std::unordered_map<uint64_t, InboundMessage> m_RXMsgs;
-      std::unordered_map<uint64_t, OutboundMessage> m_TXMsgs;
+      /// what a timer we armed on the link layer is for, its id is the msgid
+      enum TimerKind : uint8_t
+      {
+        /// retransmit or drop an outbound message
+        eTXTimer,
+        /// ack or drop an inbound message
+        eRXTimer,
+      };
 
-      /// maps rxid to time recieved
-      std::unordered_map<uint64_t, llarp_time_t> m_ReplayFilter;
+      /// arm a timer unless one that fires no later than when is armed already
+      void
+      ArmTimer(llarp_time_t& armedAt, llarp_time_t when, TimerKind kind, uint64_t id);
+
+      /// timeout for outbound messages, gives slow links at least a couple of retransmits
+      llarp_time_t
+      TXTimeout() const;
+
+      /// how long unacked fragments wait before we resend them: the backed off rto, but short
+      /// enough that a message gets resent at least once before TXTimeout drops it
+      llarp_time_t
+      RetransmitTimeout() const;
+
+      void
+      TXTimer(llarp_time_t now, OutboundMessage& msg);
+
+      void
+      RXTimer(llarp_time_t now, InboundMessage& msg);
+
+      /// put a completed or expired rxid in the replay filter, returns false if already there
+      bool
+      RememberRXID(uint64_t rxid);
+
+      MessageTable<InboundMessage> m_RXMsgs{MaxSendQueueSize};
+      MessageTable<OutboundMessage> m_TXMsgs{MaxSendQueueSize};
+      /// txids waiting for room in the congestion window, oldest first
+      std::deque<uint64_t> m_TXWaiting;
+      /// fragments sent and not acked yet
+      size_t m_TXFragsInFlight = 0;
+      CongestionControl m_CC;
+      /// fragments held back by pacing
+      std::deque<Packet_t> m_PacedNext;
+
+      /// fragment size for new outbound messages
+      size_t m_TXFragmentSize = DefaultFragmentSize;
+      /// probe round of the current path mtu search, 0 when not searching
+      size_t m_PMTURound = 0;
+      /// which of PMTUProbeSizes got acked in the current search
+      std::bitset<PMTUProbeSizes.size()> m_PMTUAcked;
+      llarp_time_t m_NextPMTUProbe = 0s;
+
+      /// rxids we completed or gave up on
+      util::SequenceReplayFilter<ReplayWindow> m_ReplayFilter;
       /// rx messages to send in next round of multiacks
       std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> m_SendMACKs;
 
@@ -206,12 +293,16 @@ namespace llarp
       void
       DecryptWorker(CryptoQueue_t msgs);
 
-      void
+      bool
       HandleGotIntro(Packet_t pkt);
 
       void
       HandleGotIntroAck(Packet_t pkt);
 
+      /// the remote wants our intro again with a cookie
+      void
+      HandleRetry(Packet_t pkt);
+
       void
       HandleCreateSessionRequest(Packet_t pkt);
 
@@ -227,6 +318,37 @@ namespace llarp
       void
       SendMACK();
 
+      /// send the xmit and fragments for waiting messages that fit in the congestion window
+      void
+      StartWaitingMessages(llarp_time_t now);
+
+      /// let out as many paced fragments as the pacing budget allows
+      void
+      DrainPaced(llarp_time_t now);
+
+      /// a message got its last ack or was dropped, release its fragments from the window
+      void
+      FinishOutbound(OutboundMessage& msg);
+
+      /// take an rtt sample if this is the first ack for a message that was sent once
+      void
+      SampleRTT(OutboundMessage& msg, llarp_time_t now);
+
+      /// send the next round of path mtu probes or settle on a fragment size
+      void
+      TickPMTU(llarp_time_t now);
+
+      /// send a ping padded to the size of an xmit carrying a fragment of this size
+      void
+      SendPMTUProbe(size_t fragsz);
+
+      void
+      HandlePMTUProbeAck(size_t fragsz);
+
+      /// use this fragment size for new outbound messages and pace by packets carrying it
+      void
+      SetTXFragmentSize(size_t fragsz);
+
       void
       GenerateAndSendIntro();
 
@@ -33,12 +33,17 @@ namespace llarp
     virtual bool
     SendTo(
         const RouterID& remote,
-        const llarp_buffer_t& buf,
+        ILinkSession::Message_t msg,
         ILinkSession::CompletionHandler completed) = 0;
 
     virtual bool
     HasSessionTo(const RouterID& remote) const = 0;
 
+    /// messages waiting in the session SendTo would use for remote
+    /// return std::nullopt we have no session with this pubkey
+    virtual std::optional<size_t>
+    SendQueueBacklog(const RouterID& remote) const = 0;
+
     /// return true if the session with this pubkey is a client
     /// return false if the session with this pubkey is a router
     /// return std::nullopt we have no session with this pubkey
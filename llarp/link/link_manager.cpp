@@ -36,7 +36,9 @@ namespace llarp
 
   bool
   LinkManager::SendTo(
-      const RouterID& remote, const llarp_buffer_t& buf, ILinkSession::CompletionHandler completed)
+      const RouterID& remote,
+      ILinkSession::Message_t msg,
+      ILinkSession::CompletionHandler completed)
   {
     if (stopping)
       return false;
@@ -51,7 +53,7 @@ namespace llarp
       return false;
     }
 
-    return link->SendTo(remote, buf, completed);
+    return link->SendTo(remote, std::move(msg), std::move(completed));
   }
 
   bool
@@ -60,6 +62,15 @@ namespace llarp
     return GetLinkWithSessionTo(remote) != nullptr;
   }
 
+  std::optional<size_t>
+  LinkManager::SendQueueBacklog(const RouterID& remote) const
+  {
+    auto link = GetLinkWithSessionTo(remote);
+    if (link == nullptr)
+      return std::nullopt;
+    return link->SendQueueBacklog(remote);
+  }
+
   std::optional<bool>
   LinkManager::SessionIsClient(RouterID remote) const
   {
@@ -432,7 +443,13 @@ namespace llarp
         std::back_inserter(ob_links),
         [](const auto& link) -> util::StatusObject { return link->ExtractStatus(); });
 
-    util::StatusObject obj{{"outbound", ob_links}, {"inbound", ib_links}};
+    util::StatusObject obj{
+        {"outbound", ob_links},
+        {"inbound", ib_links},
+        {"pools",
+         util::StatusObject{
+             {"packet", ILinkSession::Packet_t::PoolStats().ExtractStatus()},
+             {"message", ILinkSession::Message_t::PoolStats().ExtractStatus()}}}};
 
     return obj;
   }
@@ -28,12 +28,15 @@ namespace llarp
     bool
     SendTo(
         const RouterID& remote,
-        const llarp_buffer_t& buf,
+        ILinkSession::Message_t msg,
         ILinkSession::CompletionHandler completed) override;
 
     bool
     HasSessionTo(const RouterID& remote) const override;
 
+    std::optional<size_t>
+    SendQueueBacklog(const RouterID& remote) const override;
+
     std::optional<bool>
     SessionIsClient(RouterID remote) const override;
 
@@ -48,6 +48,21 @@ namespace llarp
     return m_AuthedLinks.find(id) != m_AuthedLinks.end();
   }
 
+  std::optional<size_t>
+  ILinkLayer::SendQueueBacklog(const RouterID& pk)
+  {
+    Lock_t l(m_AuthedLinksMutex);
+    std::optional<size_t> backlog;
+    auto range = m_AuthedLinks.equal_range(pk);
+    for (auto itr = range.first; itr != range.second; ++itr)
+    {
+      const auto sz = itr->second->SendQueueBacklog();
+      if (not backlog or sz < *backlog)
+        backlog = sz;
+    }
+    return backlog;
+  }
+
   std::shared_ptr<ILinkSession>
   ILinkLayer::FindSessionByPubkey(RouterID id)
   {
@@ -130,10 +145,13 @@ namespace llarp
     m_Loop = loop;
     m_udp.user = this;
     m_udp.recvfrom = [](llarp_udp_io* udp, const llarp::SockAddr& from, ManagedBuffer pktbuf) {
-      ILinkSession::Packet_t pkt;
-      auto& buf = pktbuf.underlying;
-      pkt.resize(buf.sz);
-      std::copy_n(buf.base, buf.sz, pkt.data());
+      const auto& buf = pktbuf.underlying;
+      if (buf.sz > ILinkSession::Packet_t::MaxSize)
+      {
+        LogDebug("dropping oversized packet of ", buf.sz, " bytes from ", from);
+        return;
+      }
+      ILinkSession::Packet_t pkt{buf.base, buf.sz};
       static_cast<ILinkLayer*>(udp->user)->RecvFrom(from, std::move(pkt));
     };
     m_udp.tick = &ILinkLayer::udp_tick;
@@ -165,12 +183,24 @@ namespace llarp
     return llarp_ev_add_udp(m_Loop, &m_udp, m_ourAddr) != -1;
   }
 
+  void
+  ILinkLayer::ScheduleTimer(
+      std::weak_ptr<ILinkSession> session, llarp_time_t when, uint8_t kind, uint64_t id)
+  {
+    m_Timers.Schedule(when, SessionTimer{std::move(session), id, kind});
+  }
+
   void
   ILinkLayer::Pump()
   {
     std::unordered_set<RouterID, RouterID::Hash> closedSessions;
     std::vector<std::shared_ptr<ILinkSession>> closedPending;
     auto _now = Now();
+    // fire due timers before taking any locks, handlers may call back into us
+    m_Timers.Advance(_now, [_now](SessionTimer timer) {
+      if (auto session = timer.session.lock())
+        session->HandleTimer(_now, timer.kind, timer.id);
+    });
     {
       Lock_t l(m_AuthedLinksMutex);
       auto itr = m_AuthedLinks.begin();
@@ -287,9 +317,26 @@ namespace llarp
           [](const auto& item) -> util::StatusObject { return item.second->ExtractStatus(); });
     }
 
+    const auto& udpStats = m_udp.batchStats;
+    std::vector<uint64_t> recvBatches, sendBatches;
+    for (const auto& bucket : udpStats.recvBatchSizes)
+      recvBatches.emplace_back(bucket.load(std::memory_order_relaxed));
+    for (const auto& bucket : udpStats.sendBatchSizes)
+      sendBatches.emplace_back(bucket.load(std::memory_order_relaxed));
+
     return {{"name", Name()},
             {"rank", uint64_t(Rank())},
             {"addr", m_ourAddr.toString()},
+            {"udp",
+             util::StatusObject{{"batchSize", m_udp.batchSize},
+                                {"dontFragment", m_udp.dontFragment},
+                                {"recvCalls", udpStats.recvCalls.load()},
+                                {"recvPackets", udpStats.recvPackets.load()},
+                                {"recvBatches", recvBatches},
+                                {"sendCalls", udpStats.sendCalls.load()},
+                                {"sendPackets", udpStats.sendPackets.load()},
+                                {"sendBatches", sendBatches}}},
+            {"timers", m_Timers.Size()},
             {"sessions", util::StatusObject{{"pending", pending}, {"established", established}}}};
   }
 
@@ -442,7 +489,9 @@ namespace llarp
 
   bool
   ILinkLayer::SendTo(
-      const RouterID& remote, const llarp_buffer_t& buf, ILinkSession::CompletionHandler completed)
+      const RouterID& remote,
+      ILinkSession::Message_t msg,
+      ILinkSession::CompletionHandler completed)
   {
     std::shared_ptr<ILinkSession> s;
     {
@@ -463,9 +512,9 @@ namespace llarp
         ++itr;
       }
     }
-    ILinkSession::Message_t pkt(buf.sz);
-    std::copy_n(buf.base, buf.sz, pkt.begin());
-    return s && s->SendMessageBuffer(std::move(pkt), completed);
+    if (s == nullptr)
+      return false;
+    return s->SendMessageBuffer(std::move(msg), std::move(completed));
   }
 
   bool
@@ -9,10 +9,12 @@
 #include <util/status.hpp>
 #include <util/thread/logic.hpp>
 #include <util/thread/threading.hpp>
+#include <util/timer_wheel.hpp>
 #include <config/key_manager.hpp>
 
 #include <list>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 namespace llarp
@@ -67,8 +69,9 @@ namespace llarp
   using PumpDoneHandler = std::function<void(void)>;
 
   using Work_t = std::function<void(void)>;
-  /// queue work to worker thread
-  using WorkerFunc_t = std::function<void(Work_t)>;
+  /// queue work to worker thread, work queued with the same affinity tends to run on the same
+  /// thread
+  using WorkerFunc_t = std::function<void(uint64_t, Work_t)>;
 
   /// before connection hook, called before we try connecting via outbound link
   using BeforeConnectFunc_t = std::function<void(llarp::RouterContact)>;
@@ -99,6 +102,10 @@ namespace llarp
     bool
     HasSessionTo(const RouterID& pk);
 
+    /// backlog of the least backed up session to pk, the one SendTo would pick
+    std::optional<size_t>
+    SendQueueBacklog(const RouterID& pk) EXCLUDES(m_AuthedLinksMutex);
+
     void
     ForEachSession(std::function<void(const ILinkSession*)> visit, bool randomize = false) const
         EXCLUDES(m_AuthedLinksMutex);
@@ -115,6 +122,34 @@ namespace llarp
       llarp_ev_udp_sendto(&m_udp, to, pkt);
     }
 
+    /// send many packets to one remote in as few syscalls as the event loop allows
+    void
+    SendManyTo_LL(const SockAddr& to, const std::vector<ManagedBuffer>& pkts)
+    {
+      llarp_ev_udp_sendmanyto(&m_udp, to, pkts.data(), pkts.size());
+    }
+
+    /// set how many datagrams we move per syscall, must be called before Configure
+    void
+    SetUDPBatchSize(size_t num)
+    {
+      m_udp.batchSize = num;
+    }
+
+    /// turn path mtu probing on our sessions on or off, must be called before Configure
+    void
+    SetPMTUDiscovery(bool on)
+    {
+      m_udp.dontFragment = on;
+    }
+
+    /// do our sessions probe for the path mtu? false if the socket could not be set up for it
+    bool
+    PMTUDiscovery() const
+    {
+      return m_udp.dontFragment;
+    }
+
     virtual bool
     Configure(llarp_ev_loop_ptr loop, const std::string& ifname, int af, uint16_t port);
 
@@ -128,6 +163,12 @@ namespace llarp
     virtual void
     Pump();
 
+    /// call session->HandleTimer(now, kind, id) on the first pump at or after when,
+    /// nothing happens if the session is gone by then. event loop thread only
+    void
+    ScheduleTimer(
+        std::weak_ptr<ILinkSession> session, llarp_time_t when, uint8_t kind, uint64_t id);
+
     virtual void
     RecvFrom(const SockAddr& from, ILinkSession::Packet_t pkt) = 0;
 
@@ -146,7 +187,7 @@ namespace llarp
     virtual const char*
     Name() const = 0;
 
-    util::StatusObject
+    virtual util::StatusObject
     ExtractStatus() const EXCLUDES(m_AuthedLinksMutex);
 
     void
@@ -158,7 +199,7 @@ namespace llarp
     virtual bool
     SendTo(
         const RouterID& remote,
-        const llarp_buffer_t& buf,
+        ILinkSession::Message_t msg,
         ILinkSession::CompletionHandler completed);
 
     virtual bool
@@ -272,6 +313,16 @@ namespace llarp
     Pending m_Pending GUARDED_BY(m_PendingMutex);
 
     std::unordered_map<SockAddr, llarp_time_t, SockAddr::Hash> m_RecentlyClosed;
+
+   private:
+    struct SessionTimer
+    {
+      std::weak_ptr<ILinkSession> session;
+      uint64_t id;
+      uint8_t kind;
+    };
+    /// per message retransmit, ack and expiry deadlines of all our sessions
+    util::TimerWheel<SessionTimer> m_Timers;
   };
 
   using LinkLayer_ptr = std::shared_ptr<ILinkLayer>;
@@ -1,10 +1,12 @@
 #ifndef LLARP_LINK_SESSION_HPP
 #define LLARP_LINK_SESSION_HPP
 
+#include <constants/link_layer.hpp>
 #include <crypto/types.hpp>
 #include <net/net.hpp>
 #include <ev/ev.hpp>
 #include <router_contact.hpp>
+#include <util/buffer_pool.hpp>
 #include <util/types.hpp>
 
 #include <functional>
@@ -50,11 +52,17 @@ namespace llarp
     /// called every timer tick
     virtual void Tick(llarp_time_t) = 0;
 
+    /// a timer this session armed with ILinkLayer::ScheduleTimer fired,
+    /// kind and id mean whatever the session wants them to
+    virtual void
+    HandleTimer(llarp_time_t, uint8_t /* kind */, uint64_t /* id */){};
+
     /// message delivery result hook function
     using CompletionHandler = std::function<void(DeliveryStatus)>;
 
-    using Packet_t = std::vector<byte_t>;
-    using Message_t = std::vector<byte_t>;
+    /// pooled buffers so the forwarding path does not hit the heap per packet
+    using Packet_t = util::PooledBuffer<MAX_LINK_PACKET_SIZE>;
+    using Message_t = util::PooledBuffer<MAX_LINK_MSG_SIZE>;
 
     /// send a message buffer to the remote endpoint
     virtual bool
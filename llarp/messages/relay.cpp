@@ -6,11 +6,24 @@
 
 namespace llarp
 {
+  /// read a bencoded string into a relay payload
+  static bool
+  BDecodePayload(RelayPayload_t& payload, llarp_buffer_t* buf)
+  {
+    llarp_buffer_t strbuf;
+    if (not bencode_read_string(buf, &strbuf))
+      return false;
+    if (strbuf.sz > RelayPayload_t::MaxSize)
+      return false;
+    payload = RelayPayload_t{strbuf.base, strbuf.sz};
+    return true;
+  }
+
   void
   RelayUpstreamMessage::Clear()
   {
     pathid.Zero();
-    X.Clear();
+    X.clear();
     Y.Zero();
     version = 0;
   }
@@ -27,7 +40,7 @@ namespace llarp
       return false;
     if (!BEncodeWriteDictInt("v", LLARP_PROTO_VERSION, buf))
       return false;
-    if (!BEncodeWriteDictEntry("x", X, buf))
+    if (!BEncodeWriteDictString("x", X, buf))
       return false;
     if (!BEncodeWriteDictEntry("y", Y, buf))
       return false;
@@ -42,8 +55,12 @@ namespace llarp
       return false;
     if (!BEncodeMaybeVerifyVersion("v", version, LLARP_PROTO_VERSION, read, key, buf))
       return false;
-    if (!BEncodeMaybeReadDictEntry("x", X, read, key, buf))
-      return false;
+    if (key == "x")
+    {
+      if (not BDecodePayload(X, buf))
+        return false;
+      read = true;
+    }
     if (!BEncodeMaybeReadDictEntry("y", Y, read, key, buf))
       return false;
     return read;
@@ -55,7 +72,7 @@ namespace llarp
     auto path = r->pathContext().GetByDownstream(session->GetPubKey(), pathid);
     if (path)
     {
-      return path->HandleUpstream(llarp_buffer_t(X), Y, r);
+      return path->HandleUpstream(X, Y, r);
     }
     return false;
   }
@@ -64,7 +81,7 @@ namespace llarp
   RelayDownstreamMessage::Clear()
   {
     pathid.Zero();
-    X.Clear();
+    X.clear();
     Y.Zero();
     version = 0;
   }
@@ -81,7 +98,7 @@ namespace llarp
       return false;
     if (!BEncodeWriteDictInt("v", LLARP_PROTO_VERSION, buf))
       return false;
-    if (!BEncodeWriteDictEntry("x", X, buf))
+    if (!BEncodeWriteDictString("x", X, buf))
       return false;
     if (!BEncodeWriteDictEntry("y", Y, buf))
       return false;
@@ -96,8 +113,12 @@ namespace llarp
       return false;
     if (!BEncodeMaybeVerifyVersion("v", version, LLARP_PROTO_VERSION, read, key, buf))
       return false;
-    if (!BEncodeMaybeReadDictEntry("x", X, read, key, buf))
-      return false;
+    if (key == "x")
+    {
+      if (not BDecodePayload(X, buf))
+        return false;
+      read = true;
+    }
     if (!BEncodeMaybeReadDictEntry("y", Y, read, key, buf))
       return false;
     return read;
@@ -109,7 +130,7 @@ namespace llarp
     auto path = r->pathContext().GetByUpstream(session->GetPubKey(), pathid);
     if (path)
     {
-      return path->HandleDownstream(llarp_buffer_t(X), Y, r);
+      return path->HandleDownstream(X, Y, r);
     }
     llarp::LogWarn("unhandled downstream message id=", pathid);
     return false;
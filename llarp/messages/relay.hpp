@@ -1,18 +1,23 @@
 #ifndef LLARP_MESSAGES_RELAY_HPP
 #define LLARP_MESSAGES_RELAY_HPP
 
-#include <crypto/encrypted.hpp>
+#include <constants/link_layer.hpp>
 #include <crypto/types.hpp>
 #include <messages/link_message.hpp>
 #include <path/path_types.hpp>
+#include <util/buffer_pool.hpp>
 
 #include <vector>
 
 namespace llarp
 {
+  /// onion encrypted payload of a relay message, refcounted so it moves from link decode through
+  /// the hop crypto to the outbound encode without being copied
+  using RelayPayload_t = util::PooledBuffer<MAX_LINK_MSG_SIZE - 128>;
+
   struct RelayUpstreamMessage : public ILinkMessage
   {
-    Encrypted<MAX_LINK_MSG_SIZE - 128> X;
+    RelayPayload_t X;
     TunnelNonce Y;
 
     bool
@@ -41,7 +46,7 @@ namespace llarp
 
   struct RelayDownstreamMessage : public ILinkMessage
   {
-    Encrypted<MAX_LINK_MSG_SIZE - 128> X;
+    RelayPayload_t X;
     TunnelNonce Y;
 
     bool
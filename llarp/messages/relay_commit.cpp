@@ -13,6 +13,7 @@
 #include <util/logging/logger.hpp>
 #include <util/meta/memfn.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <tooling/path_event.hpp>
 
 #include <functional>
@@ -241,7 +242,7 @@ namespace llarp
       auto func =
           std::bind(&LR_StatusMessage::CreateAndSend, router, pathid, nextHop, pathKey, status);
 
-      router->QueueWork(func);
+      router->QueueCryptoWork(thread::WorkLane::Handshake, PathID_t::Hash{}(pathid), func);
     }
 
     /// this is done from logic thread
@@ -465,8 +466,11 @@ namespace llarp
 
     // decrypt frames async
     frameDecrypt->decrypter->AsyncDecrypt(
-        frameDecrypt->frames[0], frameDecrypt, [r = context->Router()](auto func) {
-          r->QueueWork(std::move(func));
+        frameDecrypt->frames[0],
+        frameDecrypt,
+        [r = context->Router(), affinity = reinterpret_cast<uintptr_t>(frameDecrypt.get())](
+            auto func) {
+          r->QueueCryptoWork(thread::WorkLane::Handshake, affinity, std::move(func));
         });
     return true;
   }
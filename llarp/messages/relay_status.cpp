@@ -10,6 +10,7 @@
 #include <util/logging/logger.hpp>
 #include <util/meta/memfn.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <tooling/path_event.hpp>
 
 #include <functional>
@@ -54,7 +55,7 @@ namespace llarp
     queue_handle()
     {
       auto func = std::bind(&llarp::LRSM_AsyncHandler::handle, shared_from_this());
-      router->QueueWork(func);
+      router->QueueCryptoWork(thread::WorkLane::Handshake, PathID_t::Hash{}(pathid), func);
     }
   };
 
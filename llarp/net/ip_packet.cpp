@@ -65,26 +65,26 @@ namespace llarp
     bool
     IPPacket::Load(const llarp_buffer_t& pkt)
     {
-      if (pkt.sz > sizeof(buf) or pkt.sz == 0)
+      if (pkt.sz > capacity() or pkt.sz == 0)
         return false;
-      sz = pkt.sz;
-      std::copy_n(pkt.base, sz, buf);
+      resize_for_overwrite(pkt.sz);
+      std::copy_n(pkt.base, pkt.sz, data());
       return true;
     }
 
     ManagedBuffer
     IPPacket::ConstBuffer() const
     {
-      const byte_t* ptr = buf;
-      llarp_buffer_t b(ptr, sz);
+      const byte_t* ptr = data();
+      llarp_buffer_t b(ptr, size());
       return ManagedBuffer(b);
     }
 
     ManagedBuffer
     IPPacket::Buffer()
     {
-      byte_t* ptr = buf;
-      llarp_buffer_t b(ptr, sz);
+      byte_t* ptr = data();
+      llarp_buffer_t b(ptr, size());
       return ManagedBuffer(b);
     }
 
@@ -330,10 +330,10 @@ namespace llarp
 
       // L4 checksum
       auto ihs = size_t(hdr->ihl * 4);
-      if (ihs <= sz)
+      if (ihs <= size())
       {
-        auto pld = buf + ihs;
-        auto psz = sz - ihs;
+        auto pld = data() + ihs;
+        auto psz = size() - ihs;
 
         auto fragoff = size_t((ntohs(hdr->frag_off) & 0x1Fff) * 8);
 
@@ -367,7 +367,7 @@ namespace llarp
       const size_t ihs = 4 + 4 + 16 + 16;
 
       // XXX should've been checked at upper level?
-      if (sz <= ihs)
+      if (size() <= ihs)
         return;
 
       auto hdr = HeaderV6();
@@ -389,8 +389,8 @@ namespace llarp
       const uint32_t* nDstIP = in6_uint32_ptr(hdr->dstaddr);
 
       // TODO IPv6 header options
-      auto pld = buf + ihs;
-      auto psz = sz - ihs;
+      auto pld = data() + ihs;
+      auto psz = size() - ihs;
 
       size_t fragoff = 0;
       auto nextproto = hdr->proto;
@@ -485,7 +485,14 @@ namespace llarp
       {
         constexpr auto icmp_Header_size = 8;
         constexpr auto ip_Header_size = 20;
+        // size pf ip header
+        const size_t l3_HeaderSize = Header()->ihl * 4;
+        // size of l4 packet to reflect back
+        const size_t l4_PacketSize = 8;
+        if (size() < l3_HeaderSize + l4_PacketSize)
+          return std::nullopt;
         net::IPPacket pkt{};
+        pkt.resize(ip_Header_size + icmp_Header_size + l3_HeaderSize + l4_PacketSize);
         auto* pkt_Header = pkt.Header();
 
         pkt_Header->version = 4;
@@ -498,14 +505,10 @@ namespace llarp
         pkt_Header->protocol = 1;  // ICMP
         pkt_Header->ttl = 1;
         pkt_Header->frag_off = htons(0b0100000000000000);
-        // size pf ip header
-        const size_t l3_HeaderSize = Header()->ihl * 4;
-        // size of l4 packet to reflect back
-        const size_t l4_PacketSize = 8;
         pkt_Header->tot_len += ntohs(l4_PacketSize + l3_HeaderSize);
 
         uint16_t* checksum;
-        uint8_t* itr = pkt.buf + (pkt_Header->ihl * 4);
+        uint8_t* itr = pkt.data() + (pkt_Header->ihl * 4);
         uint8_t* icmp_begin = itr;  // type 'destination unreachable'
         *itr++ = 3;
         // code	'Destination host unknown error'
@@ -518,14 +521,13 @@ namespace llarp
         htobe16buf(itr, 1500);
         itr += 2;
         // copy ip header and first 8 bytes of datagram for icmp rject
-        std::copy_n(buf, l4_PacketSize + l3_HeaderSize, itr);
+        std::copy_n(data(), l4_PacketSize + l3_HeaderSize, itr);
         itr += l4_PacketSize + l3_HeaderSize;
         // calculate checksum of ip header
-        pkt_Header->check = ipchksum(pkt.buf, pkt_Header->ihl * 4);
+        pkt_Header->check = ipchksum(pkt.data(), pkt_Header->ihl * 4);
         const auto icmp_size = std::distance(icmp_begin, itr);
         // calculate icmp checksum
         *checksum = ipchksum(icmp_begin, icmp_size);
-        pkt.sz = ntohs(pkt_Header->tot_len);
         return pkt;
       }
       return std::nullopt;
@@ -4,8 +4,13 @@
 #include <ev/ev.h>
 #include <net/net.hpp>
 #include <util/buffer.hpp>
+#include <util/buffer_pool.hpp>
 #include <util/time.hpp>
 
+#ifndef LLARP_IP_PACKET_CAPACITY
+#define LLARP_IP_PACKET_CAPACITY (1500)
+#endif
+
 #ifndef _WIN32
 // unix, linux
 #include <sys/types.h>  // FreeBSD needs this for uchar for ip.h
@@ -115,13 +120,75 @@ namespace llarp
 {
   namespace net
   {
-    /// an Packet
+    /// an ip packet held in a pooled, refcounted buffer
+    ///
+    /// copies share the bytes, anything that writes through data() or a header gets bytes of its
+    /// own first, so packets are cheap to move and to copy from stage to stage.
     struct IPPacket
     {
-      static constexpr size_t MaxSize = 1500;
-      llarp_time_t timestamp;
-      size_t sz;
-      byte_t buf[MaxSize];
+      /// biggest packet we hold, set at build time with LLARP_IP_PACKET_CAPACITY
+      static constexpr size_t MaxSize = LLARP_IP_PACKET_CAPACITY;
+      static_assert(MaxSize >= 1280 and MaxSize <= 65535);
+
+      using Buffer_t = util::PooledBuffer<MaxSize>;
+
+      llarp_time_t timestamp = 0s;
+
+      /// the bytes to write to, copied first if another packet shares them
+      byte_t*
+      data()
+      {
+        m_Buf.detach();
+        return m_Buf.data();
+      }
+
+      const byte_t*
+      data() const
+      {
+        return m_Buf.data();
+      }
+
+      size_t
+      size() const
+      {
+        return m_Buf.size();
+      }
+
+      bool
+      empty() const
+      {
+        return m_Buf.empty();
+      }
+
+      static constexpr size_t
+      capacity()
+      {
+        return MaxSize;
+      }
+
+      /// resize within capacity(), new bytes are zero filled
+      void
+      resize(size_t sz)
+      {
+        m_Buf.detach();
+        m_Buf.resize(sz);
+      }
+
+      /// resize within capacity() leaving new bytes as they are, for when the caller is about to
+      /// write all of them, e.g. reading into the whole capacity and then shrinking
+      void
+      resize_for_overwrite(size_t sz)
+      {
+        m_Buf.detach();
+        m_Buf.resize_for_overwrite(sz);
+      }
+
+      /// drop the bytes, the buffer goes back to the pool if we held the last reference
+      void
+      clear()
+      {
+        m_Buf.reset();
+      }
 
       ManagedBuffer
       Buffer();
@@ -170,7 +237,7 @@ namespace llarp
         bool
         operator()(const IPPacket& left, const IPPacket& right)
         {
-          return left.sz < right.sz;
+          return left.size() < right.size();
         }
       };
 
@@ -186,30 +253,32 @@ namespace llarp
       inline ip_header*
       Header()
       {
-        return (ip_header*)&buf[0];
+        return (ip_header*)data();
       }
 
       inline const ip_header*
       Header() const
       {
-        return (ip_header*)&buf[0];
+        return (const ip_header*)data();
       }
 
       inline ipv6_header*
       HeaderV6()
       {
-        return (ipv6_header*)&buf[0];
+        return (ipv6_header*)data();
       }
 
       inline const ipv6_header*
       HeaderV6() const
       {
-        return (ipv6_header*)&buf[0];
+        return (const ipv6_header*)data();
       }
 
       inline int
       Version() const
       {
+        if (empty())
+          return 0;
         return Header()->version;
       }
 
@@ -278,6 +347,9 @@ namespace llarp
       /// make an icmp unreachable reply packet based of this ip packet
       std::optional<IPPacket>
       MakeICMPUnreachable() const;
+
+     private:
+      Buffer_t m_Buf;
     };
 
   }  // namespace net
@@ -4,26 +4,66 @@
 #include <crypto/types.hpp>
 #include <router_contact.hpp>
 #include <util/buffer.hpp>
+#include <util/endian.hpp>
 #include <util/fs.hpp>
 #include <util/logging/logger.hpp>
 #include <util/mem.hpp>
 #include <util/thread/logic.hpp>
 #include <util/str.hpp>
-#include <dht/kademlia.hpp>
 
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <unordered_map>
 #include <utility>
 
 static const char skiplist_subdirs[] = "0123456789abcdef";
 static const std::string RC_FILE_EXT = ".signed";
+static const std::string SNAPSHOT_FILE = "nodedb.snapshot";
 
 namespace llarp
 {
   NodeDB::Entry::Entry(RouterContact value) : rc(std::move(value)), insertedAt(llarp::time_now_ms())
   {}
 
+  const NodeDB::Entry*
+  NodeDB::Snapshot::Find(const RouterID& pk) const
+  {
+    const auto itr = index.find(pk);
+    if (itr == index.end())
+      return nullptr;
+    return entries[itr->second].get();
+  }
+
+  void
+  NodeDB::Snapshot::Insert(Entry_ptr entry)
+  {
+    byLocation.Insert(dht::Key_t{entry->rc.pubkey.as_array()}, entry);
+    const auto [itr, inserted] = index.emplace(entry->rc.pubkey, entries.size());
+    if (inserted)
+      entries.emplace_back(std::move(entry));
+    else
+      entries[itr->second] = std::move(entry);
+  }
+
+  bool
+  NodeDB::Snapshot::Erase(const RouterID& pk)
+  {
+    const auto itr = index.find(pk);
+    if (itr == index.end())
+      return false;
+    const auto idx = itr->second;
+    index.erase(itr);
+    byLocation.Erase(dht::Key_t{pk.as_array()});
+    if (idx + 1 != entries.size())
+    {
+      entries[idx] = std::move(entries.back());
+      index[entries[idx]->rc.pubkey] = idx;
+    }
+    entries.pop_back();
+    return true;
+  }
+
   static void
   EnsureSkiplist(fs::path nodedbDir)
   {
@@ -57,9 +97,14 @@ namespace llarp
 
   constexpr auto FlushInterval = 5min;
 
-  NodeDB::NodeDB(fs::path root, std::function<void(std::function<void()>)> diskCaller)
-      : m_Root{std::move(root)}
+  NodeDB::NodeDB(
+      fs::path root,
+      std::function<void(std::function<void()>)> diskCaller,
+      std::function<void(std::function<void()>)> workCaller)
+      : m_Snapshot{std::make_shared<Snapshot>()}
+      , m_Root{std::move(root)}
       , disk(std::move(diskCaller))
+      , work(std::move(workCaller))
       , m_NextFlushAt{time_now_ms() + FlushInterval}
   {
     EnsureSkiplist(m_Root);
@@ -71,38 +116,215 @@ namespace llarp
     if (now > m_NextFlushAt)
     {
       m_NextFlushAt += FlushInterval;
-      // make copy of all rcs
-      std::vector<RouterContact> copy;
-      for (const auto& item : m_Entries)
-        copy.push_back(item.second.rc);
-      // flush them to disk in one big job
-      // TODO: split this up? idk maybe some day...
-      disk([this, data = std::move(copy)]() {
-        for (const auto& rc : data)
-        {
-          rc.Write(GetPathForPubkey(rc.pubkey));
-        }
+      std::unordered_set<RouterID> changed;
+      {
+        util::Lock lock{m_WriteAccess};
+        changed.swap(m_Dirty);
+      }
+      if (changed.empty())
+        return;
+      // take the snapshot once we hold the file, so a save that got there first can never be
+      // followed by older records; snapshots are immutable so the disk thread reads it directly
+      disk([this, changed = std::move(changed)]() {
+        util::Lock lock{m_FileAccess};
+        AppendSnapshotFile(*Current(), changed);
       });
     }
   }
 
   fs::path
-  NodeDB::GetPathForPubkey(RouterID pubkey) const
+  NodeDB::GetSnapshotPath() const
   {
-    std::string hexString = oxenmq::to_hex(pubkey.begin(), pubkey.end());
-    std::string skiplistDir;
+    return m_Root / SNAPSHOT_FILE;
+  }
 
-    const llarp::RouterID r{pubkey};
-    std::string fname = r.ToString();
+  // the snapshot file is the magic followed by records of a little endian 32 bit length, the 32
+  // byte ident pubkey and that many bytes of bencoded rc. a length of 0 means the router was
+  // removed. records are only ever appended so the last one for a pubkey wins.
+  static constexpr std::array<byte_t, 8> SnapshotMagic{'l', 'o', 'k', 'i', 'n', 'd', 'b', 1};
+  constexpr size_t SnapshotRecordHeader = sizeof(uint32_t) + RouterID::SIZE;
+  /// the file is rewritten instead of appended to once it holds this many records per live rc
+  constexpr size_t SnapshotMaxRecordsPerRC = 2;
+  /// never bother compacting files smaller than this many records
+  constexpr size_t SnapshotMinCompact = 256;
+  /// most jobs we split decoding and verifying rcs on load into
+  constexpr size_t MaxLoadJobs = 8;
+
+  static bool
+  WriteSnapshotRecord(std::ostream& out, const RouterID& pk, const RouterContact* rc)
+  {
+    std::array<byte_t, MAX_RC_SIZE> tmp;
+    llarp_buffer_t buf(tmp);
+    if (rc and not rc->BEncode(&buf))
+      return false;
+    const uint32_t len = buf.cur - buf.base;
+    const uint32_t len_le = htole32(len);
+    out.write(reinterpret_cast<const char*>(&len_le), sizeof(len_le));
+    out.write(reinterpret_cast<const char*>(pk.data()), pk.size());
+    out.write(reinterpret_cast<const char*>(tmp.data()), len);
+    return out.good();
+  }
 
-    skiplistDir += hexString[0];
-    fname += RC_FILE_EXT;
-    return m_Root / skiplistDir / fname;
+  bool
+  NodeDB::WriteSnapshotFile(const Snapshot& snapshot) const
+  {
+    const auto path = GetSnapshotPath();
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+      auto f = util::OpenFileStream<std::ofstream>(tmpPath, std::ios::binary | std::ios::trunc);
+      if (not f or not f->is_open())
+      {
+        LogError("cannot open ", tmpPath);
+        return false;
+      }
+      f->write(reinterpret_cast<const char*>(SnapshotMagic.data()), SnapshotMagic.size());
+      for (const auto& entry : snapshot.entries)
+        WriteSnapshotRecord(*f, entry->rc.pubkey, &entry->rc);
+      if (not f->good())
+      {
+        LogError("failed to write ", tmpPath);
+        return false;
+      }
+    }
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    if (ec)
+    {
+      LogError("failed to replace ", path, ": ", ec.message());
+      return false;
+    }
+    m_FileRecords = snapshot.entries.size();
+    return true;
   }
 
   void
-  NodeDB::LoadFromDisk()
+  NodeDB::AppendSnapshotFile(
+      const Snapshot& snapshot, const std::unordered_set<RouterID>& changed) const
+  {
+    const auto path = GetSnapshotPath();
+    const auto records = m_FileRecords + changed.size();
+    if (not fs::exists(path)
+        or records > SnapshotMaxRecordsPerRC
+                * std::max(snapshot.entries.size(), SnapshotMinCompact / SnapshotMaxRecordsPerRC))
+    {
+      WriteSnapshotFile(snapshot);
+      return;
+    }
+    std::ofstream f{path, std::ios::binary | std::ios::app};
+    for (const auto& pk : changed)
+    {
+      const auto* entry = snapshot.Find(pk);
+      WriteSnapshotRecord(f, pk, entry ? &entry->rc : nullptr);
+    }
+    if (not f.good())
+      LogError("failed to append to ", path);
+    m_FileRecords = records;
+  }
+
+  bool
+  NodeDB::LoadSnapshotFile()
+  {
+    const auto started = time_now_ms();
+    const auto path = GetSnapshotPath();
+    util::MappedFile file;
+    if (not file.Open(path))
+      return false;
+    const byte_t* const data = file.data();
+    const size_t size = file.size();
+    if (size < SnapshotMagic.size()
+        or not std::equal(SnapshotMagic.begin(), SnapshotMagic.end(), data))
+    {
+      LogWarn("ignoring nodedb snapshot ", path, " with a bad header");
+      return false;
+    }
+
+    // find the latest record for each router, nothing gets decoded here
+    std::unordered_map<RouterID, std::pair<size_t, size_t>> latest;
+    size_t numRecords = 0;
+    size_t pos = SnapshotMagic.size();
+    while (size - pos >= SnapshotRecordHeader)
+    {
+      const uint32_t len = le32toh(buf32toh(data + pos));
+      if (len > MAX_RC_SIZE or size - pos - SnapshotRecordHeader < len)
+        break;
+      latest[RouterID{data + pos + sizeof(uint32_t)}] = {pos + SnapshotRecordHeader, len};
+      pos += SnapshotRecordHeader + len;
+      ++numRecords;
+    }
+    std::vector<std::pair<size_t, size_t>> records;
+    records.reserve(latest.size());
+    for (const auto& item : latest)
+    {
+      if (item.second.second > 0)
+        records.emplace_back(item.second);
+    }
+
+    // decoding and checking signatures is where the time goes, so hand some of it to the worker
+    // threads working straight out of the mapping; we take records ourselves too so this finishes
+    // even if every worker is busy, then wait for the jobs since they use our locals
+    std::vector<std::optional<RouterContact>> decoded(records.size());
+    std::atomic<size_t> nextRecord{0};
+    const auto now = time_now_ms();
+    auto decode = [&]() {
+      for (size_t idx = nextRecord++; idx < records.size(); idx = nextRecord++)
+      {
+        llarp_buffer_t buf{data + records[idx].first, records[idx].second};
+        RouterContact rc{};
+        if (rc.BDecode(&buf) and rc.Verify(now))
+          decoded[idx] = std::move(rc);
+      }
+    };
+    const size_t numJobs = work ? std::min(MaxLoadJobs, records.size() / 64 + 1) : 1;
+    util::Semaphore jobsDone{0};
+    for (size_t n = 1; n < numJobs; ++n)
+    {
+      work([&]() {
+        decode();
+        jobsDone.notify();
+      });
+    }
+    decode();
+    for (size_t n = 1; n < numJobs; ++n)
+      jobsDone.wait();
+
+    size_t numLoaded = 0;
+    Update([&](Snapshot& next) {
+      for (auto& rc : decoded)
+      {
+        if (not rc)
+          continue;
+        next.Insert(std::make_shared<Entry>(std::move(*rc)));
+        ++numLoaded;
+      }
+      return numLoaded > 0;
+    });
+    m_FileRecords = numRecords;
+    LogInfo(
+        "loaded ",
+        numLoaded,
+        " of ",
+        records.size(),
+        " rcs from ",
+        path,
+        " in ",
+        time_now_ms() - started);
+
+    if (pos != size)
+    {
+      // most likely we died half way through an append, anything after it would be unreadable
+      LogWarn("nodedb snapshot ", path, " has a truncated record, rewriting it");
+      WriteSnapshotFile(*Current());
+    }
+    return true;
+  }
+
+  std::vector<fs::path>
+  NodeDB::LoadDirectory()
   {
+    const auto started = time_now_ms();
+    std::vector<RouterContact> loaded;
+    std::vector<fs::path> files;
     for (const char& ch : skiplist_subdirs)
     {
       if (!ch)
@@ -114,160 +336,167 @@ namespace llarp
       llarp::util::IterDir(sub, [&](const fs::path& f) -> bool {
         if (fs::is_regular_file(f) and f.extension() == RC_FILE_EXT)
         {
+          files.push_back(f);
           RouterContact rc{};
           if (rc.Read(f) and rc.Verify(time_now_ms()))
-            m_Entries.emplace(rc.pubkey, rc);
+            loaded.emplace_back(std::move(rc));
         }
         return true;
       });
     }
+    // publish everything we read at once
+    Update([&](Snapshot& next) {
+      for (auto& rc : loaded)
+        next.Insert(std::make_shared<Entry>(std::move(rc)));
+      return not loaded.empty();
+    });
+    LogInfo("imported ", loaded.size(), " rcs from ", m_Root, " in ", time_now_ms() - started);
+    return files;
   }
 
   void
-  NodeDB::SaveToDisk() const
+  NodeDB::LoadFromDisk()
   {
-    for (const auto& item : m_Entries)
+    util::Lock lock{m_FileAccess};
+    if (LoadSnapshotFile())
+      return;
+    const auto imported = LoadDirectory();
+    // so the next start does not have to walk the directories again; the files go once the
+    // snapshot has them, otherwise losing the snapshot would bring back routers removed since
+    if (not WriteSnapshotFile(*Current()))
+      return;
+    for (const auto& file : imported)
     {
-      item.second.rc.Write(GetPathForPubkey(item.first));
+      std::error_code ec;
+      fs::remove(file, ec);
     }
   }
 
+  void
+  NodeDB::SaveToDisk() const
+  {
+    util::Lock lock{m_FileAccess};
+    WriteSnapshotFile(*Current());
+  }
+
   bool
   NodeDB::Has(RouterID pk) const
   {
-    util::NullLock lock{m_Access};
-    return m_Entries.find(pk) != m_Entries.end();
+    return Current()->Find(pk) != nullptr;
   }
 
   std::optional<RouterContact>
   NodeDB::Get(RouterID pk) const
   {
-    util::NullLock lock{m_Access};
-    const auto itr = m_Entries.find(pk);
-    if (itr == m_Entries.end())
-      return std::nullopt;
-    return itr->second.rc;
+    const auto snapshot = Current();
+    if (const auto* entry = snapshot->Find(pk))
+      return entry->rc;
+    return std::nullopt;
   }
 
   void
   NodeDB::Remove(RouterID pk)
   {
-    util::NullLock lock{m_Access};
-    m_Entries.erase(pk);
-    AsyncRemoveManyFromDisk({pk});
+    Update([this, &pk](Snapshot& next) {
+      if (not next.Erase(pk))
+        return false;
+      m_Dirty.insert(pk);
+      return true;
+    });
   }
 
   void
   NodeDB::RemoveStaleRCs(std::unordered_set<RouterID> keep, llarp_time_t cutoff)
   {
-    util::NullLock lock{m_Access};
-    std::unordered_set<RouterID> removed;
-    auto itr = m_Entries.begin();
-    while (itr != m_Entries.end())
-    {
-      if (itr->second.insertedAt < cutoff and keep.count(itr->second.rc.pubkey) == 0)
-      {
-        removed.insert(itr->second.rc.pubkey);
-        itr = m_Entries.erase(itr);
-      }
-      else
-        ++itr;
-    }
-    if (not removed.empty())
-      AsyncRemoveManyFromDisk(std::move(removed));
+    Update([&](Snapshot& next) {
+      const auto removed = next.EraseIf([&](const Entry& entry) {
+        return entry.insertedAt < cutoff and keep.count(entry.rc.pubkey) == 0;
+      });
+      m_Dirty.insert(removed.begin(), removed.end());
+      return not removed.empty();
+    });
   }
 
   void
   NodeDB::Put(RouterContact rc)
   {
-    util::NullLock lock{m_Access};
-    m_Entries.erase(rc.pubkey);
-    m_Entries.emplace(rc.pubkey, rc);
+    auto entry = std::make_shared<Entry>(std::move(rc));
+    Update([this, &entry](Snapshot& next) {
+      m_Dirty.insert(entry->rc.pubkey);
+      next.Insert(std::move(entry));
+      return true;
+    });
   }
 
   size_t
   NodeDB::NumLoaded() const
   {
-    util::NullLock lock{m_Access};
-    return m_Entries.size();
+    return Current()->entries.size();
   }
 
   void
   NodeDB::PutIfNewer(RouterContact rc)
   {
-    util::NullLock lock{m_Access};
-    auto itr = m_Entries.find(rc.pubkey);
-    if (itr == m_Entries.end() or itr->second.rc.OtherIsNewer(rc))
-    {
-      // delete if existing
-      if (itr != m_Entries.end())
-        m_Entries.erase(itr);
-      // add new entry
-      m_Entries.emplace(rc.pubkey, rc);
-    }
+    std::vector<RouterContact> rcs;
+    rcs.emplace_back(std::move(rc));
+    PutManyIfNewer(std::move(rcs));
   }
 
   void
-  NodeDB::AsyncRemoveManyFromDisk(std::unordered_set<RouterID> remove) const
+  NodeDB::PutManyIfNewer(std::vector<RouterContact> rcs)
   {
-    // build file list
-    std::set<fs::path> files;
-    for (auto id : remove)
+    // check against the published snapshot first so stale rcs do not cost a copy
+    std::vector<Entry_ptr> entries;
     {
-      files.emplace(GetPathForPubkey(std::move(id)));
+      const auto snapshot = Current();
+      for (auto& rc : rcs)
+      {
+        const auto* existing = snapshot->Find(rc.pubkey);
+        if (existing and not existing->rc.OtherIsNewer(rc))
+          continue;
+        entries.emplace_back(std::make_shared<Entry>(std::move(rc)));
+      }
     }
-    // remove them from the disk via the diskio thread
-    disk([files]() {
-      for (auto fpath : files)
-        fs::remove(fpath);
+    if (entries.empty())
+      return;
+    Update([this, &entries](Snapshot& next) {
+      bool changed = false;
+      for (auto& entry : entries)
+      {
+        const auto* existing = next.Find(entry->rc.pubkey);
+        if (existing and not existing->rc.OtherIsNewer(entry->rc))
+          continue;
+        m_Dirty.insert(entry->rc.pubkey);
+        next.Insert(std::move(entry));
+        changed = true;
+      }
+      return changed;
     });
   }
 
   llarp::RouterContact
   NodeDB::FindClosestTo(llarp::dht::Key_t location) const
   {
-    util::NullLock lock{m_Access};
-    llarp::RouterContact rc;
-    const llarp::dht::XorMetric compare(location);
-    VisitAll([&rc, compare](const auto& otherRC) {
-      if (rc.pubkey.IsZero())
-      {
-        rc = otherRC;
-        return;
-      }
-      if (compare(
-              llarp::dht::Key_t{otherRC.pubkey.as_array()},
-              llarp::dht::Key_t{rc.pubkey.as_array()}))
-        rc = otherRC;
-    });
-    return rc;
+    const auto snapshot = Current();
+    const auto closest = snapshot->byLocation.FindClosest(location, 1);
+    if (closest.empty())
+      return {};
+    return closest[0].second->rc;
   }
 
   std::vector<RouterContact>
   NodeDB::FindManyClosestTo(llarp::dht::Key_t location, uint32_t numRouters) const
   {
-    util::NullLock lock{m_Access};
-    std::vector<const RouterContact*> all;
-
-    const auto& entries = m_Entries;
-
-    all.reserve(entries.size());
-    for (auto& entry : entries)
-    {
-      all.push_back(&entry.second.rc);
-    }
-
-    auto it_mid = numRouters < all.size() ? all.begin() + numRouters : all.end();
-    std::partial_sort(
-        all.begin(), it_mid, all.end(), [compare = dht::XorMetric{location}](auto* a, auto* b) {
-          return compare(*a, *b);
-        });
-
+    const auto snapshot = Current();
     std::vector<RouterContact> closest;
-    closest.reserve(numRouters);
-    for (auto it = all.begin(); it != it_mid; ++it)
-      closest.push_back(**it);
-
+    closest.reserve(std::min<size_t>(numRouters, snapshot->entries.size()));
+    if (numRouters == 0)
+      return closest;
+    snapshot->byLocation.VisitClosest(
+        location, [&closest, numRouters](const dht::Key_t&, const Entry_ptr& entry) {
+          closest.push_back(entry->rc);
+          return closest.size() < numRouters;
+        });
     return closest;
   }
 }  // namespace llarp
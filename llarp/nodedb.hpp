@@ -8,6 +8,7 @@
 #include <util/thread/threading.hpp>
 #include <util/thread/annotations.hpp>
 #include <dht/key.hpp>
+#include <dht/xor_trie.hpp>
 #include <crypto/crypto.hpp>
 
 #include <set>
@@ -16,11 +17,18 @@
 #include <unordered_map>
 #include <utility>
 #include <atomic>
+#include <memory>
+#include <vector>
 
 namespace llarp
 {
   class Logic;
 
+  /// rc store readable from any thread
+  ///
+  /// readers grab an immutable snapshot with a single atomic load and never block; writers are
+  /// serialized, copy the current snapshot, change the copy and publish it. rcs live in a dense
+  /// array next to the pubkey index so picking one uniformly at random is O(1).
   class NodeDB
   {
     struct Entry
@@ -29,36 +37,132 @@ namespace llarp
       llarp_time_t insertedAt;
       explicit Entry(RouterContact rc);
     };
-    using NodeMap = std::unordered_map<RouterID, Entry>;
+    using Entry_ptr = std::shared_ptr<const Entry>;
 
-    NodeMap m_Entries;
+    struct Snapshot
+    {
+      /// every entry in no particular order
+      std::vector<Entry_ptr> entries;
+      /// ident pubkey -> position in entries
+      std::unordered_map<RouterID, size_t> index;
+      /// the same entries keyed by dht location for closest router queries
+      dht::XorTrie<Entry_ptr> byLocation;
+
+      const Entry*
+      Find(const RouterID& pk) const;
+
+      /// add or replace the entry for this rc's pubkey
+      void
+      Insert(Entry_ptr entry);
+
+      /// swap remove the entry for pk, returns false if we did not have it
+      bool
+      Erase(const RouterID& pk);
+
+      /// drop every entry matching pred, returns the pubkeys that were dropped
+      template <typename Pred>
+      std::unordered_set<RouterID>
+      EraseIf(Pred pred)
+      {
+        std::unordered_set<RouterID> removed;
+        size_t idx = 0;
+        while (idx < entries.size())
+        {
+          if (pred(*entries[idx]))
+          {
+            const RouterID pk = entries[idx]->rc.pubkey;
+            removed.insert(pk);
+            // the last entry is swapped into idx so do not advance
+            Erase(pk);
+          }
+          else
+            ++idx;
+        }
+        return removed;
+      }
+    };
+    using Snapshot_ptr = std::shared_ptr<const Snapshot>;
+
+    /// only ever read or replaced with std::atomic_load / std::atomic_store
+    Snapshot_ptr m_Snapshot;
 
     const fs::path m_Root;
 
     const std::function<void(std::function<void()>)> disk;
 
+    /// runs cpu heavy jobs on the worker threads, everything runs on the calling thread if unset
+    const std::function<void(std::function<void()>)> work;
+
     llarp_time_t m_NextFlushAt;
 
-    mutable util::NullMutex m_Access;
+    /// serializes writers, readers never take it
+    util::Mutex m_WriteAccess;
+
+    /// routers put or removed since the last flush, only touched with m_WriteAccess held
+    std::unordered_set<RouterID> m_Dirty;
+
+    /// serializes everything that reads or writes the snapshot file, the flushes on the disk
+    /// thread as well as the synchronous load and save
+    mutable util::Mutex m_FileAccess;
+
+    /// records in the snapshot file including superseded ones, decides when to compact it
+    mutable size_t m_FileRecords GUARDED_BY(m_FileAccess) = 0;
+
+    Snapshot_ptr
+    Current() const
+    {
+      return std::atomic_load(&m_Snapshot);
+    }
 
-    /// asynchronously remove the files for a set of rcs on disk given their public ident key
+    /// copy the current snapshot, let mutate change it and publish it if mutate returns true
+    /// the copy is O(n) in the size of the db, so change as much as possible in one go
+    template <typename Mutate>
     void
-    AsyncRemoveManyFromDisk(std::unordered_set<RouterID> idents) const;
+    Update(Mutate mutate) EXCLUDES(m_WriteAccess)
+    {
+      util::Lock lock{m_WriteAccess};
+      auto next = std::make_shared<Snapshot>(*Current());
+      if (mutate(*next))
+        std::atomic_store(&m_Snapshot, Snapshot_ptr{std::move(next)});
+    }
 
-    /// get filename of an RC file given its public ident key
     fs::path
-    GetPathForPubkey(RouterID pk) const;
+    GetSnapshotPath() const;
+
+    /// load the snapshot file, returns false if there is none or it is not usable
+    bool
+    LoadSnapshotFile() REQUIRES(m_FileAccess);
+
+    /// import rcs from one file per router in the skiplist directories, returns the files it
+    /// found so they can go once the snapshot file has them
+    std::vector<fs::path>
+    LoadDirectory();
+
+    /// atomically replace the snapshot file with every entry in snapshot
+    bool
+    WriteSnapshotFile(const Snapshot& snapshot) const REQUIRES(m_FileAccess);
+
+    /// append records for the changed routers to the snapshot file, or rewrite it if it has
+    /// collected too many superseded records
+    void
+    AppendSnapshotFile(const Snapshot& snapshot, const std::unordered_set<RouterID>& changed) const
+        REQUIRES(m_FileAccess);
 
    public:
-    explicit NodeDB(fs::path rootdir, std::function<void(std::function<void()>)> diskCaller);
+    explicit NodeDB(
+        fs::path rootdir,
+        std::function<void(std::function<void()>)> diskCaller,
+        std::function<void(std::function<void()>)> workCaller = nullptr);
 
     /// load all entries from disk syncrhonously
+    /// reads the snapshot file if there is one, otherwise imports the skiplist directories and
+    /// removes the imported files once they are in a new snapshot file
     void
-    LoadFromDisk();
+    LoadFromDisk() EXCLUDES(m_FileAccess);
 
     /// explicit save all RCs to disk synchronously
     void
-    SaveToDisk() const;
+    SaveToDisk() const EXCLUDES(m_FileAccess);
 
     /// the number of RCs that are loaded from disk
     size_t
@@ -84,26 +188,30 @@ namespace llarp
     std::optional<RouterContact>
     Get(RouterID pk) const;
 
+    /// pick a random rc that passes visit
+    /// a few uniform picks are tried first, then we scan the rest starting at a random spot
     template <typename Filter>
     std::optional<RouterContact>
     GetRandom(Filter visit) const
     {
-      util::NullLock lock{m_Access};
-      const auto sz = m_Entries.size();
+      const auto snapshot = Current();
+      const auto& entries = snapshot->entries;
+      const auto sz = entries.size();
       if (sz < 3)
         return std::nullopt;
-      const auto begin = m_Entries.begin();
-      const auto middle = std::next(m_Entries.begin(), randint() % sz);
-
-      for (auto itr = middle; itr != m_Entries.end(); ++itr)
+      constexpr size_t NumUniformPicks = 8;
+      for (size_t attempt = 0; attempt < NumUniformPicks; ++attempt)
       {
-        if (visit(itr->second.rc))
-          return itr->second.rc;
+        const auto& rc = entries[randint() % sz]->rc;
+        if (visit(rc))
+          return rc;
       }
-      for (auto itr = begin; itr != middle; ++itr)
+      const auto start = randint() % sz;
+      for (size_t n = 0; n < sz; ++n)
       {
-        if (visit(itr->second.rc))
-          return itr->second.rc;
+        const auto& rc = entries[(start + n) % sz]->rc;
+        if (visit(rc))
+          return rc;
       }
       return std::nullopt;
     }
@@ -113,10 +221,10 @@ namespace llarp
     void
     VisitAll(Visit visit) const
     {
-      util::NullLock lock{m_Access};
-      for (const auto& item : m_Entries)
+      const auto snapshot = Current();
+      for (const auto& entry : snapshot->entries)
       {
-        visit(item.second.rc);
+        visit(entry->rc);
       }
     }
 
@@ -125,11 +233,11 @@ namespace llarp
     void
     VisitInsertedBefore(Visit visit, llarp_time_t insertedBefore)
     {
-      util::NullLock lock{m_Access};
-      for (const auto& item : m_Entries)
+      const auto snapshot = Current();
+      for (const auto& entry : snapshot->entries)
       {
-        if (item.second.insertedAt < insertedBefore)
-          visit(item.second.rc);
+        if (entry->insertedAt < insertedBefore)
+          visit(entry->rc);
       }
     }
 
@@ -142,21 +250,11 @@ namespace llarp
     void
     RemoveIf(Filter visit)
     {
-      util::NullLock lock{m_Access};
-      std::unordered_set<RouterID> removed;
-      auto itr = m_Entries.begin();
-      while (itr != m_Entries.end())
-      {
-        if (visit(itr->second.rc))
-        {
-          removed.insert(itr->second.rc.pubkey);
-          itr = m_Entries.erase(itr);
-        }
-        else
-          ++itr;
-      }
-      if (not removed.empty())
-        AsyncRemoveManyFromDisk(std::move(removed));
+      Update([&](Snapshot& next) {
+        const auto removed = next.EraseIf([&](const Entry& entry) { return visit(entry.rc); });
+        m_Dirty.insert(removed.begin(), removed.end());
+        return not removed.empty();
+      });
     }
 
     /// remove rcs that are not in keep and have been inserted before cutoff
@@ -167,6 +265,10 @@ namespace llarp
     void
     PutIfNewer(RouterContact rc);
 
+    /// PutIfNewer for many rcs, publishing a single new snapshot for all of them
+    void
+    PutManyIfNewer(std::vector<RouterContact> rcs);
+
     /// unconditional put of rc into cache
     void
     Put(RouterContact rc);
@@ -6,36 +6,44 @@ namespace llarp
   {
     // handle data in upstream direction
     bool
-    IHopHandler::HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter*)
+    IHopHandler::HandleUpstream(RelayPayload_t X, const TunnelNonce& Y, AbstractRouter*)
     {
       if (not m_UpstreamReplayFilter.Insert(Y))
         return false;
       if (m_UpstreamQueue == nullptr)
         m_UpstreamQueue = std::make_shared<TrafficQueue_t>();
-      m_UpstreamQueue->emplace_back();
-      auto& pkt = m_UpstreamQueue->back();
-      pkt.first.resize(X.sz);
-      std::copy_n(X.base, X.sz, pkt.first.begin());
-      pkt.second = Y;
+      m_UpstreamQueue->emplace_back(std::move(X), Y);
       return true;
     }
 
     // handle data in downstream direction
     bool
-    IHopHandler::HandleDownstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter*)
+    IHopHandler::HandleDownstream(RelayPayload_t X, const TunnelNonce& Y, AbstractRouter*)
     {
       if (not m_DownstreamReplayFilter.Insert(Y))
         return false;
       if (m_DownstreamQueue == nullptr)
         m_DownstreamQueue = std::make_shared<TrafficQueue_t>();
-      m_DownstreamQueue->emplace_back();
-      auto& pkt = m_DownstreamQueue->back();
-      pkt.first.resize(X.sz);
-      std::copy_n(X.base, X.sz, pkt.first.begin());
-      pkt.second = Y;
+      m_DownstreamQueue->emplace_back(std::move(X), Y);
       return true;
     }
 
+    bool
+    IHopHandler::HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter* r)
+    {
+      if (X.sz > RelayPayload_t::MaxSize)
+        return false;
+      return HandleUpstream(RelayPayload_t{X.base, X.sz}, Y, r);
+    }
+
+    bool
+    IHopHandler::HandleDownstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter* r)
+    {
+      if (X.sz > RelayPayload_t::MaxSize)
+        return false;
+      return HandleDownstream(RelayPayload_t{X.base, X.sz}, Y, r);
+    }
+
     void
     IHopHandler::DecayFilters(llarp_time_t now)
     {
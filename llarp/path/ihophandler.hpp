@@ -4,7 +4,7 @@
 #include <crypto/types.hpp>
 #include <util/types.hpp>
 #include <crypto/encrypted_frame.hpp>
-#include <util/decaying_hashset.hpp>
+#include <util/replay_filter.hpp>
 #include <messages/relay.hpp>
 #include <vector>
 
@@ -25,7 +25,7 @@ namespace llarp
   {
     struct IHopHandler
     {
-      using TrafficEvent_t = std::pair<std::vector<byte_t>, TunnelNonce>;
+      using TrafficEvent_t = std::pair<RelayPayload_t, TunnelNonce>;
       using TrafficQueue_t = std::list<TrafficEvent_t>;
       using TrafficQueue_ptr = std::shared_ptr<TrafficQueue_t>;
 
@@ -45,10 +45,17 @@ namespace llarp
       SendRoutingMessage(const routing::IMessage& msg, AbstractRouter* r) = 0;
 
       // handle data in upstream direction
-      virtual bool
-      HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter*);
+      bool
+      HandleUpstream(RelayPayload_t X, const TunnelNonce& Y, AbstractRouter*);
       // handle data in downstream direction
-      virtual bool
+      bool
+      HandleDownstream(RelayPayload_t X, const TunnelNonce& Y, AbstractRouter*);
+
+      /// handle data in upstream direction, copies X into a relay payload
+      bool
+      HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter*);
+      /// handle data in downstream direction, copies X into a relay payload
+      bool
       HandleDownstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter*);
 
       /// return timestamp last remote activity happened at
@@ -74,8 +81,8 @@ namespace llarp
       uint64_t m_SequenceNum = 0;
       TrafficQueue_ptr m_UpstreamQueue;
       TrafficQueue_ptr m_DownstreamQueue;
-      util::DecayingHashSet<TunnelNonce> m_UpstreamReplayFilter;
-      util::DecayingHashSet<TunnelNonce> m_DownstreamReplayFilter;
+      util::NonceReplayFilter<TunnelNonce> m_UpstreamReplayFilter;
+      util::NonceReplayFilter<TunnelNonce> m_DownstreamReplayFilter;
 
       virtual void
       UpstreamWork(TrafficQueue_ptr queue, AbstractRouter* r) = 0;
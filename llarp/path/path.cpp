@@ -15,6 +15,7 @@
 #include <util/buffer.hpp>
 #include <util/endian.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <tooling/path_event.hpp>
 
 #include <deque>
@@ -423,18 +424,25 @@ namespace llarp
     Path::UpstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
     {
       std::vector<RelayUpstreamMessage> sendmsgs(msgs->size());
+      std::vector<SharedSecret> keys;
+      keys.reserve(hops.size());
+      for (const auto& hop : hops)
+        keys.emplace_back(hop.shared);
+      std::vector<TunnelNonce> nonces(hops.size());
       size_t idx = 0;
       for (auto& ev : *msgs)
       {
+        ev.first.detach();
         const llarp_buffer_t buf(ev.first);
         TunnelNonce n = ev.second;
-        for (const auto& hop : hops)
+        for (size_t hop = 0; hop < hops.size(); ++hop)
         {
-          CryptoManager::instance()->xchacha20(buf, hop.shared, n);
-          n ^= hop.nonceXOR;
+          nonces[hop] = n;
+          n ^= hops[hop].nonceXOR;
         }
+        CryptoManager::instance()->xchacha20_multi(buf, keys.data(), nonces.data(), keys.size());
         auto& msg = sendmsgs[idx];
-        msg.X = buf;
+        msg.X = std::move(ev.first);
         msg.Y = ev.second;
         msg.pathid = TXID();
         ++idx;
@@ -451,7 +459,9 @@ namespace llarp
       {
         TrafficQueue_ptr data = nullptr;
         std::swap(m_UpstreamQueue, data);
-        r->QueueWork(
+        r->QueueCryptoWork(
+            thread::WorkLane::Bulk,
+            PathID_t::Hash{}(TXID()),
             [self = shared_from_this(), data, r]() { self->UpstreamWork(std::move(data), r); });
       }
     }
@@ -463,7 +473,9 @@ namespace llarp
       {
         TrafficQueue_ptr data = nullptr;
         std::swap(m_DownstreamQueue, data);
-        r->QueueWork(
+        r->QueueCryptoWork(
+            thread::WorkLane::Bulk,
+            PathID_t::Hash{}(TXID()),
             [self = shared_from_this(), data, r]() { self->DownstreamWork(std::move(data), r); });
       }
     }
@@ -496,17 +508,24 @@ namespace llarp
     Path::DownstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
     {
       std::vector<RelayDownstreamMessage> sendMsgs(msgs->size());
+      std::vector<SharedSecret> keys;
+      keys.reserve(hops.size());
+      for (const auto& hop : hops)
+        keys.emplace_back(hop.shared);
+      std::vector<TunnelNonce> nonces(hops.size());
       size_t idx = 0;
       for (auto& ev : *msgs)
       {
+        ev.first.detach();
         const llarp_buffer_t buf(ev.first);
         sendMsgs[idx].Y = ev.second;
-        for (const auto& hop : hops)
+        for (size_t hop = 0; hop < hops.size(); ++hop)
         {
-          sendMsgs[idx].Y ^= hop.nonceXOR;
-          CryptoManager::instance()->xchacha20(buf, hop.shared, sendMsgs[idx].Y);
+          sendMsgs[idx].Y ^= hops[hop].nonceXOR;
+          nonces[hop] = sendMsgs[idx].Y;
         }
-        sendMsgs[idx].X = buf;
+        CryptoManager::instance()->xchacha20_multi(buf, keys.data(), nonces.data(), keys.size());
+        sendMsgs[idx].X = std::move(ev.first);
         ++idx;
       }
       LogicCall(r->logic(), [self = shared_from_this(), msgs = std::move(sendMsgs), r]() {
@@ -8,6 +8,7 @@
 #include <router/abstractrouter.hpp>
 #include <util/buffer.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <tooling/path_event.hpp>
 
 #include <functional>
@@ -373,7 +374,9 @@ namespace llarp
       ctx->AsyncGenerateKeys(
           path,
           m_router->logic(),
-          [r = m_router](auto func) { r->QueueWork(std::move(func)); },
+          [r = m_router, affinity = reinterpret_cast<uintptr_t>(path.get())](auto func) {
+            r->QueueCryptoWork(thread::WorkLane::Handshake, affinity, std::move(func));
+          },
           &PathBuilderKeysGenerated);
     }
 
@@ -85,6 +85,7 @@ namespace llarp
         if (itr->second->Expired(now))
         {
           router->outboundMessageHandler().QueueRemoveEmptyPath(itr->second->TXID());
+          m_PathsByIntro.erase(itr->second->intro.pathID);
           itr = m_Paths.erase(itr);
         }
         else
@@ -205,6 +206,16 @@ namespace llarp
       return nullptr;
     }
 
+    Path_ptr
+    PathSet::GetPathByIntro(const service::Introduction& intro) const
+    {
+      Lock_t l(m_PathsMutex);
+      auto itr = m_PathsByIntro.find(intro.pathID);
+      if (itr == m_PathsByIntro.end() or itr->second->intro != intro)
+        return nullptr;
+      return itr->second;
+    }
+
     Path_ptr
     PathSet::GetPathByID(PathID_t id) const
     {
@@ -263,7 +274,9 @@ namespace llarp
             upstream,
             " rxid=",
             RXID);
+        return;
       }
+      m_PathsByIntro.emplace(path->intro.pathID, path);
     }
 
     Path_ptr
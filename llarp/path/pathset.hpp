@@ -242,6 +242,10 @@ namespace llarp
       Path_ptr
       GetByEndpointWithID(RouterID router, PathID_t id) const;
 
+      /// the path of ours an intro leads to, if we still have it
+      Path_ptr
+      GetPathByIntro(const service::Introduction& intro) const;
+
       bool
       GetCurrentIntroductionsWithFilter(
           std::set<service::Introduction>& intros,
@@ -320,6 +324,8 @@ namespace llarp
       using PathMap_t = std::unordered_map<PathInfo_t, Path_ptr, PathInfoHash, PathInfoEquals>;
       mutable Mtx_t m_PathsMutex;
       PathMap_t m_Paths;
+      /// m_Paths by the path id of their intro
+      std::unordered_map<PathID_t, Path_ptr, PathID_t::Hash> m_PathsByIntro;
     };
 
   }  // namespace path
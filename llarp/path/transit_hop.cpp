@@ -126,18 +126,19 @@ namespace llarp
           auto maybe = self->m_DownstreamGather.tryPopFront();
           if (not maybe)
             break;
-          msgs.emplace_back(*maybe);
+          msgs.emplace_back(std::move(*maybe));
         } while (true);
         self->HandleAllDownstream(std::move(msgs), r);
       };
       for (auto& ev : *msgs)
       {
         RelayDownstreamMessage msg;
+        ev.first.detach();
         const llarp_buffer_t buf(ev.first);
         msg.pathid = info.rxID;
         msg.Y = ev.second ^ nonceXOR;
         CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
-        msg.X = buf;
+        msg.X = std::move(ev.first);
         llarp::LogDebug(
             "relay ",
             msg.X.size(),
@@ -150,7 +151,7 @@ namespace llarp
           LogicCall(r->logic(), flushIt);
         }
         if (m_DownstreamGather.enabled())
-          m_DownstreamGather.pushBack(msg);
+          m_DownstreamGather.pushBack(std::move(msg));
       }
       LogicCall(r->logic(), flushIt);
     }
@@ -165,24 +166,25 @@ namespace llarp
           auto maybe = self->m_UpstreamGather.tryPopFront();
           if (not maybe)
             break;
-          msgs.emplace_back(*maybe);
+          msgs.emplace_back(std::move(*maybe));
         } while (true);
         self->HandleAllUpstream(std::move(msgs), r);
       };
       for (auto& ev : *msgs)
       {
+        ev.first.detach();
         const llarp_buffer_t buf(ev.first);
         RelayUpstreamMessage msg;
         CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
         msg.pathid = info.txID;
         msg.Y = ev.second ^ nonceXOR;
-        msg.X = buf;
+        msg.X = std::move(ev.first);
         if (m_UpstreamGather.full())
         {
           LogicCall(r->logic(), flushIt);
         }
         if (m_UpstreamGather.enabled())
-          m_UpstreamGather.pushBack(msg);
+          m_UpstreamGather.pushBack(std::move(msg));
       }
       LogicCall(r->logic(), flushIt);
     }
@@ -247,9 +249,10 @@ namespace llarp
     {
       if (m_UpstreamQueue && not m_UpstreamQueue->empty())
       {
-        r->QueueWork([self = shared_from_this(), data = std::move(m_UpstreamQueue), r]() mutable {
-          self->UpstreamWork(std::move(data), r);
-        });
+        r->QueueTransitWork(
+            info.txID, [self = shared_from_this(), data = std::move(m_UpstreamQueue), r]() mutable {
+              self->UpstreamWork(std::move(data), r);
+            });
       }
       m_UpstreamQueue = nullptr;
     }
@@ -259,9 +262,10 @@ namespace llarp
     {
       if (m_DownstreamQueue && not m_DownstreamQueue->empty())
       {
-        r->QueueWork([self = shared_from_this(), data = std::move(m_DownstreamQueue), r]() mutable {
-          self->DownstreamWork(std::move(data), r);
-        });
+        r->QueueTransitWork(
+            info.txID, [self = shared_from_this(), data = std::move(m_DownstreamQueue), r]() mutable {
+              self->DownstreamWork(std::move(data), r);
+            });
       }
       m_DownstreamQueue = nullptr;
     }
@@ -43,6 +43,12 @@ namespace llarp
   struct ILinkManager;
   struct I_RCLookupHandler;
   struct RoutePoker;
+  class SignatureVerifier;
+
+  namespace thread
+  {
+    enum class WorkLane;
+  }
 
   namespace exit
   {
@@ -140,9 +146,19 @@ namespace llarp
     /// call function in crypto worker
     virtual void QueueWork(std::function<void(void)>) = 0;
 
+    /// call function in crypto worker on a lane, functions with the same affinity tend to run on
+    /// the same worker
+    virtual void
+    QueueCryptoWork(thread::WorkLane lane, uint64_t affinity, std::function<void(void)> func) = 0;
+
     /// call function in disk io thread
     virtual void QueueDiskIO(std::function<void(void)>) = 0;
 
+    /// call function on the transit shard that owns path id, in order with other work for that
+    /// path; runs in a crypto worker when transit sharding is off
+    virtual void
+    QueueTransitWork(const PathID_t&, std::function<void(void)>) = 0;
+
     virtual std::shared_ptr<Config>
     GetConfig() const
     {
@@ -170,6 +186,9 @@ namespace llarp
     virtual I_RCLookupHandler&
     rcLookupHandler() = 0;
 
+    virtual SignatureVerifier&
+    signatureVerifier() = 0;
+
     virtual std::shared_ptr<PeerDb>
     peerDb() = 0;
 
@@ -25,8 +25,18 @@ namespace llarp
   using SendStatusHandler = std::function<void(SendStatus)>;
 
   static const size_t MAX_PATH_QUEUE_SIZE = 100;
+  /// non-routing messages waiting to go out, only drained by a share of each tick so it needs a
+  /// cap of its own
+  static const size_t MAX_CONTROL_QUEUE_SIZE = 1000;
   static const size_t MAX_OUTBOUND_QUEUE_SIZE = 1000;
   static const size_t MAX_OUTBOUND_MESSAGES_PER_TICK = 500;
+  static const size_t MAX_OUTBOUND_BYTES_PER_TICK = 512 * 1024;
+  /// bytes each path may send per round robin pass
+  static const size_t OUTBOUND_PATH_QUANTUM = 2048;
+  /// control messages get at most 1/N of a tick's bytes while paths have traffic waiting
+  static const size_t OUTBOUND_CONTROL_SHARE = 4;
+  /// hold back path traffic for a router once its link session has this many messages waiting
+  static const size_t MAX_SESSION_BACKLOG = 512;
 
   struct IOutboundMessageHandler
   {
@@ -4,6 +4,7 @@
 #include <util/types.hpp>
 #include <router_id.hpp>
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <vector>
@@ -45,6 +46,13 @@ namespace llarp
     virtual bool
     CheckRC(const RouterContact& rc) const = 0;
 
+    /// check a batch of rcs like CheckRC but with the signatures checked off the logic thread,
+    /// hook is called on the logic thread with the rcs that passed
+    virtual void
+    CheckRCs(
+        std::vector<RouterContact> rcs,
+        std::function<void(std::vector<RouterContact>)> hook) const = 0;
+
     virtual bool
     GetRandomWhitelistRouter(RouterID& router) const = 0;
 
@@ -30,19 +30,17 @@ namespace llarp
     }
 
     const uint16_t priority = msg->Priority();
-    std::array<byte_t, MAX_LINK_MSG_SIZE> linkmsg_buffer;
-    llarp_buffer_t buf(linkmsg_buffer);
+    // encode straight into the pooled buffer the link session will send from, the encoder
+    // writes every byte we keep so there is nothing to zero
+    Message message{ILinkSession::Message_t{}, std::move(callback)};
+    message.first.resize_for_overwrite(MAX_LINK_MSG_SIZE);
+    llarp_buffer_t buf(message.first);
 
     if (!EncodeBuffer(msg, buf))
     {
       return false;
     }
-
-    Message message;
     message.first.resize(buf.sz);
-    message.second = callback;
-
-    std::copy_n(buf.base, buf.sz, message.first.data());
 
     if (_linkManager->HasSessionTo(remote))
     {
@@ -59,9 +57,9 @@ namespace llarp
 
       MessageQueueEntry entry;
       entry.priority = priority;
-      entry.message = message;
+      entry.message = std::move(message);
       entry.router = remote;
-      itr_pair.first->second.push(std::move(entry));
+      itr_pair.first->second.Push(priority, std::move(entry));
 
       shouldCreateSession = itr_pair.second;
     }
@@ -96,21 +94,51 @@ namespace llarp
     });
   }
 
-  // TODO: this
   util::StatusObject
   OutboundMessageHandler::ExtractStatus() const
   {
-    util::StatusObject status{"queueStats",
-                              {{"queued", m_queueStats.queued},
-                               {"dropped", m_queueStats.dropped},
-                               {"sent", m_queueStats.sent},
-                               {"queueWatermark", m_queueStats.queueWatermark},
-                               {"perTickMax", m_queueStats.perTickMax},
-                               {"numTicks", m_queueStats.numTicks}}};
+    util::StatusObject paths{};
+    for (const auto& [pathid, queue] : outboundMessageQueues)
+    {
+      paths[pathid.IsZero() ? "control" : pathid.ToHex()] =
+          util::StatusObject{{"queued", queue.messages.Size()},
+                             {"deficit", queue.deficit},
+                             {"delay", queue.delays.ExtractStatus()}};
+    }
+    util::StatusObject status{{"queueStats",
+                               {{"queued", m_queueStats.queued},
+                                {"dropped", m_queueStats.dropped},
+                                {"sent", m_queueStats.sent},
+                                {"queueWatermark", m_queueStats.queueWatermark},
+                                {"perTickMax", m_queueStats.perTickMax},
+                                {"numTicks", m_queueStats.numTicks}}},
+                              {"paths", paths}};
 
     return status;
   }
 
+  void
+  OutboundMessageHandler::QueueDelayHistogram::Record(llarp_time_t delay)
+  {
+    size_t idx = 0;
+    while (idx + 1 < NumBuckets and delay >= llarp_time_t{int64_t{1} << idx})
+      idx++;
+    buckets[idx]++;
+  }
+
+  util::StatusObject
+  OutboundMessageHandler::QueueDelayHistogram::ExtractStatus() const
+  {
+    util::StatusObject obj{};
+    for (size_t idx = 0; idx < NumBuckets; ++idx)
+    {
+      const auto key = idx + 1 < NumBuckets ? "<" + std::to_string(1 << idx) + "ms"
+                                            : ">=" + std::to_string(1 << (idx - 1)) + "ms";
+      obj[key] = buckets[idx];
+    }
+    return obj;
+  }
+
   void
   OutboundMessageHandler::Init(
       ILinkManager* linkManager, I_RCLookupHandler* lookupHandler, std::shared_ptr<Logic> logic)
@@ -119,7 +147,7 @@ namespace llarp
     _lookupHandler = lookupHandler;
     _logic = logic;
 
-    outboundMessageQueues.emplace(zeroID, MessageQueue());
+    outboundMessageQueues.emplace(zeroID, PathQueue());
   }
 
   void
@@ -212,27 +240,32 @@ namespace llarp
   }
 
   bool
-  OutboundMessageHandler::Send(const RouterID& remote, const Message& msg)
+  OutboundMessageHandler::Send(const RouterID& remote, Message msg)
   {
-    const llarp_buffer_t buf(msg.first);
-    auto callback = msg.second;
     m_queueStats.sent++;
-    return _linkManager->SendTo(remote, buf, [=](ILinkSession::DeliveryStatus status) {
-      if (status == ILinkSession::DeliveryStatus::eDeliverySuccess)
-        DoCallback(callback, SendStatus::Success);
-      else
-      {
-        DoCallback(callback, SendStatus::Congestion);
-      }
-    });
+    ILinkSession::CompletionHandler completed;
+    // relayed traffic has no callback, don't wrap one around nothing
+    if (msg.second)
+    {
+      completed = [self = this, callback = std::move(msg.second)](
+                      ILinkSession::DeliveryStatus status) {
+        if (status == ILinkSession::DeliveryStatus::eDeliverySuccess)
+          self->DoCallback(callback, SendStatus::Success);
+        else
+        {
+          self->DoCallback(callback, SendStatus::Congestion);
+        }
+      };
+    }
+    return _linkManager->SendTo(remote, std::move(msg.first), std::move(completed));
   }
 
   bool
-  OutboundMessageHandler::SendIfSession(const RouterID& remote, const Message& msg)
+  OutboundMessageHandler::SendIfSession(const RouterID& remote, Message msg)
   {
     if (_linkManager->HasSessionTo(remote))
     {
-      return Send(remote, msg);
+      return Send(remote, std::move(msg));
     }
     return false;
   }
@@ -243,10 +276,11 @@ namespace llarp
   {
     MessageQueueEntry entry;
     entry.message = std::move(msg);
-    auto callback_copy = entry.message.second;
     entry.router = remote;
     entry.pathid = pathid;
     entry.priority = priority;
+    entry.queuedAt = time_now_ms();
+    // only moved from if the push succeeds
     if (outboundQueue.tryPushBack(std::move(entry)) != llarp::thread::QueueReturn::Success)
     {
       m_queueStats.dropped++;
@@ -254,7 +288,7 @@ namespace llarp
           "QueueOutboundMessage outbound message handler dropped message on "
           "pathid=",
           pathid);
-      DoCallback(callback_copy, SendStatus::Congestion);
+      DoCallback(entry.message.second, SendStatus::Congestion);
     }
     else
     {
@@ -275,18 +309,20 @@ namespace llarp
       // TODO: can we add util::thread::Queue::front() for move semantics here?
       MessageQueueEntry entry = outboundQueue.popFront();
 
-      auto itr_pair = outboundMessageQueues.emplace(entry.pathid, MessageQueue());
+      auto itr_pair = outboundMessageQueues.emplace(entry.pathid, PathQueue());
 
       if (itr_pair.second && !entry.pathid.IsZero())
       {
         roundRobinOrder.push(entry.pathid);
       }
 
-      MessageQueue& path_queue = itr_pair.first->second;
+      MessageQueue& path_queue = itr_pair.first->second.messages;
 
-      if (path_queue.size() < MAX_PATH_QUEUE_SIZE || entry.pathid.IsZero())
+      const size_t max_size = entry.pathid.IsZero() ? MAX_CONTROL_QUEUE_SIZE : MAX_PATH_QUEUE_SIZE;
+      if (path_queue.Size() < max_size)
       {
-        path_queue.push(std::move(entry));
+        const auto priority = entry.priority;
+        path_queue.Push(priority, std::move(entry));
       }
       else
       {
@@ -322,17 +358,16 @@ namespace llarp
   OutboundMessageHandler::SendRoundRobin()
   {
     m_queueStats.numTicks++;
+    sessionRoom.clear();
 
-    // send non-routing messages first priority
-    auto& non_routing_mq = outboundMessageQueues[zeroID];
-    while (not non_routing_mq.empty())
-    {
-      const MessageQueueEntry& entry = non_routing_mq.top();
-      Send(entry.router, entry.message);
-      non_routing_mq.pop();
-    }
+    const auto now = time_now_ms();
+    size_t budget = MAX_OUTBOUND_BYTES_PER_TICK;
+    size_t sent_count = 0;
+
+    // non-routing messages go first but only get a share of the tick, a burst of them must not
+    // stall path traffic
+    budget -= SendControl(budget / OUTBOUND_CONTROL_SHARE, now, sent_count);
 
-    size_t empty_count = 0;
     size_t num_queues = roundRobinOrder.size();
 
     if (removedSomePaths)
@@ -350,45 +385,93 @@ namespace llarp
     }
 
     num_queues = roundRobinOrder.size();
-    size_t sent_count = 0;
-    if (num_queues == 0)  // if no queues, return
-    {
-      return;
-    }
 
-    while (sent_count < MAX_OUTBOUND_MESSAGES_PER_TICK)  // TODO: better stop condition
+    // deficit round robin: each pass a path earns a quantum of bytes and sends messages as long
+    // as it has the bytes for them, so paths share the link by bytes sent and not by messages.
+    // a path is stalled when it is empty, its next hop's session is backed up or the tick is out
+    // of bytes for its next message, once every path is stalled in a row we are done.
+    size_t stalled_count = 0;
+    while (num_queues > 0 and stalled_count < num_queues
+           and sent_count < MAX_OUTBOUND_MESSAGES_PER_TICK)
     {
       PathID_t pathid = std::move(roundRobinOrder.front());
       roundRobinOrder.pop();
 
-      auto& message_queue = outboundMessageQueues[pathid];
-      if (message_queue.size() > 0)
+      auto& path_queue = outboundMessageQueues[pathid];
+      auto& message_queue = path_queue.messages;
+      bool stalled = true;
+      if (not message_queue.Empty())
       {
-        const MessageQueueEntry& entry = message_queue.top();
-
-        Send(entry.router, entry.message);
-        message_queue.pop();
-
-        empty_count = 0;
-        sent_count++;
-      }
-      else
-      {
-        empty_count++;
+        // enough to always cover the largest message, but no banking bytes while held back
+        path_queue.deficit = std::min(
+            path_queue.deficit + OUTBOUND_PATH_QUANTUM, MAX_LINK_MSG_SIZE + OUTBOUND_PATH_QUANTUM);
+        while (not message_queue.Empty() and sent_count < MAX_OUTBOUND_MESSAGES_PER_TICK)
+        {
+          const auto& next = message_queue.Front();
+          const auto size = next.message.first.size();
+          auto& room = SessionRoom(next.router);
+          if (size > budget or room == 0)
+            break;
+          stalled = false;
+          if (size > path_queue.deficit)
+            break;
+
+          auto entry = message_queue.Pop();
+          path_queue.deficit -= size;
+          budget -= size;
+          room--;
+          path_queue.delays.Record(now - entry.queuedAt);
+          Send(entry.router, std::move(entry.message));
+          sent_count++;
+        }
       }
+      if (message_queue.Empty())
+        path_queue.deficit = 0;
 
       roundRobinOrder.push(std::move(pathid));
 
-      // if num_queues empty queues in a row, all queues empty.
-      if (empty_count == num_queues)
-      {
-        break;
-      }
+      stalled_count = stalled ? stalled_count + 1 : 0;
     }
 
+    // paths are done with the tick, control traffic may have what they left over
+    SendControl(budget, now, sent_count);
+
     m_queueStats.perTickMax = std::max((uint32_t)sent_count, m_queueStats.perTickMax);
   }
 
+  size_t
+  OutboundMessageHandler::SendControl(size_t budget, llarp_time_t now, size_t& sent_count)
+  {
+    auto& control = outboundMessageQueues[zeroID];
+    size_t sent = 0;
+    while (not control.messages.Empty() and sent_count < MAX_OUTBOUND_MESSAGES_PER_TICK)
+    {
+      const auto size = control.messages.Front().message.first.size();
+      if (sent + size > budget)
+        break;
+      auto entry = control.messages.Pop();
+      sent += size;
+      control.delays.Record(now - entry.queuedAt);
+      Send(entry.router, std::move(entry.message));
+      sent_count++;
+    }
+    return sent;
+  }
+
+  size_t&
+  OutboundMessageHandler::SessionRoom(const RouterID& router)
+  {
+    auto itr = sessionRoom.find(router);
+    if (itr == sessionRoom.end())
+    {
+      // no session means Send fails the message right away, no point holding it back
+      const auto backlog = _linkManager->SendQueueBacklog(router).value_or(0);
+      const size_t room = backlog < MAX_SESSION_BACKLOG ? MAX_SESSION_BACKLOG - backlog : 0;
+      itr = sessionRoom.emplace(router, room).first;
+    }
+    return itr->second;
+  }
+
   void
   OutboundMessageHandler::FinalizeSessionRequest(const RouterID& router, SendStatus status)
   {
@@ -407,19 +490,18 @@ namespace llarp
       pendingSessionMessageQueues.erase(itr);
     }
 
-    while (!movedMessages.empty())
+    while (not movedMessages.Empty())
     {
-      const MessageQueueEntry& entry = movedMessages.top();
+      auto entry = movedMessages.Pop();
 
       if (status == SendStatus::Success)
       {
-        Send(entry.router, entry.message);
+        Send(entry.router, std::move(entry.message));
       }
       else
       {
         DoCallback(entry.message.second, status);
       }
-      movedMessages.pop();
     }
   }
 
@@ -3,11 +3,14 @@
 
 #include <router/i_outbound_message_handler.hpp>
 
+#include <link/session.hpp>
+#include <util/bucket_queue.hpp>
 #include <util/thread/logic.hpp>
 #include <util/thread/queue.hpp>
 #include <path/path_types.hpp>
 #include <router_id.hpp>
 
+#include <array>
 #include <list>
 #include <unordered_map>
 #include <utility>
@@ -46,20 +49,31 @@ namespace llarp
     Init(ILinkManager* linkManager, I_RCLookupHandler* lookupHandler, std::shared_ptr<Logic> logic);
 
    private:
-    using Message = std::pair<std::vector<byte_t>, SendStatusHandler>;
+    using Message = std::pair<ILinkSession::Message_t, SendStatusHandler>;
 
+    /// moved from queue to queue and finally into the link session, never copied
     struct MessageQueueEntry
     {
       uint16_t priority;
       Message message;
       PathID_t pathid;
       RouterID router;
+      llarp_time_t queuedAt = 0s;
+    };
+
+    /// how long messages waited in a path queue, in power of two buckets of milliseconds
+    struct QueueDelayHistogram
+    {
+      static constexpr size_t NumBuckets = 12;
 
-      bool
-      operator<(const MessageQueueEntry& other) const
-      {
-        return other.priority < priority;
-      }
+      /// bucket N counts delays below 2^N ms, the last one everything longer
+      std::array<uint64_t, NumBuckets> buckets{};
+
+      void
+      Record(llarp_time_t delay);
+
+      util::StatusObject
+      ExtractStatus() const;
     };
 
     struct MessageQueueStats
@@ -73,7 +87,17 @@ namespace llarp
       uint32_t numTicks = 0;
     };
 
-    using MessageQueue = std::priority_queue<MessageQueueEntry>;
+    /// lowest priority value first, in the order they were queued within a priority
+    using MessageQueue = util::BucketQueue<MessageQueueEntry>;
+
+    /// a path's messages and its place in the deficit round robin
+    struct PathQueue
+    {
+      MessageQueue messages;
+      /// bytes the path may still send this pass
+      size_t deficit = 0;
+      QueueDelayHistogram delays;
+    };
 
     void
     OnSessionEstablished(const RouterID& router);
@@ -103,10 +127,10 @@ namespace llarp
     EncodeBuffer(const ILinkMessage* msg, llarp_buffer_t& buf);
 
     bool
-    Send(const RouterID& remote, const Message& msg);
+    Send(const RouterID& remote, Message msg);
 
     bool
-    SendIfSession(const RouterID& remote, const Message& msg);
+    SendIfSession(const RouterID& remote, Message msg);
 
     bool
     QueueOutboundMessage(
@@ -121,6 +145,14 @@ namespace llarp
     void
     SendRoundRobin();
 
+    /// send control messages until budget runs out, returns bytes sent
+    size_t
+    SendControl(size_t budget, llarp_time_t now, size_t& sent_count);
+
+    /// how many more messages router's link session can take this tick
+    size_t&
+    SessionRoom(const RouterID& router);
+
     void
     FinalizeSessionRequest(const RouterID& router, SendStatus status) EXCLUDES(_mutex);
 
@@ -133,10 +165,13 @@ namespace llarp
     std::unordered_map<RouterID, MessageQueue, RouterID::Hash> pendingSessionMessageQueues
         GUARDED_BY(_mutex);
 
-    std::unordered_map<PathID_t, MessageQueue, PathID_t::Hash> outboundMessageQueues;
+    std::unordered_map<PathID_t, PathQueue, PathID_t::Hash> outboundMessageQueues;
 
     std::queue<PathID_t> roundRobinOrder;
 
+    /// messages each router's link session can still take this tick
+    std::unordered_map<RouterID, size_t, RouterID::Hash> sessionRoom;
+
     ILinkManager* _linkManager;
     I_RCLookupHandler* _lookupHandler;
     std::shared_ptr<Logic> _logic;
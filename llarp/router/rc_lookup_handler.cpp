@@ -11,7 +11,9 @@
 #include <nodedb.hpp>
 #include <dht/context.hpp>
 #include <router/abstractrouter.hpp>
+#include <router/signature_verifier.hpp>
 
+#include <algorithm>
 #include <iterator>
 #include <functional>
 #include <random>
@@ -152,16 +154,70 @@ namespace llarp
       return false;
     }
 
+    StoreRC(rc);
+    return true;
+  }
+
+  void
+  RCLookupHandler::CheckRCs(
+      std::vector<RouterContact> rcs, std::function<void(std::vector<RouterContact>)> hook) const
+  {
+    // drop the ones we would not talk to before spending any time on their signatures
+    auto itr = std::remove_if(rcs.begin(), rcs.end(), [this](const RouterContact& rc) {
+      if (RemoteIsAllowed(rc.pubkey))
+        return false;
+      _dht->impl->DelRCNodeAsync(dht::Key_t{rc.pubkey});
+      return true;
+    });
+    rcs.erase(itr, rcs.end());
+
+    _verifier->VerifyRCs(
+        std::move(rcs),
+        _dht->impl->Now(),
+        [this, hook = std::move(hook)](
+            std::vector<RouterContact> checked, std::vector<bool> valid) {
+          std::vector<RouterContact> passed;
+          passed.reserve(checked.size());
+          for (size_t idx = 0; idx < checked.size(); ++idx)
+          {
+            if (not valid[idx])
+            {
+              LogWarn("RC for ", RouterID(checked[idx].pubkey), " is invalid");
+              continue;
+            }
+            passed.emplace_back(std::move(checked[idx]));
+          }
+          StoreRCs(passed);
+          if (hook)
+            hook(std::move(passed));
+        });
+  }
+
+  void
+  RCLookupHandler::StoreRC(const RouterContact& rc) const
+  {
+    StoreRCs({rc});
+  }
+
+  void
+  RCLookupHandler::StoreRCs(const std::vector<RouterContact>& rcs) const
+  {
     // update nodedb if required
-    if (rc.IsPublicRouter())
+    std::vector<RouterContact> store;
+    for (const auto& rc : rcs)
     {
+      if (not rc.IsPublicRouter())
+        continue;
       LogDebug("Adding or updating RC for ", RouterID(rc.pubkey), " to nodedb and dht.");
-      const RouterContact copy{rc};
-      LogicCall(_logic, [copy, n = _nodedb]() { n->PutIfNewer(copy); });
+      store.emplace_back(rc);
       _dht->impl->PutRCNodeAsync(rc);
     }
-
-    return true;
+    if (store.empty())
+      return;
+    // one snapshot copy for the whole batch rather than one per rc
+    LogicCall(_logic, [store = std::move(store), n = _nodedb]() mutable {
+      n->PutManyIfNewer(std::move(store));
+    });
   }
 
   size_t
@@ -303,6 +359,7 @@ namespace llarp
       std::shared_ptr<NodeDB> nodedb,
       std::shared_ptr<Logic> logic,
       WorkerFunc_t dowork,
+      SignatureVerifier* verifier,
       ILinkManager* linkManager,
       service::Context* hiddenServiceContext,
       const std::unordered_set<RouterID>& strictConnectPubkeys,
@@ -314,6 +371,7 @@ namespace llarp
     _nodedb = nodedb;
     _logic = logic;
     _work = dowork;
+    _verifier = verifier;
     _hiddenServiceContext = hiddenServiceContext;
     _strictConnectPubkeys = strictConnectPubkeys;
     _bootstrapRCList = bootstrapRCList;
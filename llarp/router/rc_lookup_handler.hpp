@@ -17,6 +17,7 @@ namespace llarp
 {
   class NodeDB;
   class Logic;
+  class SignatureVerifier;
 
   namespace service
   {
@@ -57,6 +58,11 @@ namespace llarp
     bool
     CheckRC(const RouterContact& rc) const override;
 
+    void
+    CheckRCs(
+        std::vector<RouterContact> rcs,
+        std::function<void(std::vector<RouterContact>)> hook) const override;
+
     bool
     GetRandomWhitelistRouter(RouterID& router) const override EXCLUDES(_mutex);
 
@@ -78,6 +84,7 @@ namespace llarp
         std::shared_ptr<NodeDB> nodedb,
         std::shared_ptr<Logic> logic,
         WorkerFunc_t dowork,
+        SignatureVerifier* verifier,
         ILinkManager* linkManager,
         service::Context* hiddenServiceContext,
         const std::unordered_set<RouterID>& strictConnectPubkeys,
@@ -92,6 +99,14 @@ namespace llarp
     bool
     HavePendingLookup(RouterID remote) const EXCLUDES(_mutex);
 
+    /// put an rc that passed its checks into the nodedb and dht
+    void
+    StoreRC(const RouterContact& rc) const;
+
+    /// StoreRC for many rcs, with one nodedb update for all of them
+    void
+    StoreRCs(const std::vector<RouterContact>& rcs) const;
+
     bool
     RemoteInBootstrap(const RouterID& remote) const;
 
@@ -105,6 +120,7 @@ namespace llarp
     std::shared_ptr<NodeDB> _nodedb;
     std::shared_ptr<Logic> _logic;
     WorkerFunc_t _work = nullptr;
+    SignatureVerifier* _verifier = nullptr;
     service::Context* _hiddenServiceContext = nullptr;
     ILinkManager* _linkManager = nullptr;
 
@@ -68,6 +68,8 @@ namespace llarp
       , _randomStartDelay(std::chrono::seconds((llarp::randint() % 30) + 10))
 #endif
       , m_lokidRpcClient(std::make_shared<rpc::LokidRpcClient>(m_lmq, this))
+      , m_SigVerifier(_logic, util::memFn(&AbstractRouter::QueueWork, this))
+      , m_CryptoWorkers("crypto")
   {
     m_keyManager = std::make_shared<KeyManager>();
     // for lokid, so we don't close the connection when syncing the whitelist
@@ -80,6 +82,8 @@ namespace llarp
 
   Router::~Router()
   {
+    // jobs still running use the rest of the router
+    m_CryptoWorkers.Stop();
     llarp_dht_context_free(_dht);
   }
 
@@ -99,6 +103,8 @@ namespace llarp
                                 {"exit", _exitContext.ExtractStatus()},
                                 {"links", _linkManager.ExtractStatus()},
                                 {"outboundMessages", _outboundMessageHandler.ExtractStatus()},
+                                {"signatures", m_SigVerifier.ExtractStatus()},
+                                {"cryptoWorkers", m_CryptoWorkers.ExtractStatus()},
                                 {"peerStats", peerStatsObj}};
     }
     else
@@ -304,6 +310,10 @@ namespace llarp
 
     if (conf.router.m_workerThreads > 0)
       m_lmq->set_general_threads(conf.router.m_workerThreads);
+    m_CryptoWorkers.Start(std::max(conf.router.m_workerThreads, 0));
+
+    for (size_t idx = 0; idx < conf.router.m_transitShards; ++idx)
+      m_TransitShards.push_back(m_lmq->add_tagged_thread("transit-" + std::to_string(idx)));
 
     m_lmq->start();
 
@@ -462,6 +472,8 @@ namespace llarp
 
     // IWP config
     m_OutboundPort = conf.links.m_OutboundLink.port;
+    m_UDPBatchSize = conf.router.m_UDPBatchSize;
+    m_PMTUDiscovery = conf.router.m_PMTUDiscovery;
     // Router config
     _rc.SetNick(conf.router.m_nickname);
     _outboundSessionMaker.maxConnectedRouters = conf.router.m_maxConnectedRouters;
@@ -587,6 +599,7 @@ namespace llarp
         _nodedb,
         _logic,
         util::memFn(&AbstractRouter::QueueWork, this),
+        &m_SigVerifier,
         &_linkManager,
         &_hiddenServiceContext,
         strictConnectPubkeys,
@@ -623,11 +636,15 @@ namespace llarp
           util::memFn(&Router::ConnectionTimedOut, this),
           util::memFn(&AbstractRouter::SessionClosed, this),
           util::memFn(&AbstractRouter::PumpLL, this),
-          util::memFn(&AbstractRouter::QueueWork, this));
+          [this](uint64_t affinity, Work_t work) {
+            QueueCryptoWork(thread::WorkLane::Bulk, affinity, std::move(work));
+          });
 
       const std::string& key = serverConfig.interface;
       int af = serverConfig.addressFamily;
       uint16_t port = serverConfig.port;
+      server->SetUDPBatchSize(m_UDPBatchSize);
+      server->SetPMTUDiscovery(m_PMTUDiscovery);
       if (!server->Configure(netloop(), key, af, port))
       {
         throw std::runtime_error(stringify("failed to bind inbound link on ", key, " port ", port));
@@ -970,10 +987,7 @@ namespace llarp
   void
   Router::HandleDHTLookupForExplore(RouterID /*remote*/, const std::vector<RouterContact>& results)
   {
-    for (const auto& rc : results)
-    {
-      _rcLookupHandler.CheckRC(rc);
-    }
+    _rcLookupHandler.CheckRCs(results, nullptr);
   }
 
   // TODO: refactor callers and remove this function
@@ -1169,6 +1183,7 @@ namespace llarp
   Router::AfterStopLinks()
   {
     Close();
+    m_CryptoWorkers.Stop();
     m_lmq.reset();
   }
 
@@ -1292,7 +1307,13 @@ namespace llarp
   void
   Router::QueueWork(std::function<void(void)> func)
   {
-    m_lmq->job(std::move(func));
+    m_CryptoWorkers.Submit(thread::WorkLane::Bulk, std::move(func));
+  }
+
+  void
+  Router::QueueCryptoWork(thread::WorkLane lane, uint64_t affinity, std::function<void(void)> func)
+  {
+    m_CryptoWorkers.Submit(lane, affinity, std::move(func));
   }
 
   void
@@ -1301,6 +1322,18 @@ namespace llarp
     m_lmq->job(std::move(func), m_DiskThread);
   }
 
+  void
+  Router::QueueTransitWork(const PathID_t& id, std::function<void(void)> func)
+  {
+    if (m_TransitShards.empty())
+    {
+      QueueCryptoWork(thread::WorkLane::Bulk, PathID_t::Hash{}(id), std::move(func));
+      return;
+    }
+    const auto shard = PathID_t::Hash{}(id) % m_TransitShards.size();
+    m_lmq->job(std::move(func), m_TransitShards[shard]);
+  }
+
   bool
   Router::HasClientExit() const
   {
@@ -1333,11 +1366,16 @@ namespace llarp
         util::memFn(&Router::ConnectionTimedOut, this),
         util::memFn(&AbstractRouter::SessionClosed, this),
         util::memFn(&AbstractRouter::PumpLL, this),
-        util::memFn(&AbstractRouter::QueueWork, this));
+        [this](uint64_t affinity, Work_t work) {
+          QueueCryptoWork(thread::WorkLane::Bulk, affinity, std::move(work));
+        });
 
     if (!link)
       throw std::runtime_error("NewOutboundLink() failed to provide a link");
 
+    link->SetUDPBatchSize(m_UDPBatchSize);
+    link->SetPMTUDiscovery(m_PMTUDiscovery);
+
     const auto afs = {AF_INET, AF_INET6};
 
     for (const auto af : afs)
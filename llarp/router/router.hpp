@@ -24,6 +24,7 @@
 #include <router/rc_gossiper.hpp>
 #include <router/rc_lookup_handler.hpp>
 #include <router/route_poker.hpp>
+#include <router/signature_verifier.hpp>
 #include <routing/handler.hpp>
 #include <routing/message_parser.hpp>
 #include <rpc/lokid_rpc_client.hpp>
@@ -36,6 +37,7 @@
 #include <util/status.hpp>
 #include <util/str.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <util/time.hpp>
 
 #include <functional>
@@ -175,9 +177,16 @@ namespace llarp
     void
     QueueWork(std::function<void(void)> func) override;
 
+    void
+    QueueCryptoWork(
+        thread::WorkLane lane, uint64_t affinity, std::function<void(void)> func) override;
+
     void
     QueueDiskIO(std::function<void(void)> func) override;
 
+    void
+    QueueTransitWork(const PathID_t& id, std::function<void(void)> func) override;
+
     std::optional<SockAddr> _ourAddress;
 
     llarp_ev_loop_ptr _netloop;
@@ -191,6 +200,8 @@ namespace llarp
     std::shared_ptr<NodeDB> _nodedb;
     llarp_time_t _startedAt;
     const oxenmq::TaggedThreadID m_DiskThread;
+    /// threads that transit hops are pinned to by path id
+    std::vector<oxenmq::TaggedThreadID> m_TransitShards;
 
     llarp_time_t
     Uptime() const override;
@@ -199,6 +210,8 @@ namespace llarp
     Sign(Signature& sig, const llarp_buffer_t& buf) const override;
 
     uint16_t m_OutboundPort = 0;
+    size_t m_UDPBatchSize = 0;
+    bool m_PMTUDiscovery = false;
     /// how often do we resign our RC? milliseconds.
     // TODO: make configurable
     llarp_time_t rcRegenInterval = 1h;
@@ -287,6 +300,8 @@ namespace llarp
     LinkManager _linkManager;
     RCLookupHandler _rcLookupHandler;
     RCGossiper _rcGossiper;
+    SignatureVerifier m_SigVerifier;
+    thread::WorkerPool m_CryptoWorkers;
 
     using Clock_t = std::chrono::steady_clock;
     using TimePoint_t = Clock_t::time_point;
@@ -317,6 +332,12 @@ namespace llarp
       return _rcLookupHandler;
     }
 
+    SignatureVerifier&
+    signatureVerifier() override
+    {
+      return m_SigVerifier;
+    }
+
     std::shared_ptr<PeerDb>
     peerDb() override
     {
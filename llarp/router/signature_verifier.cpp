@@ -0,0 +1,93 @@
+#include <router/signature_verifier.hpp>
+
+#include <util/thread/logic.hpp>
+
+#include <algorithm>
+
+namespace llarp
+{
+  /// how many signatures one worker job checks, enough to outweigh the cost of queueing the job
+  static constexpr size_t VerifyChunkSize = 8;
+
+  SignatureVerifier::SignatureVerifier(std::shared_ptr<Logic> logic, Work_t work)
+      : m_Logic{std::move(logic)}, m_Work{std::move(work)}
+  {}
+
+  template <typename Item_t>
+  void
+  SignatureVerifier::Verify(std::vector<Item_t> items, llarp_time_t now, Hook_t<Item_t> hook)
+  {
+    struct Batch
+    {
+      std::vector<Item_t> items;
+      std::unique_ptr<bool[]> valid;
+      std::atomic<size_t> chunksLeft;
+      Hook_t<Item_t> hook;
+    };
+    const size_t numChunks = (items.size() + VerifyChunkSize - 1) / VerifyChunkSize;
+    if (numChunks == 0)
+    {
+      LogicCall(m_Logic, [hook = std::move(hook)]() { hook({}, {}); });
+      return;
+    }
+    m_Batches++;
+    m_Pending += items.size();
+
+    auto batch = std::make_shared<Batch>();
+    batch->valid.reset(new bool[items.size()]);
+    batch->items = std::move(items);
+    batch->chunksLeft = numChunks;
+    batch->hook = std::move(hook);
+
+    for (size_t chunk = 0; chunk < numChunks; ++chunk)
+    {
+      m_Work([this, batch, chunk, now]() {
+        const size_t begin = chunk * VerifyChunkSize;
+        const size_t end = std::min(begin + VerifyChunkSize, batch->items.size());
+        size_t invalid = 0;
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+          batch->valid[idx] = batch->items[idx].Verify(now);
+          if (not batch->valid[idx])
+            invalid++;
+        }
+        m_Checked += end - begin;
+        m_Invalid += invalid;
+        m_Pending -= end - begin;
+        // whoever finishes the last chunk hands the whole batch back
+        if (batch->chunksLeft.fetch_sub(1, std::memory_order_acq_rel) != 1)
+          return;
+        LogicCall(m_Logic, [batch]() {
+          std::vector<bool> valid(batch->valid.get(), batch->valid.get() + batch->items.size());
+          batch->hook(std::move(batch->items), std::move(valid));
+        });
+      });
+    }
+  }
+
+  void
+  SignatureVerifier::VerifyRCs(
+      std::vector<RouterContact> rcs, llarp_time_t now, Hook_t<RouterContact> hook)
+  {
+    Verify(std::move(rcs), now, std::move(hook));
+  }
+
+  void
+  SignatureVerifier::VerifyIntroSets(
+      std::vector<service::EncryptedIntroSet> introsets,
+      llarp_time_t now,
+      Hook_t<service::EncryptedIntroSet> hook)
+  {
+    Verify(std::move(introsets), now, std::move(hook));
+  }
+
+  util::StatusObject
+  SignatureVerifier::ExtractStatus() const
+  {
+    return {
+        {"batches", m_Batches.load()},
+        {"checked", m_Checked.load()},
+        {"invalid", m_Invalid.load()},
+        {"pending", m_Pending.load()}};
+  }
+}  // namespace llarp
@@ -0,0 +1,60 @@
+#ifndef LLARP_ROUTER_SIGNATURE_VERIFIER_HPP
+#define LLARP_ROUTER_SIGNATURE_VERIFIER_HPP
+
+#include <router_contact.hpp>
+#include <service/intro_set.hpp>
+#include <util/status.hpp>
+#include <util/time.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace llarp
+{
+  class Logic;
+
+  /// checks signatures on batches of rcs and introsets on the crypto workers so a big dump does
+  /// not stall the logic thread; each batch completes with one call back on the logic thread
+  class SignatureVerifier
+  {
+   public:
+    using Work_t = std::function<void(std::function<void(void)>)>;
+
+    /// called on the logic thread with the items that were submitted and one result for each
+    template <typename Item_t>
+    using Hook_t = std::function<void(std::vector<Item_t>, std::vector<bool>)>;
+
+    SignatureVerifier(std::shared_ptr<Logic> logic, Work_t work);
+
+    /// check each rc as RouterContact::Verify(now) does
+    void
+    VerifyRCs(std::vector<RouterContact> rcs, llarp_time_t now, Hook_t<RouterContact> hook);
+
+    /// check each introset as EncryptedIntroSet::Verify(now) does
+    void
+    VerifyIntroSets(
+        std::vector<service::EncryptedIntroSet> introsets,
+        llarp_time_t now,
+        Hook_t<service::EncryptedIntroSet> hook);
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    template <typename Item_t>
+    void
+    Verify(std::vector<Item_t> items, llarp_time_t now, Hook_t<Item_t> hook);
+
+    std::shared_ptr<Logic> m_Logic;
+    Work_t m_Work;
+
+    std::atomic<uint64_t> m_Batches{0};
+    std::atomic<uint64_t> m_Checked{0};
+    std::atomic<uint64_t> m_Invalid{0};
+    std::atomic<uint64_t> m_Pending{0};
+  };
+}  // namespace llarp
+
+#endif
@@ -0,0 +1,102 @@
+#include <service/convo_index.hpp>
+
+namespace llarp
+{
+  namespace service
+  {
+    void
+    ConvoIndex::Add(const Address& remote, const ConvoTag& tag, bool inbound, llarp_time_t now)
+    {
+      auto& entry = m_Remotes[remote];
+      if (not entry.convos.emplace(tag, Convo{inbound, now}).second)
+        return;
+      if (inbound)
+        entry.inbound++;
+      if (entry.convos.size() == 1 or now >= entry.bestUsed)
+      {
+        entry.best = tag;
+        entry.bestUsed = now;
+      }
+    }
+
+    void
+    ConvoIndex::Touch(const Address& remote, const ConvoTag& tag, llarp_time_t now)
+    {
+      auto itr = m_Remotes.find(remote);
+      if (itr == m_Remotes.end())
+        return;
+      auto convo = itr->second.convos.find(tag);
+      if (convo == itr->second.convos.end())
+        return;
+      convo->second.lastUsed = now;
+      if (now >= itr->second.bestUsed)
+      {
+        itr->second.best = tag;
+        itr->second.bestUsed = now;
+      }
+    }
+
+    void
+    ConvoIndex::Remove(const Address& remote, const ConvoTag& tag)
+    {
+      auto itr = m_Remotes.find(remote);
+      if (itr == m_Remotes.end())
+        return;
+      auto& entry = itr->second;
+      auto convo = entry.convos.find(tag);
+      if (convo == entry.convos.end())
+        return;
+      if (convo->second.inbound)
+        entry.inbound--;
+      entry.convos.erase(convo);
+      if (entry.convos.empty())
+      {
+        m_Remotes.erase(itr);
+        return;
+      }
+      if (entry.best != tag)
+        return;
+      // only the convos with this one remote are looked at, there are few
+      entry.bestUsed = 0s;
+      for (const auto& [other, info] : entry.convos)
+      {
+        if (info.lastUsed >= entry.bestUsed)
+        {
+          entry.best = other;
+          entry.bestUsed = info.lastUsed;
+        }
+      }
+    }
+
+    bool
+    ConvoIndex::HasInbound(const Address& remote) const
+    {
+      auto itr = m_Remotes.find(remote);
+      return itr != m_Remotes.end() and itr->second.inbound > 0;
+    }
+
+    std::optional<ConvoTag>
+    ConvoIndex::Best(const Address& remote) const
+    {
+      auto itr = m_Remotes.find(remote);
+      if (itr == m_Remotes.end())
+        return std::nullopt;
+      return itr->second.best;
+    }
+
+    bool
+    ConvoIndex::GetTags(const Address& remote, std::set<ConvoTag>& tags) const
+    {
+      auto itr = m_Remotes.find(remote);
+      if (itr == m_Remotes.end())
+        return false;
+      bool inserted = false;
+      for (const auto& [tag, info] : itr->second.convos)
+      {
+        if (tags.emplace(tag).second)
+          inserted = true;
+      }
+      return inserted;
+    }
+  }  // namespace service
+}  // namespace llarp
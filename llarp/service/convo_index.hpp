@@ -0,0 +1,69 @@
+#ifndef LLARP_SERVICE_CONVO_INDEX_HPP
+#define LLARP_SERVICE_CONVO_INDEX_HPP
+
+#include <service/address.hpp>
+#include <service/handler.hpp>
+#include <util/time.hpp>
+
+#include <optional>
+#include <set>
+#include <unordered_map>
+
+namespace llarp
+{
+  namespace service
+  {
+    /// the convos of an endpoint by remote address, kept in step with its ConvoMap so sending to
+    /// an address does not scan every convo
+    class ConvoIndex
+    {
+     public:
+      void
+      Add(const Address& remote, const ConvoTag& tag, bool inbound, llarp_time_t now);
+
+      /// the convo was just used, which makes it the best one with its remote
+      void
+      Touch(const Address& remote, const ConvoTag& tag, llarp_time_t now);
+
+      void
+      Remove(const Address& remote, const ConvoTag& tag);
+
+      /// did the remote start any of our convos with it
+      bool
+      HasInbound(const Address& remote) const;
+
+      /// the convo with the remote used last
+      std::optional<ConvoTag>
+      Best(const Address& remote) const;
+
+      /// put the tags of every convo with the remote into tags, false if none were new
+      bool
+      GetTags(const Address& remote, std::set<ConvoTag>& tags) const;
+
+      size_t
+      NumRemotes() const
+      {
+        return m_Remotes.size();
+      }
+
+     private:
+      struct Convo
+      {
+        bool inbound;
+        llarp_time_t lastUsed;
+      };
+
+      struct Remote
+      {
+        std::unordered_map<ConvoTag, Convo, ConvoTag::Hash> convos;
+        size_t inbound = 0;
+        ConvoTag best;
+        llarp_time_t bestUsed = 0s;
+      };
+
+      std::unordered_map<Address, Remote, Address::Hash> m_Remotes;
+    };
+  }  // namespace service
+}  // namespace llarp
+
+#endif
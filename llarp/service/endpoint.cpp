@@ -22,6 +22,7 @@
 #include <service/outbound_context.hpp>
 #include <service/protocol.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <util/str.hpp>
 #include <util/buffer.hpp>
 #include <util/meta/memfn.hpp>
@@ -232,9 +233,13 @@ namespace llarp
       EndpointUtil::DeregisterDeadSessions(now, m_state->m_DeadSessions);
       // tick remote sessions
       EndpointUtil::TickRemoteSessions(
-          now, m_state->m_RemoteSessions, m_state->m_DeadSessions, Sessions());
+          now,
+          m_state->m_RemoteSessions,
+          m_state->m_DeadSessions,
+          Sessions(),
+          m_state->m_ConvoIndex);
       // expire convotags
-      EndpointUtil::ExpireConvoSessions(now, Sessions());
+      EndpointUtil::ExpireConvoSessions(now, Sessions(), m_state->m_ConvoIndex);
 
       if (NumInStatus(path::ePathEstablished) > 1)
       {
@@ -324,12 +329,14 @@ namespace llarp
     bool
     Endpoint::HasInboundConvo(const Address& addr) const
     {
-      for (const auto& item : Sessions())
-      {
-        if (item.second.remote.Addr() == addr && item.second.inbound)
-          return true;
-      }
-      return false;
+      return m_state->m_ConvoIndex.HasInbound(addr);
+    }
+
+    void
+    Endpoint::TouchConvo(const ConvoTag& tag, Session& session)
+    {
+      session.lastUsed = Now();
+      m_state->m_ConvoIndex.Touch(session.remote.Addr(), tag, session.lastUsed);
     }
 
     void
@@ -341,27 +348,19 @@ namespace llarp
         itr = Sessions().emplace(tag, Session{}).first;
         itr->second.inbound = inbound;
         itr->second.remote = info;
+        m_state->m_ConvoIndex.Add(info.Addr(), tag, inbound, Now());
       }
-      itr->second.lastUsed = Now();
+      TouchConvo(tag, itr->second);
     }
 
     size_t
     Endpoint::RemoveAllConvoTagsFor(service::Address remote)
     {
-      size_t removed = 0;
-      auto& sessions = Sessions();
-      auto itr = sessions.begin();
-      while (itr != sessions.end())
-      {
-        if (itr->second.remote.Addr() == remote)
-        {
-          itr = sessions.erase(itr);
-          removed++;
-        }
-        else
-          ++itr;
-      }
-      return removed;
+      std::set<ConvoTag> tags;
+      m_state->m_ConvoIndex.GetTags(remote, tags);
+      for (const auto& tag : tags)
+        EndpointUtil::RemoveConvo(Sessions(), m_state->m_ConvoIndex, tag);
+      return tags.size();
     }
 
     bool
@@ -383,7 +382,7 @@ namespace llarp
         return;
       }
       itr->second.intro = intro;
-      itr->second.lastUsed = Now();
+      TouchConvo(tag, itr->second);
     }
 
     bool
@@ -405,7 +404,7 @@ namespace llarp
         return;
       }
       itr->second.replyIntro = intro;
-      itr->second.lastUsed = Now();
+      TouchConvo(tag, itr->second);
     }
 
     bool
@@ -421,7 +420,7 @@ namespace llarp
     bool
     Endpoint::GetConvoTagsForService(const Address& addr, std::set<ConvoTag>& tags) const
     {
-      return EndpointUtil::GetConvoTagsForService(Sessions(), addr, tags);
+      return m_state->m_ConvoIndex.GetTags(addr, tags);
     }
 
     bool
@@ -443,7 +442,7 @@ namespace llarp
         itr = Sessions().emplace(tag, Session{}).first;
       }
       itr->second.sharedKey = k;
-      itr->second.lastUsed = Now();
+      TouchConvo(tag, itr->second);
     }
 
     void
@@ -452,10 +451,25 @@ namespace llarp
       auto itr = Sessions().find(tag);
       if (itr != Sessions().end())
       {
-        itr->second.lastUsed = Now();
+        TouchConvo(tag, itr->second);
       }
     }
 
+    void
+    Endpoint::PutMACFramesFor(const ConvoTag& tag)
+    {
+      auto itr = Sessions().find(tag);
+      if (itr != Sessions().end())
+        itr->second.macFrames = true;
+    }
+
+    bool
+    Endpoint::WantsMACFrames(const ConvoTag& tag) const
+    {
+      auto itr = Sessions().find(tag);
+      return itr != Sessions().end() and itr->second.macFrames;
+    }
+
     bool
     Endpoint::LoadKeyFile()
     {
@@ -1004,6 +1018,8 @@ namespace llarp
     {
       msg->sender.UpdateAddr();
       PutSenderFor(msg->tag, msg->sender, true);
+      if (msg->version >= MACFramesVersion)
+        PutMACFramesFor(msg->tag);
       PutReplyIntroFor(msg->tag, path->intro);
       Introduction intro;
       intro.pathID = from;
@@ -1122,7 +1138,7 @@ namespace llarp
     void
     Endpoint::RemoveConvoTag(const ConvoTag& t)
     {
-      Sessions().erase(t);
+      EndpointUtil::RemoveConvo(Sessions(), m_state->m_ConvoIndex, t);
     }
 
     bool
@@ -1356,12 +1372,13 @@ namespace llarp
     bool
     Endpoint::SendToSNodeOrQueue(const RouterID& addr, const llarp_buffer_t& buf)
     {
-      auto pkt = std::make_shared<net::IPPacket>();
-      if (!pkt->Load(buf))
+      net::IPPacket pkt;
+      if (!pkt.Load(buf))
         return false;
-      EnsurePathToSNode(addr, [pkt](RouterID, exit::BaseSession_ptr s) {
+      // copies of the packet share its bytes, every session we hand it to costs a refcount
+      EnsurePathToSNode(addr, [pkt = std::move(pkt)](RouterID, exit::BaseSession_ptr s) {
         if (s)
-          s->QueueUpstreamTraffic(*pkt, routing::ExitPadSize);
+          s->QueueUpstreamTraffic(pkt, routing::ExitPadSize);
       });
       return true;
     }
@@ -1428,18 +1445,7 @@ namespace llarp
     std::optional<ConvoTag>
     Endpoint::GetBestConvoTagForService(Address remote) const
     {
-      llarp_time_t time = 0s;
-      std::optional<ConvoTag> ret = std::nullopt;
-      // get convotag with higest timestamp
-      for (const auto& [tag, session] : Sessions())
-      {
-        if (session.remote.Addr() == remote and session.lastUsed > time)
-        {
-          time = session.lastUsed;
-          ret = tag;
-        }
-      }
-      return ret;
+      return m_state->m_ConvoIndex.Best(remote);
     }
 
     bool
@@ -1471,19 +1477,13 @@ namespace llarp
             return false;
           if (!GetIntroFor(tag, remoteIntro))
             return false;
-          // get path for intro
-          ForEachPath([&](path::Path_ptr path) {
-            if (path->intro == replyPath)
-            {
-              p = path;
-              return;
-            }
-            if (p && p->ExpiresSoon(now) && path->IsReady()
-                && path->intro.router == replyPath.router)
-            {
-              p = path;
-            }
-          });
+          // get path for intro, or another one to the same router if it is about to go
+          p = GetPathByIntro(replyPath);
+          if (p and p->ExpiresSoon(now))
+          {
+            if (auto other = GetPathByRouter(replyPath.router))
+              p = other;
+          }
 
           if (p)
           {
@@ -1503,15 +1503,24 @@ namespace llarp
             f.F = m->introReply.pathID;
             transfer->P = remoteIntro.pathID;
             auto self = this;
-            Router()->QueueWork([transfer, p, m, K, self]() {
-              if (not transfer->T.EncryptAndSign(*m, K, self->m_Identity))
-              {
-                LogError("failed to encrypt and sign");
-                return;
-              }
-              self->m_SendQueue.pushBack(SendEvent_t{transfer, p});
-              ;
-            });
+            // the address is cached on first use, get it here rather than on a worker
+            std::optional<Address> macFrom;
+            if (WantsMACFrames(tag))
+              macFrom = m_Identity.pub.Addr();
+            Router()->QueueCryptoWork(
+                thread::WorkLane::Bulk,
+                ConvoTag::Hash{}(f.T),
+                [transfer, p, m, K, self, macFrom]() {
+                  auto& frame = transfer->T;
+                  if (not(macFrom ? frame.EncryptAndMAC(*m, K, *macFrom)
+                                  : frame.EncryptAndSign(*m, K, self->m_Identity)))
+                  {
+                    LogError("failed to encrypt and sign");
+                    return;
+                  }
+                  self->m_SendQueue.pushBack(SendEvent_t{transfer, p});
+                  ;
+                });
             return true;
           }
         }
@@ -353,6 +353,12 @@ namespace llarp
       void
       MarkConvoTagActive(const ConvoTag& remote) override;
 
+      void
+      PutMACFramesFor(const ConvoTag& remote) override;
+
+      bool
+      WantsMACFrames(const ConvoTag& remote) const override;
+
       void
       PutReplyIntroFor(const ConvoTag& remote, const Introduction& intro) override;
 
@@ -440,6 +446,10 @@ namespace llarp
       IsolatedNetworkMainLoop();
 
      private:
+      /// mark a convo used now
+      void
+      TouchConvo(const ConvoTag& tag, Session& session);
+
       void
       HandleVerifyGotRouter(dht::GotRouterMessage_constptr msg, RouterID id, bool valid);
 
@@ -81,6 +81,8 @@ namespace llarp
 
       /// conversations
       ConvoMap m_Sessions;
+      /// m_Sessions by remote address, every change to m_Sessions goes through here too
+      ConvoIndex m_ConvoIndex;
 
       OutboundSessions_t m_OutboundSessions;
 
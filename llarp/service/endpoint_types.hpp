@@ -1,6 +1,7 @@
 #ifndef LLARP_SERVICE_ENDPOINT_TYPES_HPP
 #define LLARP_SERVICE_ENDPOINT_TYPES_HPP
 
+#include <service/convo_index.hpp>
 #include <service/pendingbuffer.hpp>
 #include <service/router_lookup_job.hpp>
 #include <service/session.hpp>
@@ -87,7 +87,11 @@ namespace llarp
 
     void
     EndpointUtil::TickRemoteSessions(
-        llarp_time_t now, Sessions& remoteSessions, Sessions& deadSessions, ConvoMap& sessions)
+        llarp_time_t now,
+        Sessions& remoteSessions,
+        Sessions& deadSessions,
+        ConvoMap& sessions,
+        ConvoIndex& index)
     {
       auto itr = remoteSessions.begin();
       while (itr != remoteSessions.end())
@@ -97,7 +101,7 @@ namespace llarp
         {
           LogInfo("marking session as dead T=", itr->first);
           itr->second->Stop();
-          sessions.erase(itr->second->currentConvoTag);
+          RemoveConvo(sessions, index, itr->second->currentConvoTag);
           deadSessions.emplace(std::move(*itr));
           itr = remoteSessions.erase(itr);
         }
@@ -109,7 +113,7 @@ namespace llarp
     }
 
     void
-    EndpointUtil::ExpireConvoSessions(llarp_time_t now, ConvoMap& sessions)
+    EndpointUtil::ExpireConvoSessions(llarp_time_t now, ConvoMap& sessions, ConvoIndex& index)
     {
       auto itr = sessions.begin();
       while (itr != sessions.end())
@@ -117,6 +121,7 @@ namespace llarp
         if (itr->second.IsExpired(now))
         {
           LogInfo("Expire session T=", itr->first);
+          index.Remove(itr->second.remote.Addr(), itr->first);
           itr = sessions.erase(itr);
         }
         else
@@ -156,24 +161,14 @@ namespace llarp
       return false;
     }
 
-    bool
-    EndpointUtil::GetConvoTagsForService(
-        const ConvoMap& sessions, const Address& info, std::set<ConvoTag>& tags)
+    void
+    EndpointUtil::RemoveConvo(ConvoMap& sessions, ConvoIndex& index, const ConvoTag& tag)
     {
-      bool inserted = false;
-      auto itr = sessions.begin();
-      while (itr != sessions.end())
-      {
-        if (itr->second.remote.Addr() == info)
-        {
-          if (tags.emplace(itr->first).second)
-          {
-            inserted = true;
-          }
-        }
-        ++itr;
-      }
-      return inserted;
+      auto itr = sessions.find(tag);
+      if (itr == sessions.end())
+        return;
+      index.Remove(itr->second.remote.Addr(), tag);
+      sessions.erase(itr);
     }
   }  // namespace service
 }  // namespace llarp
@@ -23,10 +23,18 @@ namespace llarp
 
       static void
       TickRemoteSessions(
-          llarp_time_t now, Sessions& remoteSessions, Sessions& deadSessions, ConvoMap& sessions);
+          llarp_time_t now,
+          Sessions& remoteSessions,
+          Sessions& deadSessions,
+          ConvoMap& sessions,
+          ConvoIndex& index);
 
       static void
-      ExpireConvoSessions(llarp_time_t now, ConvoMap& sessions);
+      ExpireConvoSessions(llarp_time_t now, ConvoMap& sessions, ConvoIndex& index);
+
+      /// forget a convo and take it out of the index
+      static void
+      RemoveConvo(ConvoMap& sessions, ConvoIndex& index, const ConvoTag& tag);
 
       static void
       StopRemoteSessions(Sessions& remoteSessions);
@@ -36,10 +44,6 @@ namespace llarp
 
       static bool
       HasPathToService(const Address& addr, const Sessions& remoteSessions);
-
-      static bool
-      GetConvoTagsForService(
-          const ConvoMap& sessions, const Address& addr, std::set<ConvoTag>& tags);
     };
 
     template <typename Endpoint_t>
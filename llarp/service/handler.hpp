@@ -38,6 +38,12 @@ namespace llarp
       virtual void
       MarkConvoTagActive(const ConvoTag& tag) = 0;
 
+      /// the remote of this convo takes frames with a mac instead of a signature
+      virtual void
+      PutMACFramesFor(const ConvoTag& remote) = 0;
+      virtual bool
+      WantsMACFrames(const ConvoTag& remote) const = 0;
+
       virtual void
       RemoveConvoTag(const ConvoTag& remote) = 0;
 
@@ -7,6 +7,7 @@
 #include <nodedb.hpp>
 #include <profiling.hpp>
 #include <util/meta/memfn.hpp>
+#include <util/thread/worker_pool.hpp>
 
 #include <service/endpoint_util.hpp>
 
@@ -216,7 +217,10 @@ namespace llarp
       ex->msg.PutBuffer(payload);
       ex->msg.introReply = path->intro;
       frame->F = ex->msg.introReply.pathID;
-      m_Endpoint->Router()->QueueWork(std::bind(&AsyncKeyExchange::Encrypt, ex, frame));
+      m_Endpoint->Router()->QueueCryptoWork(
+          thread::WorkLane::Handshake,
+          PathID_t::Hash{}(path->intro.pathID),
+          std::bind(&AsyncKeyExchange::Encrypt, ex, frame));
     }
 
     std::string
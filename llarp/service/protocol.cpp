@@ -5,6 +5,7 @@
 #include <util/mem.hpp>
 #include <util/meta/memfn.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <service/endpoint.hpp>
 #include <router/abstractrouter.hpp>
 #include <utility>
@@ -143,6 +144,11 @@ namespace llarp
       }
       if (!BEncodeWriteDictEntry("F", F, buf))
         return false;
+      if (!M.IsZero())
+      {
+        if (!BEncodeWriteDictEntry("M", M, buf))
+          return false;
+      }
       if (!N.IsZero())
       {
         if (!BEncodeWriteDictEntry("N", N, buf))
@@ -160,8 +166,11 @@ namespace llarp
       }
       if (!BEncodeWriteDictInt("V", version, buf))
         return false;
-      if (!BEncodeWriteDictEntry("Z", Z, buf))
-        return false;
+      if (M.IsZero())
+      {
+        if (!BEncodeWriteDictEntry("Z", Z, buf))
+          return false;
+      }
       return bencode_end(buf);
     }
 
@@ -184,6 +193,8 @@ namespace llarp
         return false;
       if (!BEncodeMaybeReadDictEntry("C", C, read, key, val))
         return false;
+      if (!BEncodeMaybeReadDictEntry("M", M, read, key, val))
+        return false;
       if (!BEncodeMaybeReadDictEntry("N", N, read, key, val))
         return false;
       if (!BEncodeMaybeReadDictInt("S", S, read, key, val))
@@ -212,6 +223,7 @@ namespace llarp
     ProtocolFrame::Sign(const Identity& localIdent)
     {
       Z.Zero();
+      M.Zero();
       std::array<byte_t, MAX_PROTOCOL_MESSAGE_SIZE> tmp;
       llarp_buffer_t buf(tmp);
       // encode
@@ -228,8 +240,7 @@ namespace llarp
     }
 
     bool
-    ProtocolFrame::EncryptAndSign(
-        const ProtocolMessage& msg, const SharedSecret& sessionKey, const Identity& localIdent)
+    ProtocolFrame::EncryptPayload(const ProtocolMessage& msg, const SharedSecret& sessionKey)
     {
       std::array<byte_t, MAX_PROTOCOL_MESSAGE_SIZE> tmp;
       llarp_buffer_t buf(tmp);
@@ -246,8 +257,62 @@ namespace llarp
       CryptoManager::instance()->xchacha20(buf, sessionKey, N);
       // put encrypted buffer
       D = buf;
+      return true;
+    }
+
+    bool
+    ProtocolFrame::CalculateMAC(
+        const SharedSecret& sessionKey, const Address& sender, ShortHash& mac) const
+    {
+      ProtocolFrame copy(*this);
+      copy.M.Zero();
+      std::array<byte_t, MAX_PROTOCOL_MESSAGE_SIZE> tmp;
+      llarp_buffer_t buf(tmp);
+      if (!copy.BEncode(&buf))
+      {
+        LogError("frame too big to encode");
+        return false;
+      }
+      // rewind
+      buf.sz = buf.cur - buf.base;
+      buf.cur = buf.base;
+      // both ends have the session key, key the mac to the sender too so frames we sent do not
+      // check out when someone sends them back to us
+      auto crypto = CryptoManager::instance();
+      SharedSecret macKey;
+      if (!crypto->hmac(macKey.data(), llarp_buffer_t(sender.as_array()), sessionKey))
+        return false;
+      return crypto->hmac(mac.data(), buf, macKey);
+    }
+
+    bool
+    ProtocolFrame::EncryptAndMAC(
+        const ProtocolMessage& msg, const SharedSecret& sessionKey, const Address& localAddr)
+    {
+      if (!EncryptPayload(msg, sessionKey))
+        return false;
+      Z.Zero();
+      M.Zero();
+      ShortHash mac;
+      if (!CalculateMAC(sessionKey, localAddr, mac))
+      {
+        LogError("failed to calculate frame mac");
+        return false;
+      }
+      M = mac;
+      return true;
+    }
+
+    bool
+    ProtocolFrame::EncryptAndSign(
+        const ProtocolMessage& msg, const SharedSecret& sessionKey, const Identity& localIdent)
+    {
+      if (!EncryptPayload(msg, sessionKey))
+        return false;
       // zero out signature
       Z.Zero();
+      M.Zero();
+      std::array<byte_t, MAX_PROTOCOL_MESSAGE_SIZE> tmp;
       llarp_buffer_t buf2(tmp);
       // encode frame
       if (!BEncode(&buf2))
@@ -387,6 +452,7 @@ namespace llarp
       F = other.F;
       N = other.N;
       Z = other.Z;
+      M = other.M;
       T = other.T;
       R = other.R;
       S = other.S;
@@ -418,7 +484,10 @@ namespace llarp
         auto dh = std::make_shared<AsyncFrameDecrypt>(
             logic, localIdent, handler, msg, *this, recvPath->intro);
         dh->path = recvPath;
-        handler->Router()->QueueWork(std::bind(&AsyncFrameDecrypt::Work, dh));
+        handler->Router()->QueueCryptoWork(
+            thread::WorkLane::Handshake,
+            PathID_t::Hash{}(recvPath->intro.pathID),
+            std::bind(&AsyncFrameDecrypt::Work, dh));
         return true;
       }
 
@@ -442,9 +511,15 @@ namespace llarp
           LogicCall(logic, [msg, hook]() { hook(msg); });
         }
       };
-      handler->Router()->QueueWork(
+      handler->Router()->QueueCryptoWork(
+          thread::WorkLane::Bulk,
+          ConvoTag::Hash{}(T),
           [v, msg = std::move(msg), recvPath = std::move(recvPath), callback]() {
-            if (not v->frame.Verify(v->si))
+            // established convos may use a mac in place of the signature
+            const bool authentic = v->frame.M.IsZero()
+                ? v->frame.Verify(v->si)
+                : v->frame.VerifyMAC(v->shared, v->si.Addr());
+            if (not authentic)
             {
               LogError("Signature failure from ", v->si.Addr());
               return;
@@ -467,8 +542,8 @@ namespace llarp
     bool
     ProtocolFrame::operator==(const ProtocolFrame& other) const
     {
-      return C == other.C && D == other.D && N == other.N && Z == other.Z && T == other.T
-          && S == other.S && version == other.version;
+      return C == other.C && D == other.D && N == other.N && Z == other.Z && M == other.M
+          && T == other.T && S == other.S && version == other.version;
     }
 
     bool
@@ -494,6 +569,17 @@ namespace llarp
       return svc.Verify(buf, Z);
     }
 
+    bool
+    ProtocolFrame::VerifyMAC(const SharedSecret& sessionKey, const Address& from) const
+    {
+      if (M.IsZero())
+        return false;
+      ShortHash expected;
+      if (!CalculateMAC(sessionKey, from, expected))
+        return false;
+      return llarp_eq(expected.data(), M.data(), M.size());
+    }
+
     bool
     ProtocolFrame::HandleMessage(routing::IMessageHandler* h, AbstractRouter* /*r*/) const
     {
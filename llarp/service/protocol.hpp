@@ -34,6 +34,10 @@ namespace llarp
 
     constexpr std::size_t MAX_PROTOCOL_MESSAGE_SIZE = 2048 * 2;
 
+    /// ProtocolMessage version from which the sender takes frames on established convos that
+    /// carry a mac keyed from the session key instead of a signature
+    constexpr uint64_t MACFramesVersion = 1;
+
     /// inner message
     struct ProtocolMessage
     {
@@ -48,7 +52,7 @@ namespace llarp
       Endpoint* handler = nullptr;
       ConvoTag tag;
       uint64_t seqno = 0;
-      uint64_t version = LLARP_PROTO_VERSION;
+      uint64_t version = MACFramesVersion;
 
       /// encode metainfo for lmq endpoint auth
       std::vector<char>
@@ -82,6 +86,8 @@ namespace llarp
       uint64_t R;
       KeyExchangeNonce N;
       Signature Z;
+      /// mac in place of Z on established convos, Z is left out when this is set
+      ShortHash M;
       PathID_t F;
       service::ConvoTag T;
 
@@ -92,6 +98,7 @@ namespace llarp
           , R(other.R)
           , N(other.N)
           , Z(other.Z)
+          , M(other.M)
           , F(other.F)
           , T(other.T)
       {
@@ -122,6 +129,12 @@ namespace llarp
       EncryptAndSign(
           const ProtocolMessage& msg, const SharedSecret& sharedkey, const Identity& localIdent);
 
+      /// encrypt msg and authenticate the frame with a mac keyed from the session key and our
+      /// address, for convos whose remote sent us a version of at least MACFramesVersion
+      bool
+      EncryptAndMAC(
+          const ProtocolMessage& msg, const SharedSecret& sharedkey, const Address& localAddr);
+
       bool
       Sign(const Identity& localIdent);
 
@@ -157,6 +170,7 @@ namespace llarp
         T.Zero();
         N.Zero();
         Z.Zero();
+        M.Zero();
         R = 0;
         version = LLARP_PROTO_VERSION;
       }
@@ -164,8 +178,21 @@ namespace llarp
       bool
       Verify(const ServiceInfo& from) const;
 
+      /// check the mac of a frame on an established convo
+      bool
+      VerifyMAC(const SharedSecret& sharedkey, const Address& from) const;
+
       bool
       HandleMessage(routing::IMessageHandler* h, AbstractRouter* r) const override;
+
+     private:
+      /// encode msg and encrypt it into D
+      bool
+      EncryptPayload(const ProtocolMessage& msg, const SharedSecret& sharedkey);
+
+      /// mac over the frame with M zeroed, keyed for frames from sender
+      bool
+      CalculateMAC(const SharedSecret& sharedkey, const Address& sender, ShortHash& mac) const;
     };
   }  // namespace service
 }  // namespace llarp
@@ -4,6 +4,7 @@
 #include <routing/path_transfer_message.hpp>
 #include <service/endpoint.hpp>
 #include <util/thread/logic.hpp>
+#include <util/thread/worker_pool.hpp>
 #include <utility>
 #include <unordered_set>
 
@@ -98,14 +99,20 @@ namespace llarp
       m->tag = f->T;
       m->PutBuffer(payload);
       auto self = this;
-      m_Endpoint->Router()->QueueWork([f, m, shared, path, self]() {
-        if (not f->EncryptAndSign(*m, shared, self->m_Endpoint->GetIdentity()))
-        {
-          LogError(self->m_Endpoint->Name(), " failed to sign message");
-          return;
-        }
-        self->Send(f, path);
-      });
+      // the address is cached on first use, get it here rather than on a worker
+      std::optional<Address> macFrom;
+      if (m_DataHandler->WantsMACFrames(f->T))
+        macFrom = m_Endpoint->GetIdentity().pub.Addr();
+      m_Endpoint->Router()->QueueCryptoWork(
+          thread::WorkLane::Bulk, ConvoTag::Hash{}(f->T), [f, m, shared, path, self, macFrom]() {
+            if (not(macFrom ? f->EncryptAndMAC(*m, shared, *macFrom)
+                            : f->EncryptAndSign(*m, shared, self->m_Endpoint->GetIdentity())))
+            {
+              LogError(self->m_Endpoint->Name(), " failed to sign message");
+              return;
+            }
+            self->Send(f, path);
+          });
     }
 
     void
@@ -11,6 +11,7 @@ namespace llarp
                              {"replyIntro", replyIntro.ExtractStatus()},
                              {"remote", remote.Addr().ToString()},
                              {"seqno", seqno},
+                             {"macFrames", macFrames},
                              {"intro", intro.ExtractStatus()}};
       return obj;
     }
@@ -27,6 +27,8 @@ namespace llarp
       llarp_time_t lastUsed = 0s;
       uint64_t seqno = 0;
       bool inbound = false;
+      /// remote takes frames with a mac instead of a signature, we sign until it tells us
+      bool macFrames = false;
 
       util::StatusObject
       ExtractStatus() const;
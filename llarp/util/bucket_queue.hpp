@@ -0,0 +1,133 @@
+#ifndef LLARP_UTIL_BUCKET_QUEUE_HPP
+#define LLARP_UTIL_BUCKET_QUEUE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// priority queue of move only values with few distinct priorities
+    ///
+    /// each priority gets a ring buffer of its own, kept sorted by priority, so push and pop
+    /// move the value exactly once and values of the same priority come out in the order they
+    /// went in. rings only grow, once a queue has seen its busiest moment it stops allocating.
+    /// the lowest priority value comes out first. not thread safe.
+    template <typename Val_t>
+    class BucketQueue
+    {
+     public:
+      void
+      Push(uint16_t priority, Val_t val)
+      {
+        auto itr = std::lower_bound(
+            m_Buckets.begin(), m_Buckets.end(), priority, [](const auto& bucket, uint16_t prio) {
+              return bucket.priority < prio;
+            });
+        if (itr == m_Buckets.end() or itr->priority != priority)
+          itr = m_Buckets.emplace(itr, priority);
+        itr->Push(std::move(val));
+        m_Size++;
+      }
+
+      /// the first value, must not be empty
+      Val_t&
+      Front()
+      {
+        return FirstBucket().Front();
+      }
+
+      /// take out the first value, must not be empty
+      Val_t
+      Pop()
+      {
+        m_Size--;
+        return FirstBucket().Pop();
+      }
+
+      size_t
+      Size() const
+      {
+        return m_Size;
+      }
+
+      bool
+      Empty() const
+      {
+        return m_Size == 0;
+      }
+
+      void
+      swap(BucketQueue& other) noexcept
+      {
+        std::swap(m_Buckets, other.m_Buckets);
+        std::swap(m_Size, other.m_Size);
+      }
+
+     private:
+      struct Bucket
+      {
+        explicit Bucket(uint16_t prio) : priority{prio}
+        {}
+
+        void
+        Push(Val_t val)
+        {
+          if (size == ring.size())
+            Grow();
+          ring[(head + size) & (ring.size() - 1)] = std::move(val);
+          size++;
+        }
+
+        Val_t&
+        Front()
+        {
+          return ring[head];
+        }
+
+        Val_t
+        Pop()
+        {
+          Val_t val{std::move(ring[head])};
+          head = (head + 1) & (ring.size() - 1);
+          size--;
+          return val;
+        }
+
+        /// double the ring, the values keep their order starting from slot 0
+        void
+        Grow()
+        {
+          std::vector<Val_t> bigger(std::max(ring.size() * 2, InitialSize));
+          for (size_t idx = 0; idx < size; ++idx)
+            bigger[idx] = std::move(ring[(head + idx) & (ring.size() - 1)]);
+          ring = std::move(bigger);
+          head = 0;
+        }
+
+        uint16_t priority;
+        std::vector<Val_t> ring;
+        size_t head = 0;
+        size_t size = 0;
+      };
+
+      static constexpr size_t InitialSize = 8;
+
+      Bucket&
+      FirstBucket()
+      {
+        return *std::find_if(m_Buckets.begin(), m_Buckets.end(), [](const auto& bucket) {
+          return bucket.size > 0;
+        });
+      }
+
+      std::vector<Bucket> m_Buckets;
+      size_t m_Size = 0;
+    };
+  }  // namespace util
+}  // namespace llarp
+
+#endif
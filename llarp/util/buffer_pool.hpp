@@ -0,0 +1,401 @@
+#ifndef LLARP_UTIL_BUFFER_POOL_HPP
+#define LLARP_UTIL_BUFFER_POOL_HPP
+
+#include <util/status.hpp>
+#include <util/types.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// counters for a BufferPool, safe to read from any thread
+    struct BufferPoolStats
+    {
+      /// acquires served from a free list
+      std::atomic<uint64_t> hits{0};
+      /// acquires that had to allocate a new buffer
+      std::atomic<uint64_t> misses{0};
+      /// buffers currently handed out
+      std::atomic<uint64_t> inUse{0};
+      /// most buffers ever handed out at once
+      std::atomic<uint64_t> highWater{0};
+
+      util::StatusObject
+      ExtractStatus() const
+      {
+        return {{"hits", hits.load()},
+                {"misses", misses.load()},
+                {"inUse", inUse.load()},
+                {"highWater", highWater.load()}};
+      }
+    };
+
+    /// process wide pool of fixed size, refcounted byte buffers
+    /// each thread keeps a small cache of free buffers so acquire and release take no lock in the
+    /// common case, buffers move between threads in batches via a mutex guarded free list
+    template <size_t Capacity>
+    class BufferPool
+    {
+     public:
+      struct Slab
+      {
+        std::atomic<uint32_t> refs;
+        Slab* next;
+        byte_t data[Capacity];
+      };
+
+      /// the pool is intentionally leaked so buffers can outlive static destruction
+      static BufferPool&
+      Instance()
+      {
+        static BufferPool* pool = new BufferPool{};
+        return *pool;
+      }
+
+      /// get a buffer with a refcount of 1
+      Slab*
+      Acquire()
+      {
+        auto& cache = Local();
+        if (cache.slabs.empty())
+          Refill(cache.slabs);
+        Slab* slab = nullptr;
+        if (cache.slabs.empty())
+        {
+          m_Stats.misses.fetch_add(1, std::memory_order_relaxed);
+          slab = new Slab;
+        }
+        else
+        {
+          m_Stats.hits.fetch_add(1, std::memory_order_relaxed);
+          slab = cache.slabs.back();
+          cache.slabs.pop_back();
+        }
+        slab->refs.store(1, std::memory_order_relaxed);
+        slab->next = nullptr;
+        const auto inUse = m_Stats.inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+        auto highWater = m_Stats.highWater.load(std::memory_order_relaxed);
+        while (inUse > highWater
+               and not m_Stats.highWater.compare_exchange_weak(
+                   highWater, inUse, std::memory_order_relaxed))
+          ;
+        return slab;
+      }
+
+      /// give a buffer whose refcount has dropped to 0 back to the pool
+      void
+      Release(Slab* slab)
+      {
+        m_Stats.inUse.fetch_sub(1, std::memory_order_relaxed);
+        auto& cache = Local();
+        cache.slabs.push_back(slab);
+        if (cache.slabs.size() >= CacheBatch * 2)
+          Spill(cache.slabs, CacheBatch);
+      }
+
+      const BufferPoolStats&
+      Stats() const
+      {
+        return m_Stats;
+      }
+
+     private:
+      /// how many buffers move between a thread cache and the shared free list at once
+      static constexpr size_t CacheBatch = 32;
+      /// cap on idle memory held by the shared free list, anything over this is freed
+      static constexpr size_t MaxFreeBytes = 16 * 1024 * 1024;
+      static constexpr size_t MaxFree = std::max(MaxFreeBytes / Capacity, CacheBatch);
+
+      struct LocalCache
+      {
+        std::vector<Slab*> slabs;
+
+        LocalCache()
+        {
+          slabs.reserve(CacheBatch * 2);
+        }
+
+        ~LocalCache()
+        {
+          Instance().Spill(slabs, slabs.size());
+        }
+      };
+
+      static LocalCache&
+      Local()
+      {
+        thread_local LocalCache cache;
+        return cache;
+      }
+
+      void
+      Refill(std::vector<Slab*>& slabs)
+      {
+        std::lock_guard<std::mutex> lock{m_Mutex};
+        while (m_Free and slabs.size() < CacheBatch)
+        {
+          slabs.push_back(m_Free);
+          m_Free = m_Free->next;
+          m_NumFree--;
+        }
+      }
+
+      void
+      Spill(std::vector<Slab*>& slabs, size_t num)
+      {
+        std::lock_guard<std::mutex> lock{m_Mutex};
+        while (num-- > 0 and not slabs.empty())
+        {
+          Slab* slab = slabs.back();
+          slabs.pop_back();
+          if (m_NumFree >= MaxFree)
+          {
+            delete slab;
+            continue;
+          }
+          slab->next = m_Free;
+          m_Free = slab;
+          m_NumFree++;
+        }
+      }
+
+      std::mutex m_Mutex;
+      Slab* m_Free = nullptr;
+      size_t m_NumFree = 0;
+      BufferPoolStats m_Stats;
+    };
+
+    /// a byte buffer of at most Capacity bytes backed by a BufferPool
+    ///
+    /// copies share the same bytes by bumping a refcount, the mutable accessors copy the bytes out
+    /// of a shared buffer before handing them out so a write never shows up in another copy.
+    /// read through a const reference to avoid that copy.
+    template <size_t Capacity>
+    class PooledBuffer
+    {
+      using Pool_t = BufferPool<Capacity>;
+      using Slab_t = typename Pool_t::Slab;
+
+     public:
+      static constexpr size_t MaxSize = Capacity;
+
+      using value_type = byte_t;
+      using iterator = byte_t*;
+      using const_iterator = const byte_t*;
+
+      PooledBuffer() = default;
+
+      /// zero filled buffer of sz bytes
+      explicit PooledBuffer(size_t sz)
+      {
+        resize(sz);
+      }
+
+      /// buffer holding a copy of sz bytes at ptr
+      PooledBuffer(const byte_t* ptr, size_t sz)
+      {
+        if (sz > Capacity)
+          throw std::length_error{"pooled buffer too small"};
+        if (sz == 0)
+          return;
+        m_Slab = Pool_t::Instance().Acquire();
+        m_Size = sz;
+        std::copy_n(ptr, sz, m_Slab->data);
+      }
+
+      PooledBuffer(const PooledBuffer& other) : m_Slab{other.m_Slab}, m_Size{other.m_Size}
+      {
+        if (m_Slab)
+          m_Slab->refs.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      PooledBuffer(PooledBuffer&& other) noexcept : m_Slab{other.m_Slab}, m_Size{other.m_Size}
+      {
+        other.m_Slab = nullptr;
+        other.m_Size = 0;
+      }
+
+      PooledBuffer&
+      operator=(const PooledBuffer& other)
+      {
+        if (this != &other)
+        {
+          PooledBuffer copy{other};
+          swap(copy);
+        }
+        return *this;
+      }
+
+      PooledBuffer&
+      operator=(PooledBuffer&& other) noexcept
+      {
+        if (this != &other)
+        {
+          reset();
+          swap(other);
+        }
+        return *this;
+      }
+
+      ~PooledBuffer()
+      {
+        reset();
+      }
+
+      void
+      swap(PooledBuffer& other) noexcept
+      {
+        std::swap(m_Slab, other.m_Slab);
+        std::swap(m_Size, other.m_Size);
+      }
+
+      /// drop our reference, the buffer goes back to the pool when the last one is gone
+      void
+      reset()
+      {
+        if (m_Slab and m_Slab->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          Pool_t::Instance().Release(m_Slab);
+        m_Slab = nullptr;
+        m_Size = 0;
+      }
+
+      /// resize within the fixed capacity, new bytes are zero filled
+      void
+      resize(size_t sz)
+      {
+        const auto old = m_Size;
+        resize_for_overwrite(sz);
+        if (sz > old)
+          std::fill(m_Slab->data + old, m_Slab->data + sz, 0);
+      }
+
+      /// resize within the fixed capacity, new bytes are left as they are for the caller to write
+      void
+      resize_for_overwrite(size_t sz)
+      {
+        if (sz > Capacity)
+          throw std::length_error{"pooled buffer too small"};
+        detach();
+        if (m_Slab == nullptr)
+        {
+          if (sz == 0)
+            return;
+          m_Slab = Pool_t::Instance().Acquire();
+        }
+        m_Size = sz;
+      }
+
+      void
+      clear()
+      {
+        reset();
+      }
+
+      /// true if nobody else shares our bytes
+      bool
+      unique() const
+      {
+        return m_Slab == nullptr or m_Slab->refs.load(std::memory_order_acquire) == 1;
+      }
+
+      /// make sure we hold the only reference before writing, copies the bytes if they are shared
+      void
+      detach()
+      {
+        if (not unique())
+        {
+          PooledBuffer copy{m_Slab->data, m_Size};
+          swap(copy);
+        }
+      }
+
+      byte_t*
+      data()
+      {
+        detach();
+        return m_Slab ? m_Slab->data : nullptr;
+      }
+
+      const byte_t*
+      data() const
+      {
+        return m_Slab ? m_Slab->data : nullptr;
+      }
+
+      size_t
+      size() const
+      {
+        return m_Size;
+      }
+
+      static constexpr size_t
+      capacity()
+      {
+        return Capacity;
+      }
+
+      bool
+      empty() const
+      {
+        return m_Size == 0;
+      }
+
+      byte_t&
+      operator[](size_t idx)
+      {
+        detach();
+        return m_Slab->data[idx];
+      }
+
+      const byte_t&
+      operator[](size_t idx) const
+      {
+        return m_Slab->data[idx];
+      }
+
+      iterator
+      begin()
+      {
+        return data();
+      }
+
+      iterator
+      end()
+      {
+        return data() + m_Size;
+      }
+
+      const_iterator
+      begin() const
+      {
+        return data();
+      }
+
+      const_iterator
+      end() const
+      {
+        return data() + m_Size;
+      }
+
+      static const BufferPoolStats&
+      PoolStats()
+      {
+        return Pool_t::Instance().Stats();
+      }
+
+     private:
+      Slab_t* m_Slab = nullptr;
+      size_t m_Size = 0;
+    };
+
+  }  // namespace util
+}  // namespace llarp
+
+#endif
@@ -26,6 +26,11 @@ namespace llarp
       }
     };
 
+    /// a fixed size queue that drops what waited too long, after codel
+    ///
+    /// slots are move assigned on the way in and reset on the way out, so an item that owns a
+    /// buffer, like a net::IPPacket, moves through the queue without being copied and lets go of
+    /// its buffer as soon as it was visited or dropped. the visitor may move from the item.
     template <
         typename T,
         typename GetTime,
@@ -58,11 +63,11 @@ namespace llarp
         Lock_t lock(m_QueueMutex);
         if (m_QueueIdx == MaxSize)
           return false;
-        T* t = &m_Queue[m_QueueIdx];
-        new (t) T(std::forward<Args>(args)...);
-        if (!pred(*t))
+        T& t = m_Queue[m_QueueIdx];
+        t = T(std::forward<Args>(args)...);
+        if (!pred(t))
         {
-          t->~T();
+          t = T{};
           return false;
         }
 
@@ -81,8 +86,7 @@ namespace llarp
         Lock_t lock(m_QueueMutex);
         if (m_QueueIdx == MaxSize)
           return;
-        T* t = &m_Queue[m_QueueIdx];
-        new (t) T(std::forward<Args>(args)...);
+        m_Queue[m_QueueIdx] = T(std::forward<Args>(args)...);
         _putTime(m_Queue[m_QueueIdx]);
         if (firstPut == 0s)
           firstPut = _getTime(m_Queue[m_QueueIdx]);
@@ -110,8 +114,7 @@ namespace llarp
         if (m_QueueIdx == 1)
         {
           visitor(m_Queue[0]);
-          T* t = &m_Queue[0];
-          t->~T();
+          m_Queue[0] = T{};
           m_QueueIdx = 0;
           firstPut = 0s;
           return;
@@ -133,7 +136,7 @@ namespace llarp
             // lowest, " dropMs: ", dropMs);
             if (lowest > dropMs)
             {
-              item->~T();
+              *item = T{};
               nextTickInterval += initialIntervalMs / uint64_t(std::sqrt(++dropNum));
               firstPut = 0s;
               nextTickAt = start + nextTickInterval;
@@ -144,7 +147,7 @@ namespace llarp
             dropNum = 0;
           }
           visitor(*item);
-          item->~T();
+          *item = T{};
         }
         firstPut = 0s;
         nextTickAt = start + nextTickInterval;
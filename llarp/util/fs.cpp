@@ -7,9 +7,12 @@
 #include <sys/types.h>
 #include <system_error>
 
+#include <fstream>
+
 #ifdef WIN32
 #include <io.h>
 #else
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -120,5 +123,69 @@ namespace llarp
       return {};
 #endif
     }
+
+    MappedFile::~MappedFile()
+    {
+      Close();
+    }
+
+    bool
+    MappedFile::Open(const fs::path& fname)
+    {
+      Close();
+#ifndef WIN32
+      const int fd = ::open(fname.string().c_str(), O_RDONLY);
+      if (fd == -1)
+        return false;
+      struct stat st;
+      if (::fstat(fd, &st) == -1)
+      {
+        ::close(fd);
+        return false;
+      }
+      m_Size = st.st_size;
+      if (m_Size > 0)
+      {
+        void* ptr = ::mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+          ::close(fd);
+          m_Size = 0;
+          return false;
+        }
+        m_Data = static_cast<const byte_t*>(ptr);
+        m_Mapped = true;
+      }
+      ::close(fd);
+      return true;
+#else
+      std::ifstream f{fname.string(), std::ios::binary | std::ios::ate};
+      if (not f.is_open())
+        return false;
+      m_Contents.resize(f.tellg());
+      f.seekg(0, std::ios::beg);
+      if (not f.read(reinterpret_cast<char*>(m_Contents.data()), m_Contents.size()))
+      {
+        m_Contents.clear();
+        return false;
+      }
+      m_Data = m_Contents.data();
+      m_Size = m_Contents.size();
+      return true;
+#endif
+    }
+
+    void
+    MappedFile::Close()
+    {
+#ifndef WIN32
+      if (m_Mapped)
+        ::munmap(const_cast<byte_t*>(m_Data), m_Size);
+#endif
+      m_Mapped = false;
+      m_Data = nullptr;
+      m_Size = 0;
+      m_Contents.clear();
+    }
   }  // namespace util
 }  // namespace llarp
@@ -21,7 +21,10 @@ namespace fs = std::filesystem;
 #include <dirent.h>
 #endif
 
+#include <util/types.hpp>
+
 #include <optional>
+#include <vector>
 
 namespace llarp
 {
@@ -57,6 +60,43 @@ namespace llarp
       return T{pathname, mode};
     }
 
+    /// read only view of a whole file, mmapped where we can and read into memory elsewhere
+    class MappedFile
+    {
+     public:
+      MappedFile() = default;
+      MappedFile(const MappedFile&) = delete;
+      MappedFile&
+      operator=(const MappedFile&) = delete;
+
+      ~MappedFile();
+
+      /// map fname, returns false if it cannot be opened
+      bool
+      Open(const fs::path& fname);
+
+      void
+      Close();
+
+      const byte_t*
+      data() const
+      {
+        return m_Data;
+      }
+
+      size_t
+      size() const
+      {
+        return m_Size;
+      }
+
+     private:
+      const byte_t* m_Data = nullptr;
+      size_t m_Size = 0;
+      bool m_Mapped = false;
+      std::vector<byte_t> m_Contents;
+    };
+
     using PathVisitor = std::function<bool(const fs::path&)>;
     using PathIter = std::function<void(const fs::path&, PathVisitor)>;
 
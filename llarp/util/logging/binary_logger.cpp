@@ -0,0 +1,336 @@
+#include <util/logging/binary_logger.hpp>
+
+#include <util/logging/loglevel.hpp>
+#include <util/thread/threading.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <string>
+
+namespace llarp
+{
+  namespace
+  {
+    std::atomic<uint64_t> nextGeneration{1};
+    std::atomic<uint32_t> nextThreadID{1};
+
+    template <typename T>
+    void
+    Append(std::vector<byte_t>& out, T val)
+    {
+      const auto* ptr = reinterpret_cast<const byte_t*>(&val);
+      out.insert(out.end(), ptr, ptr + sizeof(T));
+    }
+
+    template <typename T>
+    T
+    Take(std::string_view& data)
+    {
+      T val;
+      std::memcpy(&val, data.data(), sizeof(T));
+      data.remove_prefix(sizeof(T));
+      return val;
+    }
+
+    /// offsets into an entry as a logging thread writes it
+    constexpr size_t EntryTimestampAt = 0;
+    constexpr size_t EntryTagAt = sizeof(uint64_t) + sizeof(uint8_t);
+    constexpr size_t EntryRestAt = EntryTagAt + sizeof(uint64_t);
+  }  // namespace
+
+  BinaryLogStream::BinaryLogStream(FILE* f, std::string nodename, bool closeFile)
+      : m_Generation{nextGeneration++}, m_File{f}, m_Close{closeFile}
+  {
+    std::fwrite(binlog::Magic.data(), 1, binlog::Magic.size(), m_File);
+    {
+      std::lock_guard<std::mutex> lock{m_DrainMutex};
+      WriteString(binlog::NodeNameID, nodename);
+      std::fwrite(m_Out.data(), 1, m_Out.size(), m_File);
+      m_Out.clear();
+    }
+    m_Thread = std::thread{[this]() {
+      util::SetThreadName("llarp-binlog");
+      std::unique_lock<std::mutex> lock{m_StopMutex};
+      while (not m_StopCond.wait_for(lock, DrainInterval, [this]() { return m_Stop; }))
+      {
+        lock.unlock();
+        Drain();
+        lock.lock();
+      }
+    }};
+  }
+
+  BinaryLogStream::~BinaryLogStream()
+  {
+    {
+      std::lock_guard<std::mutex> lock{m_StopMutex};
+      m_Stop = true;
+    }
+    m_StopCond.notify_one();
+    m_Thread.join();
+    Drain();
+    if (m_Close)
+      std::fclose(m_File);
+  }
+
+  BinaryLogStream::LocalState&
+  BinaryLogStream::Local()
+  {
+    thread_local LocalState local;
+    return local;
+  }
+
+  void
+  BinaryLogStream::Register(LocalState& local)
+  {
+    if (local.threadID == 0)
+      local.threadID = nextThreadID++;
+    local.ring = std::make_shared<binlog::Ring>(RingSize);
+    local.generation = m_Generation;
+    std::lock_guard<std::mutex> lock{m_RingsMutex};
+    m_Rings.emplace_back(local.ring);
+  }
+
+  void
+  BinaryLogStream::AppendLog(
+      LogLevel lvl, const char* fname, int lineno, const std::string&, const std::string msg)
+  {
+    Record(lvl, fname, lineno, msg);
+  }
+
+  void
+  BinaryLogStream::ImmediateFlush()
+  {
+    Drain();
+  }
+
+  void
+  BinaryLogStream::WriteString(uint32_t id, std::string_view str)
+  {
+    str = str.substr(0, std::numeric_limits<uint16_t>::max());
+    m_Out.push_back(binlog::eString);
+    Append(m_Out, id);
+    Append(m_Out, static_cast<uint16_t>(str.size()));
+    m_Out.insert(m_Out.end(), str.begin(), str.end());
+  }
+
+  void
+  BinaryLogStream::Drain()
+  {
+    std::lock_guard<std::mutex> lock{m_DrainMutex};
+    std::vector<std::shared_ptr<binlog::Ring>> rings;
+    {
+      std::lock_guard<std::mutex> ringsLock{m_RingsMutex};
+      // rings only we still hold belong to threads that exited
+      m_Rings.erase(
+          std::remove_if(
+              m_Rings.begin(),
+              m_Rings.end(),
+              [](const auto& ring) { return ring.use_count() == 1 and ring->Empty(); }),
+          m_Rings.end());
+      rings = m_Rings;
+    }
+
+    // each ring is in order, sort what the threads logged since the last drain by time so the
+    // file reads in order
+    std::vector<byte_t> entries;
+    std::vector<std::pair<uint64_t, size_t>> order;
+    for (const auto& ring : rings)
+    {
+      ring->Drain([&](std::string_view entry) {
+        std::string_view header{entry};
+        header.remove_prefix(EntryTimestampAt);
+        order.emplace_back(Take<uint64_t>(header), entries.size());
+        Append(entries, static_cast<uint16_t>(entry.size()));
+        entries.insert(entries.end(), entry.begin(), entry.end());
+      });
+    }
+    std::stable_sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+
+    for (const auto& [timestamp, offset] : order)
+    {
+      uint16_t len;
+      std::memcpy(&len, entries.data() + offset, sizeof(len));
+      const std::string_view entry{
+          reinterpret_cast<const char*>(entries.data() + offset + sizeof(len)), len};
+      std::string_view tagAt = entry.substr(EntryTagAt);
+      const auto tag = Take<uint64_t>(tagAt);
+      auto itr = m_Tags.find(tag);
+      if (itr == m_Tags.end())
+      {
+        itr = m_Tags.emplace(tag, m_Tags.size() + 1).first;
+        WriteString(itr->second, reinterpret_cast<const char*>(tag));
+      }
+      // the tag pointer becomes the shorter string id
+      m_Out.push_back(binlog::eEntry);
+      Append(m_Out, static_cast<uint16_t>(len - sizeof(uint64_t) + sizeof(uint32_t)));
+      m_Out.insert(m_Out.end(), entry.begin(), entry.begin() + EntryTagAt);
+      Append(m_Out, itr->second);
+      m_Out.insert(m_Out.end(), entry.begin() + EntryRestAt, entry.end());
+    }
+
+    if (const auto dropped = m_Dropped.exchange(0))
+    {
+      m_Out.push_back(binlog::eDropped);
+      Append(m_Out, dropped);
+    }
+    if (m_Out.empty())
+      return;
+    std::fwrite(m_Out.data(), 1, m_Out.size(), m_File);
+    std::fflush(m_File);
+    m_Out.clear();
+  }
+
+  namespace
+  {
+    bool
+    Read(FILE* in, void* dst, size_t len)
+    {
+      return std::fread(dst, 1, len, in) == len;
+    }
+
+    template <typename T>
+    bool
+    Read(FILE* in, T& val)
+    {
+      return Read(in, &val, sizeof(T));
+    }
+
+    void
+    WriteTimestamp(std::ostream& out, uint64_t ms)
+    {
+      const std::time_t secs = ms / 1000;
+      std::tm tm{};
+#ifdef _WIN32
+      gmtime_s(&tm, &secs);
+#else
+      gmtime_r(&secs, &tm);
+#endif
+      out << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "." << std::setfill('0') << std::setw(3)
+          << (ms % 1000) << std::setfill(' ') << " UTC";
+    }
+
+    /// render the args of an entry the way operator<< would have
+    bool
+    WriteArgs(std::ostream& out, std::string_view args, uint8_t numArgs)
+    {
+      for (uint8_t idx = 0; idx < numArgs; ++idx)
+      {
+        if (args.empty())
+          return false;
+        const auto kind = Take<uint8_t>(args);
+        switch (kind)
+        {
+          case binlog::eSigned:
+            if (args.size() < sizeof(int64_t))
+              return false;
+            out << Take<int64_t>(args);
+            break;
+          case binlog::eUnsigned:
+            if (args.size() < sizeof(uint64_t))
+              return false;
+            out << Take<uint64_t>(args);
+            break;
+          case binlog::eDouble:
+            if (args.size() < sizeof(double))
+              return false;
+            out << Take<double>(args);
+            break;
+          case binlog::eText:
+          {
+            if (args.size() < sizeof(uint16_t))
+              return false;
+            const auto len = Take<uint16_t>(args);
+            if (args.size() < len)
+              return false;
+            out << args.substr(0, len);
+            args.remove_prefix(len);
+            break;
+          }
+          default:
+            return false;
+        }
+      }
+      return true;
+    }
+  }  // namespace
+
+  bool
+  DecodeBinaryLog(FILE* in, std::ostream& out)
+  {
+    std::string magic(binlog::Magic.size(), '\0');
+    if (not Read(in, magic.data(), magic.size()) or magic != binlog::Magic)
+      return false;
+
+    std::unordered_map<uint32_t, std::string> strings;
+    const auto lookup = [&strings](uint32_t id) -> std::string_view {
+      auto itr = strings.find(id);
+      return itr == strings.end() ? std::string_view{"?"} : std::string_view{itr->second};
+    };
+    std::string body;
+    uint8_t type;
+    while (Read(in, type))
+    {
+      switch (type)
+      {
+        case binlog::eString:
+        {
+          uint32_t id;
+          uint16_t len;
+          if (not(Read(in, id) and Read(in, len)))
+            return false;
+          std::string str(len, '\0');
+          if (not Read(in, str.data(), len))
+            return false;
+          strings[id] = std::move(str);
+          break;
+        }
+        case binlog::eEntry:
+        {
+          uint16_t len;
+          if (not Read(in, len))
+            return false;
+          body.resize(len);
+          if (not Read(in, body.data(), len))
+            return false;
+          std::string_view entry{body};
+          constexpr size_t HeaderSize = sizeof(uint64_t) + sizeof(uint8_t) + sizeof(uint32_t) * 3
+              + sizeof(uint8_t);
+          if (entry.size() < HeaderSize)
+            return false;
+          const auto timestamp = Take<uint64_t>(entry);
+          const auto lvl = static_cast<LogLevel>(Take<uint8_t>(entry));
+          const auto tag = Take<uint32_t>(entry);
+          const auto line = Take<uint32_t>(entry);
+          const auto thread = Take<uint32_t>(entry);
+          const auto numArgs = Take<uint8_t>(entry);
+          // same layout as FileLogStream::PreLog
+          out << "[" << LogLevelToString(lvl) << "] [" << lookup(binlog::NodeNameID) << "]("
+              << thread << ") ";
+          WriteTimestamp(out, timestamp);
+          out << " " << lookup(tag) << ":" << line << "\t";
+          if (not WriteArgs(out, entry, numArgs))
+            return false;
+          out << "\n";
+          break;
+        }
+        case binlog::eDropped:
+        {
+          uint64_t dropped;
+          if (not Read(in, dropped))
+            return false;
+          out << "-- " << dropped << " log entries dropped --\n";
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+    return std::feof(in);
+  }
+}  // namespace llarp
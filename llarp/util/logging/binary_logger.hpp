@@ -0,0 +1,364 @@
+#ifndef LLARP_UTIL_BINARY_LOGGER_HPP
+#define LLARP_UTIL_BINARY_LOGGER_HPP
+
+#include <util/logging/logstream.hpp>
+#include <util/logging/logger_internal.hpp>
+#include <util/time.hpp>
+#include <util/types.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  /// binary log file layout, shared by BinaryLogStream and DecodeBinaryLog
+  namespace binlog
+  {
+    /// at the start of every binary log file
+    constexpr std::string_view Magic{"LLBINLG1"};
+
+    /// what follows the one byte type of each record in the file
+    enum RecordType : byte_t
+    {
+      /// u32 id, u16 length, bytes: a string that later entries refer to by id
+      eString = 1,
+      /// u16 length then the entry: u64 ms since epoch, u8 level, u32 tag id, u32 line,
+      /// u32 thread id, u8 number of args, args
+      eEntry = 2,
+      /// u64: how many entries were dropped because a thread's ring was full
+      eDropped = 3,
+    };
+
+    /// one byte kind in front of every arg of an entry
+    enum ArgKind : byte_t
+    {
+      /// i64
+      eSigned = 'i',
+      /// u64
+      eUnsigned = 'u',
+      /// f64
+      eDouble = 'f',
+      /// u16 length, bytes
+      eText = 's',
+    };
+
+    /// string id 0 is always the node name
+    constexpr uint32_t NodeNameID = 0;
+
+    /// largest entry we encode, longer strings are cut short
+    constexpr size_t MaxEntrySize = 4096;
+
+    /// builds one entry in a fixed buffer on the logging thread
+    class EntryWriter
+    {
+     public:
+      void
+      Header(uint64_t timestamp, LogLevel lvl, const char* tag, uint32_t line, uint32_t thread)
+      {
+        m_Size = 0;
+        m_NumArgs = 0;
+        Put(timestamp);
+        Put(static_cast<uint8_t>(lvl));
+        // tags are string literals, the drain thread turns the pointer into a string id
+        Put(reinterpret_cast<uint64_t>(tag));
+        Put(line);
+        Put(thread);
+        m_NumArgsAt = m_Size;
+        Put(uint8_t{0});
+      }
+
+      void
+      Signed(int64_t val)
+      {
+        Arg(eSigned, val);
+      }
+
+      void
+      Unsigned(uint64_t val)
+      {
+        Arg(eUnsigned, val);
+      }
+
+      void
+      Double(double val)
+      {
+        Arg(eDouble, val);
+      }
+
+      void
+      Text(std::string_view str)
+      {
+        if (m_Size + 1 + sizeof(uint16_t) > m_Buf.size() or m_NumArgs == 255)
+          return;
+        const auto len = static_cast<uint16_t>(
+            std::min(str.size(), m_Buf.size() - m_Size - 1 - sizeof(uint16_t)));
+        Put(eText);
+        Put(len);
+        std::memcpy(m_Buf.data() + m_Size, str.data(), len);
+        m_Size += len;
+        m_NumArgs++;
+      }
+
+      /// the entry so far, with the arg count filled in
+      std::string_view
+      Finish()
+      {
+        m_Buf[m_NumArgsAt] = m_NumArgs;
+        return {reinterpret_cast<const char*>(m_Buf.data()), m_Size};
+      }
+
+     private:
+      template <typename T>
+      void
+      Arg(ArgKind kind, T val)
+      {
+        if (m_Size + 1 + sizeof(T) > m_Buf.size() or m_NumArgs == 255)
+          return;
+        Put(kind);
+        Put(val);
+        m_NumArgs++;
+      }
+
+      template <typename T>
+      void
+      Put(T val)
+      {
+        std::memcpy(m_Buf.data() + m_Size, &val, sizeof(T));
+        m_Size += sizeof(T);
+      }
+
+      std::array<byte_t, MaxEntrySize> m_Buf;
+      size_t m_Size = 0;
+      size_t m_NumArgsAt = 0;
+      uint8_t m_NumArgs = 0;
+    };
+
+    /// numbers and strings are copied as they are, anything else is formatted right away
+    template <typename T>
+    void
+    EncodeArg(EntryWriter& writer, const T& arg)
+    {
+      using Arg_t = std::decay_t<T>;
+      if constexpr (
+          std::is_same_v<Arg_t, char> or std::is_same_v<Arg_t, signed char>
+          or std::is_same_v<Arg_t, unsigned char>)
+        writer.Text(std::string_view{reinterpret_cast<const char*>(&arg), 1});
+      else if constexpr (std::is_same_v<Arg_t, bool>)
+        writer.Unsigned(arg);
+      else if constexpr (std::is_integral_v<Arg_t> and std::is_signed_v<Arg_t>)
+        writer.Signed(arg);
+      else if constexpr (std::is_integral_v<Arg_t>)
+        writer.Unsigned(arg);
+      else if constexpr (std::is_floating_point_v<Arg_t>)
+        writer.Double(arg);
+      else if constexpr (std::is_array_v<T>)
+        writer.Text(std::string_view{arg});
+      else if constexpr (std::is_same_v<Arg_t, const char*> or std::is_same_v<Arg_t, char*>)
+        writer.Text(arg ? std::string_view{arg} : std::string_view{"(null)"});
+      else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        writer.Text(std::string_view{arg});
+      else
+      {
+        LogLineBuffer buf;
+        *buf.stream << arg;
+        writer.Text(buf.stream->str());
+      }
+    }
+
+    /// byte ring written by one thread and drained by the log thread, no locks
+    class Ring
+    {
+     public:
+      explicit Ring(size_t size) : m_Buf(size)
+      {}
+
+      /// append a length prefixed entry, false if it does not fit
+      bool
+      Push(std::string_view entry)
+      {
+        const auto head = m_Head.load(std::memory_order_relaxed);
+        const auto tail = m_Tail.load(std::memory_order_acquire);
+        const uint16_t len = entry.size();
+        if (m_Buf.size() - (head - tail) < sizeof(len) + len)
+          return false;
+        Copy(head, reinterpret_cast<const byte_t*>(&len), sizeof(len));
+        Copy(head + sizeof(len), reinterpret_cast<const byte_t*>(entry.data()), len);
+        m_Head.store(head + sizeof(len) + len, std::memory_order_release);
+        return true;
+      }
+
+      /// hand every entry written so far to visit
+      template <typename Visit_t>
+      void
+      Drain(Visit_t visit)
+      {
+        auto tail = m_Tail.load(std::memory_order_relaxed);
+        const auto head = m_Head.load(std::memory_order_acquire);
+        std::array<byte_t, MaxEntrySize> entry;
+        while (tail != head)
+        {
+          uint16_t len;
+          Read(tail, reinterpret_cast<byte_t*>(&len), sizeof(len));
+          Read(tail + sizeof(len), entry.data(), len);
+          tail += sizeof(len) + len;
+          visit(std::string_view{reinterpret_cast<const char*>(entry.data()), len});
+        }
+        m_Tail.store(tail, std::memory_order_release);
+      }
+
+      bool
+      Empty() const
+      {
+        return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire);
+      }
+
+     private:
+      void
+      Copy(size_t pos, const byte_t* src, size_t len)
+      {
+        const auto at = pos % m_Buf.size();
+        const auto first = std::min(len, m_Buf.size() - at);
+        std::memcpy(m_Buf.data() + at, src, first);
+        std::memcpy(m_Buf.data(), src + first, len - first);
+      }
+
+      void
+      Read(size_t pos, byte_t* dst, size_t len) const
+      {
+        const auto at = pos % m_Buf.size();
+        const auto first = std::min(len, m_Buf.size() - at);
+        std::memcpy(dst, m_Buf.data() + at, first);
+        std::memcpy(dst + first, m_Buf.data(), len - first);
+      }
+
+      std::vector<byte_t> m_Buf;
+      /// bytes ever written and read, only ever go up
+      alignas(64) std::atomic<size_t> m_Head{0};
+      alignas(64) std::atomic<size_t> m_Tail{0};
+    };
+  }  // namespace binlog
+
+  /// log stream that writes compact binary entries, see binlog for the layout
+  ///
+  /// each logging thread copies the raw args of an entry into a ring of its own and moves on, a
+  /// background thread drains the rings into the file. nothing is formatted as text until the
+  /// file is decoded, except args that are neither numbers nor strings. if a thread logs faster
+  /// than the file is written its entries are dropped and counted instead of blocking it.
+  struct BinaryLogStream : public ILogStream
+  {
+    /// bytes of ring each logging thread gets
+    static constexpr size_t RingSize = 256 * 1024;
+    /// how often the background thread drains the rings
+    static constexpr auto DrainInterval = 50ms;
+
+    BinaryLogStream(FILE* f, std::string nodename, bool closeFile = true);
+
+    ~BinaryLogStream() override;
+
+    template <typename... TArgs>
+    void
+    Record(LogLevel lvl, const char* fname, int lineno, TArgs&&... args)
+    {
+      auto& local = Local();
+      if (local.generation != m_Generation)
+        Register(local);
+      auto& writer = local.writer;
+      writer.Header(time_now_ms().count(), lvl, fname, lineno, local.threadID);
+      (binlog::EncodeArg(writer, args), ...);
+      if (not local.ring->Push(writer.Finish()))
+        m_Dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    BinaryLogStream*
+    Binary() override
+    {
+      return this;
+    }
+
+    void
+    PreLog(std::stringstream&, LogLevel, const char*, int, const std::string&) const override
+    {}
+
+    void
+    Print(LogLevel, const char*, const std::string&) override
+    {}
+
+    void
+    PostLog(std::stringstream&) const override
+    {}
+
+    /// lines that were formatted already go in as a single string arg
+    void
+    AppendLog(
+        LogLevel lvl,
+        const char* fname,
+        int lineno,
+        const std::string& nodename,
+        const std::string msg) override;
+
+    void
+    ImmediateFlush() override;
+
+    void
+    Tick(llarp_time_t) override
+    {}
+
+   private:
+    struct LocalState
+    {
+      uint64_t generation = 0;
+      uint32_t threadID = 0;
+      std::shared_ptr<binlog::Ring> ring;
+      binlog::EntryWriter writer;
+    };
+
+    static LocalState&
+    Local();
+
+    /// give this thread a ring of its own
+    void
+    Register(LocalState& local);
+
+    /// write out everything in the rings, only ever runs on one thread at a time
+    void
+    Drain() EXCLUDES(m_DrainMutex);
+
+    void
+    WriteString(uint32_t id, std::string_view str);
+
+    const uint64_t m_Generation;
+    FILE* const m_File;
+    const bool m_Close;
+
+    std::mutex m_RingsMutex;
+    std::vector<std::shared_ptr<binlog::Ring>> m_Rings GUARDED_BY(m_RingsMutex);
+    std::atomic<uint64_t> m_Dropped{0};
+
+    std::mutex m_DrainMutex;
+    /// tag pointers we wrote a string for, and the id it got
+    std::unordered_map<uint64_t, uint32_t> m_Tags GUARDED_BY(m_DrainMutex);
+    std::vector<byte_t> m_Out GUARDED_BY(m_DrainMutex);
+
+    std::mutex m_StopMutex;
+    std::condition_variable m_StopCond;
+    bool m_Stop GUARDED_BY(m_StopMutex) = false;
+    std::thread m_Thread;
+  };
+
+  /// turn a binary log file back into text lines like the file log type writes, returns false
+  /// if in does not hold a binary log or ends in the middle of a record
+  bool
+  DecodeBinaryLog(FILE* in, std::ostream& out);
+}  // namespace llarp
+
+#endif
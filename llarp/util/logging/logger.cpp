@@ -40,6 +40,8 @@ namespace llarp
       return LogType::Json;
     else if (str == "syslog")
       return LogType::Syslog;
+    else if (str == "binary")
+      return LogType::Binary;
 
     return LogType::Unknown;
   }
@@ -167,6 +169,13 @@ namespace llarp
         LogContext::Instance().logStream = std::make_unique<SysLogStream>();
 #endif
         break;
+      case LogType::Binary:
+        LogInfo("Switching logger to binary with file: ", file);
+        std::cout << std::flush;
+
+        LogContext::Instance().logStream =
+            std::make_unique<BinaryLogStream>(logfile, nickname, logfile != stdout);
+        break;
     }
   }
 
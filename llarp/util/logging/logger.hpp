@@ -3,9 +3,14 @@
 
 #include <memory>
 #include <util/time.hpp>
+#include <util/logging/binary_logger.hpp>
 #include <util/logging/logstream.hpp>
 #include <util/logging/logger_internal.hpp>
 
+#ifndef LOKINET_MIN_LOG_LEVEL
+#define LOKINET_MIN_LOG_LEVEL 0
+#endif
+
 namespace llarp
 {
   enum class LogType
@@ -14,6 +19,7 @@ namespace llarp
     File,
     Json,
     Syslog,
+    Binary,
   };
   LogType
   LogTypeFromString(const std::string&);
@@ -80,6 +86,19 @@ namespace llarp
   LogLevel
   GetLogLevel();
 
+  /// log statements below this level are compiled out, set with -DMIN_LOG_LEVEL in cmake
+  constexpr LogLevel MinLogLevel = static_cast<LogLevel>(LOKINET_MIN_LOG_LEVEL);
+
+  /** internal, checked by the log macros before any of the arguments are evaluated */
+  inline bool
+  _LogEnabled(LogLevel lvl) noexcept
+  {
+    if (lvl < MinLogLevel)
+      return false;
+    const auto& log = LogContext::Instance();
+    return log.curLevel <= lvl and log.logStream != nullptr;
+  }
+
   /** internal */
   template <typename... TArgs>
   inline static void
@@ -88,29 +107,44 @@ namespace llarp
     auto& log = LogContext::Instance();
     if (log.curLevel > lvl || log.logStream == nullptr)
       return;
-    std::stringstream ss;
-    LogAppend(ss, std::forward<TArgs>(args)...);
-    log.logStream->AppendLog(lvl, fname, lineno, log.nodeName, ss.str());
+    if (auto* binary = log.logStream->Binary())
+    {
+      binary->Record(lvl, fname, lineno, std::forward<TArgs>(args)...);
+      return;
+    }
+    std::string msg;
+    {
+      LogLineBuffer buf;
+      LogAppend(*buf.stream, std::forward<TArgs>(args)...);
+      msg = buf.stream->str();
+    }
+    log.logStream->AppendLog(lvl, fname, lineno, log.nodeName, std::move(msg));
   }
 }  // namespace llarp
 
-#define LogTrace(...) _Log(llarp::eLogTrace, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogDebug(...) _Log(llarp::eLogDebug, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogInfo(...) _Log(llarp::eLogInfo, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogWarn(...) _Log(llarp::eLogWarn, LOG_TAG, __LINE__, __VA_ARGS__)
-#define LogError(...) _Log(llarp::eLogError, LOG_TAG, __LINE__, __VA_ARGS__)
-
-#define LogTraceTag(tag, ...) _Log(llarp::eLogTrace, tag, __LINE__, __VA_ARGS__)
-#define LogDebugTag(tag, ...) _Log(llarp::eLogDebug, tag, __LINE__, __VA_ARGS__)
-#define LogInfoTag(tag, ...) _Log(llarp::eLogInfo, tag, __LINE__, __VA_ARGS__)
-#define LogWarnTag(tag, ...) _Log(llarp::eLogWarn, tag, __LINE__, __VA_ARGS__)
-#define LogErrorTag(tag, ...) _Log(llarp::eLogError, tag, __LINE__, __VA_ARGS__)
-
-#define LogTraceExplicit(tag, line, ...) _Log(llarp::eLogTrace, tag, line, __VA_ARGS__)
-#define LogDebugExplicit(tag, line, ...) _Log(llarp::eLogDebug, tag, line, __VA_ARGS__)
-#define LogInfoExplicit(tag, line, ...) _Log(llarp::eLogInfo, tag, line __VA_ARGS__)
-#define LogWarnExplicit(tag, line, ...) _Log(llarp::eLogWarn, tag, line, __VA_ARGS__)
-#define LogErrorExplicit(tag, line, ...) _Log(llarp::eLogError, tag, line, __VA_ARGS__)
+// the level check comes first so arguments are only evaluated for lines that get logged, and
+// for levels below MinLogLevel the whole statement is dead code. the expansion has to stay a
+// single expression that still works behind a llarp:: qualifier.
+#define _LogIfEnabled(lvl, tag, line, ...) \
+  _LogEnabled(lvl) ? _Log(lvl, tag, line, __VA_ARGS__) : static_cast<void>(0)
+
+#define LogTrace(...) _LogIfEnabled(llarp::eLogTrace, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogDebug(...) _LogIfEnabled(llarp::eLogDebug, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogInfo(...) _LogIfEnabled(llarp::eLogInfo, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogWarn(...) _LogIfEnabled(llarp::eLogWarn, LOG_TAG, __LINE__, __VA_ARGS__)
+#define LogError(...) _LogIfEnabled(llarp::eLogError, LOG_TAG, __LINE__, __VA_ARGS__)
+
+#define LogTraceTag(tag, ...) _LogIfEnabled(llarp::eLogTrace, tag, __LINE__, __VA_ARGS__)
+#define LogDebugTag(tag, ...) _LogIfEnabled(llarp::eLogDebug, tag, __LINE__, __VA_ARGS__)
+#define LogInfoTag(tag, ...) _LogIfEnabled(llarp::eLogInfo, tag, __LINE__, __VA_ARGS__)
+#define LogWarnTag(tag, ...) _LogIfEnabled(llarp::eLogWarn, tag, __LINE__, __VA_ARGS__)
+#define LogErrorTag(tag, ...) _LogIfEnabled(llarp::eLogError, tag, __LINE__, __VA_ARGS__)
+
+#define LogTraceExplicit(tag, line, ...) _LogIfEnabled(llarp::eLogTrace, tag, line, __VA_ARGS__)
+#define LogDebugExplicit(tag, line, ...) _LogIfEnabled(llarp::eLogDebug, tag, line, __VA_ARGS__)
+#define LogInfoExplicit(tag, line, ...) _LogIfEnabled(llarp::eLogInfo, tag, line, __VA_ARGS__)
+#define LogWarnExplicit(tag, line, ...) _LogIfEnabled(llarp::eLogWarn, tag, line, __VA_ARGS__)
+#define LogErrorExplicit(tag, line, ...) _LogIfEnabled(llarp::eLogError, tag, line, __VA_ARGS__)
 
 #ifndef LOG_TAG
 #define LOG_TAG "default"
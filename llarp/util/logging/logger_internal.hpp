@@ -4,6 +4,7 @@
 #include <util/time.hpp>
 
 #include <ctime>
+#include <optional>
 #include <sstream>
 #include <util/thread/threading.hpp>
 
@@ -22,6 +23,58 @@ namespace llarp
     LogAppend(ss, std::forward<TArgs>(args)...);
   }
 
+  /// the stream a log line is formatted in, one is kept per thread and reused so logging does
+  /// not construct a stringstream every line. a line logged while another is being formatted on
+  /// the same thread gets a stream of its own.
+  class LogLineBuffer
+  {
+   public:
+    LogLineBuffer()
+    {
+      auto& shared = Shared();
+      if (shared.busy)
+      {
+        m_Own.emplace();
+        stream = &*m_Own;
+        return;
+      }
+      shared.busy = true;
+      shared.stream.str(std::string{});
+      shared.stream.clear();
+      stream = &shared.stream;
+      m_Shared = &shared;
+    }
+
+    ~LogLineBuffer()
+    {
+      if (m_Shared)
+        m_Shared->busy = false;
+    }
+
+    LogLineBuffer(const LogLineBuffer&) = delete;
+    LogLineBuffer&
+    operator=(const LogLineBuffer&) = delete;
+
+    std::stringstream* stream;
+
+   private:
+    struct SharedStream
+    {
+      std::stringstream stream;
+      bool busy = false;
+    };
+
+    static SharedStream&
+    Shared()
+    {
+      thread_local SharedStream shared;
+      return shared;
+    }
+
+    SharedStream* m_Shared = nullptr;
+    std::optional<std::stringstream> m_Own;
+  };
+
   inline std::string
   thread_id_string()
   {
@@ -1,6 +1,7 @@
 #ifndef LLARP_UTIL_LOG_STREAM_HPP
 #define LLARP_UTIL_LOG_STREAM_HPP
 #include <util/logging/loglevel.hpp>
+#include <util/logging/logger_internal.hpp>
 
 #include <util/time.hpp>
 
@@ -10,11 +11,20 @@
 
 namespace llarp
 {
+  struct BinaryLogStream;
+
   /// logger stream interface
   struct ILogStream
   {
     virtual ~ILogStream() = default;
 
+    /// streams that take raw args instead of formatted lines return themselves
+    virtual BinaryLogStream*
+    Binary()
+    {
+      return nullptr;
+    }
+
     virtual void
     PreLog(
         std::stringstream& out,
@@ -37,11 +47,15 @@ namespace llarp
         const std::string& nodename,
         const std::string msg)
     {
-      std::stringstream ss;
-      PreLog(ss, lvl, fname, lineno, nodename);
-      ss << msg;
-      PostLog(ss);
-      Print(lvl, fname, ss.str());
+      std::string line;
+      {
+        LogLineBuffer buf;
+        PreLog(*buf.stream, lvl, fname, lineno, nodename);
+        *buf.stream << msg;
+        PostLog(*buf.stream);
+        line = buf.stream->str();
+      }
+      Print(lvl, fname, line);
     }
 
     /// A blocking call to flush to disk. Should only be called in rare circumstances.
@@ -0,0 +1,261 @@
+#ifndef LLARP_UTIL_REPLAY_FILTER_HPP
+#define LLARP_UTIL_REPLAY_FILTER_HPP
+
+#include <util/bits.hpp>
+#include <util/time.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// replay filter for increasing sequence numbers, a bitmap of the last Bits numbers below
+    /// the highest one we saw. anything older than that counts as seen.
+    template <size_t Bits>
+    class SequenceReplayFilter
+    {
+      static_assert(Bits % 64 == 0, "window must be whole words");
+
+     public:
+      /// was seq seen already, or is it too old to tell?
+      bool
+      Contains(uint64_t seq) const
+      {
+        if (m_Empty or seq > m_Highest)
+          return false;
+        if (m_Highest - seq >= Bits)
+          return true;
+        return m_Words[Word(seq)] & Mask(seq);
+      }
+
+      /// mark seq as seen, returns false if it was seen or is too old
+      bool
+      Insert(uint64_t seq)
+      {
+        if (Contains(seq))
+          return false;
+        if (m_Empty or seq > m_Highest)
+          Slide(seq);
+        m_Words[Word(seq)] |= Mask(seq);
+        return true;
+      }
+
+      /// how many numbers in the window are marked
+      size_t
+      Size() const
+      {
+        size_t sz = 0;
+        for (const auto word : m_Words)
+          sz += bits::count_bits(word);
+        return sz;
+      }
+
+     private:
+      static constexpr size_t Words = Bits / 64;
+
+      static size_t
+      Word(uint64_t seq)
+      {
+        return (seq / 64) % Words;
+      }
+
+      static uint64_t
+      Mask(uint64_t seq)
+      {
+        return uint64_t{1} << (seq % 64);
+      }
+
+      /// move the window up so seq is the highest, forgetting what falls off the bottom
+      void
+      Slide(uint64_t seq)
+      {
+        if (m_Empty or seq - m_Highest >= Bits)
+          m_Words.fill(0);
+        else
+        {
+          for (uint64_t cleared = m_Highest + 1; cleared <= seq; ++cleared)
+            m_Words[Word(cleared)] &= ~Mask(cleared);
+        }
+        m_Highest = seq;
+        m_Empty = false;
+      }
+
+      std::array<uint64_t, Words> m_Words{};
+      uint64_t m_Highest = 0;
+      bool m_Empty = true;
+    };
+
+    /// replay filter for random values like nonces, remembers each value for at least one
+    /// interval and at most two
+    ///
+    /// values go into the current of two generations, when the interval is up the older one
+    /// is dropped and a new one started, so expiry never walks the entries. each generation is
+    /// an open addressing table of the first 8 bytes of each value, a false positive needs
+    /// two random values to share those.
+    template <typename Val_t>
+    class NonceReplayFilter
+    {
+      static_assert(Val_t::SIZE >= sizeof(uint64_t), "values too small to fingerprint");
+
+     public:
+      using Time_t = std::chrono::milliseconds;
+
+      explicit NonceReplayFilter(Time_t interval = 5s) : m_Interval{interval}
+      {}
+
+      bool
+      Contains(const Val_t& v) const
+      {
+        const auto fp = Fingerprint(v);
+        return m_Current.Contains(fp) or m_Previous.Contains(fp);
+      }
+
+      /// return true if inserted
+      /// return false if seen before
+      bool
+      Insert(const Val_t& v)
+      {
+        const auto fp = Fingerprint(v);
+        if (m_Previous.Contains(fp))
+          return false;
+        return m_Current.Insert(fp);
+      }
+
+      /// start a new generation once the current one is an interval old
+      void
+      Decay(Time_t now = 0s)
+      {
+        if (now == 0s)
+          now = llarp::time_now_ms();
+        if (m_StartedAt == 0s)
+          m_StartedAt = now;
+        if (now < m_StartedAt + m_Interval)
+          return;
+        // size the new generation for the traffic the last one saw
+        m_Previous = std::move(m_Current);
+        m_Current = Generation{m_Previous.Size()};
+        m_StartedAt = now;
+      }
+
+      bool
+      Empty() const
+      {
+        return m_Current.Size() == 0 and m_Previous.Size() == 0;
+      }
+
+      /// bytes of table memory held
+      size_t
+      MemoryUsage() const
+      {
+        return m_Current.MemoryUsage() + m_Previous.MemoryUsage();
+      }
+
+     private:
+      static uint64_t
+      Fingerprint(const Val_t& v)
+      {
+        uint64_t fp;
+        std::memcpy(&fp, v.data(), sizeof(fp));
+        // zero marks an empty slot
+        return fp ? fp : 1;
+      }
+
+      /// open addressing set of fingerprints with linear probing, at most half full
+      class Generation
+      {
+       public:
+        explicit Generation(size_t expected = 0)
+        {
+          size_t sz = MinSlots;
+          while (sz < expected * 2)
+            sz *= 2;
+          m_Slots.resize(sz);
+        }
+
+        bool
+        Contains(uint64_t fp) const
+        {
+          if (m_Slots.empty())
+            return false;
+          const auto mask = m_Slots.size() - 1;
+          for (auto idx = Index(fp); m_Slots[idx]; idx = (idx + 1) & mask)
+          {
+            if (m_Slots[idx] == fp)
+              return true;
+          }
+          return false;
+        }
+
+        bool
+        Insert(uint64_t fp)
+        {
+          if ((m_Size + 1) * 2 > m_Slots.size())
+            Grow();
+          const auto mask = m_Slots.size() - 1;
+          auto idx = Index(fp);
+          for (; m_Slots[idx]; idx = (idx + 1) & mask)
+          {
+            if (m_Slots[idx] == fp)
+              return false;
+          }
+          m_Slots[idx] = fp;
+          m_Size++;
+          return true;
+        }
+
+        size_t
+        Size() const
+        {
+          return m_Size;
+        }
+
+        size_t
+        MemoryUsage() const
+        {
+          return m_Slots.capacity() * sizeof(uint64_t);
+        }
+
+       private:
+        static constexpr size_t MinSlots = 16;
+
+        /// values may be picked by whoever sends them, so spread them with a per process key
+        /// to keep probe chains short
+        size_t
+        Index(uint64_t fp) const
+        {
+          static const uint64_t key = std::random_device{}() | (uint64_t{std::random_device{}()} << 32);
+          return ((fp ^ key) * 0x9e3779b97f4a7c15ULL) >> 32 & (m_Slots.size() - 1);
+        }
+
+        void
+        Grow()
+        {
+          std::vector<uint64_t> slots(std::max(m_Slots.size() * 2, MinSlots));
+          std::swap(slots, m_Slots);
+          m_Size = 0;
+          for (const auto fp : slots)
+          {
+            if (fp)
+              Insert(fp);
+          }
+        }
+
+        std::vector<uint64_t> m_Slots;
+        size_t m_Size = 0;
+      };
+
+      Time_t m_Interval;
+      Time_t m_StartedAt = 0s;
+      Generation m_Current;
+      Generation m_Previous{0};
+    };
+  }  // namespace util
+}  // namespace llarp
+
+#endif
@@ -0,0 +1,296 @@
+#include <util/thread/worker_pool.hpp>
+
+#include <util/logging/logger.hpp>
+#include <util/thread/threading.hpp>
+
+#include <algorithm>
+#include <exception>
+
+namespace llarp
+{
+  namespace thread
+  {
+    namespace
+    {
+      /// the pool and worker index of the calling thread, if it is a worker
+      thread_local const WorkerPool* tl_Pool = nullptr;
+      thread_local size_t tl_Worker = 0;
+
+      constexpr std::array<const char*, NumWorkLanes> LaneNames{"handshake", "bulk"};
+
+      void
+      UpdateMax(std::atomic<uint64_t>& max, uint64_t val)
+      {
+        auto cur = max.load(std::memory_order_relaxed);
+        while (cur < val and not max.compare_exchange_weak(cur, val, std::memory_order_relaxed))
+        {
+        }
+      }
+    }  // namespace
+
+    WorkerPool::WorkerPool(std::string name) : m_Name{std::move(name)}
+    {}
+
+    WorkerPool::~WorkerPool()
+    {
+      Stop();
+    }
+
+    void
+    WorkerPool::Start(size_t numWorkers)
+    {
+      if (not m_Workers.empty())
+        return;
+      if (numWorkers == 0)
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+      // every worker exists before any thread runs, thieves look at all of them
+      for (size_t idx = 0; idx < numWorkers; ++idx)
+        m_Workers.emplace_back(std::make_unique<Worker>());
+      m_Running = true;
+      for (size_t idx = 0; idx < numWorkers; ++idx)
+        m_Workers[idx]->thread = std::thread{[this, idx]() { Work(idx); }};
+    }
+
+    void
+    WorkerPool::Stop()
+    {
+      if (not m_Running.exchange(false))
+        return;
+      for (auto& worker : m_Workers)
+      {
+        {
+          std::lock_guard<std::mutex> lock{worker->mutex};
+        }
+        worker->cond.notify_one();
+      }
+      for (auto& worker : m_Workers)
+      {
+        if (worker->thread.joinable())
+          worker->thread.join();
+      }
+    }
+
+    bool
+    WorkerPool::Submit(WorkLane lane, uint64_t affinity, Job_t job)
+    {
+      if (m_Workers.empty())
+        return false;
+      // affinities are mostly pointers and hashes, mix the bits so low zero bits do not matter
+      const auto mixed = (affinity * 0x9E3779B97F4A7C15ULL) >> 32;
+      return Push(mixed % m_Workers.size(), lane, std::move(job));
+    }
+
+    bool
+    WorkerPool::Submit(WorkLane lane, Job_t job)
+    {
+      if (m_Workers.empty())
+        return false;
+      const auto idx =
+          tl_Pool == this ? tl_Worker : m_NextWorker.fetch_add(1, std::memory_order_relaxed);
+      return Push(idx % m_Workers.size(), lane, std::move(job));
+    }
+
+    bool
+    WorkerPool::Push(size_t idx, WorkLane lane, Job_t job)
+    {
+      if (not m_Running.load(std::memory_order_relaxed))
+        return false;
+      auto& worker = *m_Workers[idx];
+      auto& stats = m_Lanes[static_cast<size_t>(lane)];
+      bool sleeping;
+      {
+        std::lock_guard<std::mutex> lock{worker.mutex};
+        worker.lanes[static_cast<size_t>(lane)].push_back(
+            Entry{std::move(job), Clock_t::now(), lane});
+        worker.queued.fetch_add(1, std::memory_order_relaxed);
+        sleeping = worker.sleeping.load(std::memory_order_relaxed);
+      }
+      UpdateMax(stats.queueWatermark, stats.queued.fetch_add(1, std::memory_order_relaxed) + 1);
+      if (sleeping)
+      {
+        worker.cond.notify_one();
+        return true;
+      }
+      // the owner is busy, wake an idle worker to steal the job
+      for (auto& other : m_Workers)
+      {
+        if (other->sleeping.load(std::memory_order_relaxed))
+        {
+          other->cond.notify_one();
+          break;
+        }
+      }
+      return true;
+    }
+
+    std::optional<WorkerPool::Entry>
+    WorkerPool::PopLocal(Worker& worker)
+    {
+      std::lock_guard<std::mutex> lock{worker.mutex};
+      auto& handshakes = worker.lanes[static_cast<size_t>(WorkLane::Handshake)];
+      auto& bulk = worker.lanes[static_cast<size_t>(WorkLane::Bulk)];
+      std::deque<Entry>* lane = nullptr;
+      if (not handshakes.empty() and (worker.handshakeRun < HandshakeBurst or bulk.empty()))
+      {
+        lane = &handshakes;
+        worker.handshakeRun++;
+      }
+      else if (not bulk.empty())
+      {
+        lane = &bulk;
+        worker.handshakeRun = 0;
+      }
+      else
+        return std::nullopt;
+      std::optional<Entry> entry{std::move(lane->front())};
+      lane->pop_front();
+      worker.queued.fetch_sub(1, std::memory_order_relaxed);
+      return entry;
+    }
+
+    std::optional<WorkerPool::Entry>
+    WorkerPool::Steal(size_t thief)
+    {
+      Worker* victim = nullptr;
+      size_t most = 0;
+      for (size_t idx = 0; idx < m_Workers.size(); ++idx)
+      {
+        const auto queued = m_Workers[idx]->queued.load(std::memory_order_relaxed);
+        if (idx != thief and queued > most)
+        {
+          victim = m_Workers[idx].get();
+          most = queued;
+        }
+      }
+      if (victim == nullptr)
+        return std::nullopt;
+      std::lock_guard<std::mutex> lock{victim->mutex};
+      // a sleeping owner has been woken for its jobs already, leave them to it
+      if (victim->sleeping.load(std::memory_order_relaxed))
+        return std::nullopt;
+      const auto stealBefore = Clock_t::now() - StealAfter;
+      for (auto& lane : victim->lanes)
+      {
+        if (lane.empty() or lane.front().queuedAt > stealBefore)
+          continue;
+        // the owner works from the front, take the newest job so its order is left alone
+        std::optional<Entry> entry{std::move(lane.back())};
+        lane.pop_back();
+        victim->queued.fetch_sub(1, std::memory_order_relaxed);
+        m_Lanes[static_cast<size_t>(entry->lane)].stolen.fetch_add(1, std::memory_order_relaxed);
+        return entry;
+      }
+      return std::nullopt;
+    }
+
+    bool
+    WorkerPool::OthersHaveJobs(size_t thief) const
+    {
+      for (size_t idx = 0; idx < m_Workers.size(); ++idx)
+      {
+        const auto& worker = *m_Workers[idx];
+        if (idx != thief and worker.queued.load(std::memory_order_relaxed) > 0
+            and not worker.sleeping.load(std::memory_order_relaxed))
+          return true;
+      }
+      return false;
+    }
+
+    void
+    WorkerPool::RunJob(Entry entry)
+    {
+      auto& stats = m_Lanes[static_cast<size_t>(entry.lane)];
+      const auto started = Clock_t::now();
+      stats.queued.fetch_sub(1, std::memory_order_relaxed);
+      stats.RecordWait(started - entry.queuedAt);
+      try
+      {
+        entry.job();
+      }
+      catch (const std::exception& ex)
+      {
+        LogError(m_Name, " job failed: ", ex.what());
+      }
+      const auto ran =
+          std::chrono::duration_cast<std::chrono::microseconds>(Clock_t::now() - started);
+      stats.jobs.fetch_add(1, std::memory_order_relaxed);
+      stats.runMicros.fetch_add(ran.count(), std::memory_order_relaxed);
+    }
+
+    void
+    WorkerPool::Work(size_t idx)
+    {
+      tl_Pool = this;
+      tl_Worker = idx;
+      util::SetThreadName(m_Name + "-" + std::to_string(idx));
+      auto& self = *m_Workers[idx];
+      while (true)
+      {
+        auto entry = PopLocal(self);
+        if (not entry)
+          entry = Steal(idx);
+        if (entry)
+        {
+          RunJob(std::move(*entry));
+          continue;
+        }
+        // jobs too young to steal yet become stealable within StealAfter, look again by then
+        // instead of leaving them to a busy owner for a whole IdleInterval
+        const auto idle = OthersHaveJobs(idx)
+            ? std::chrono::duration_cast<Clock_t::duration>(StealAfter)
+            : std::chrono::duration_cast<Clock_t::duration>(IdleInterval);
+        std::unique_lock<std::mutex> lock{self.mutex};
+        if (self.queued.load(std::memory_order_relaxed) > 0)
+          continue;
+        if (not m_Running.load(std::memory_order_relaxed))
+          break;
+        self.sleeping = true;
+        self.cond.wait_for(lock, idle);
+        self.sleeping = false;
+      }
+    }
+
+    void
+    WorkerPool::LaneStats::RecordWait(Clock_t::duration wait)
+    {
+      const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+      size_t idx = 0;
+      while (idx + 1 < NumWaitBuckets and micros >= (int64_t{1} << idx))
+        idx++;
+      waits[idx].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    util::StatusObject
+    WorkerPool::LaneStats::ExtractStatus() const
+    {
+      util::StatusObject waitObj{};
+      for (size_t idx = 0; idx < NumWaitBuckets; ++idx)
+      {
+        const auto key = idx + 1 < NumWaitBuckets ? "<" + std::to_string(1 << idx) + "us"
+                                                  : ">=" + std::to_string(1 << (idx - 1)) + "us";
+        waitObj[key] = waits[idx].load(std::memory_order_relaxed);
+      }
+      const auto numJobs = jobs.load(std::memory_order_relaxed);
+      return util::StatusObject{
+          {"queued", queued.load(std::memory_order_relaxed)},
+          {"queueWatermark", queueWatermark.load(std::memory_order_relaxed)},
+          {"jobs", numJobs},
+          {"stolen", stolen.load(std::memory_order_relaxed)},
+          {"avgRunMicros", numJobs ? runMicros.load(std::memory_order_relaxed) / numJobs : 0},
+          {"wait", waitObj}};
+    }
+
+    util::StatusObject
+    WorkerPool::ExtractStatus() const
+    {
+      util::StatusObject lanes{};
+      for (size_t idx = 0; idx < NumWorkLanes; ++idx)
+        lanes[LaneNames[idx]] = m_Lanes[idx].ExtractStatus();
+      std::vector<size_t> queued;
+      for (const auto& worker : m_Workers)
+        queued.push_back(worker->queued.load(std::memory_order_relaxed));
+      return util::StatusObject{
+          {"workers", m_Workers.size()}, {"workerQueued", queued}, {"lanes", lanes}};
+    }
+  }  // namespace thread
+}  // namespace llarp
@@ -0,0 +1,161 @@
+#ifndef LLARP_UTIL_THREAD_WORKER_POOL_HPP
+#define LLARP_UTIL_THREAD_WORKER_POOL_HPP
+
+#include <util/status.hpp>
+#include <util/thread/annotations.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// what kind of work a job is, workers take handshakes before bulk data
+    enum class WorkLane
+    {
+      /// path builds, relay commits and key exchanges: few, and someone waits on each
+      Handshake = 0,
+      /// packet, hop and frame crypto: almost all of the work
+      Bulk = 1,
+    };
+
+    constexpr size_t NumWorkLanes = 2;
+
+    /// thread pool for the crypto work of a router
+    ///
+    /// every worker owns a deque per lane. jobs with the same affinity hint go to the same worker,
+    /// so consecutive batches of a session or path stay on one core and its caches. a worker that
+    /// runs out of jobs steals the newest job of the busiest worker that has left its jobs waiting
+    /// for longer than StealAfter. handshakes are taken first but at most HandshakeBurst in a row
+    /// while bulk jobs wait.
+    class WorkerPool
+    {
+     public:
+      using Job_t = std::function<void(void)>;
+      using Clock_t = std::chrono::steady_clock;
+
+      /// handshake jobs a worker runs in a row before it lets a waiting bulk job through
+      static constexpr size_t HandshakeBurst = 4;
+      /// how long the oldest job of a worker must wait before other workers steal its jobs, so an
+      /// owner about to get to them keeps its affinity
+      static constexpr std::chrono::microseconds StealAfter{50};
+      /// how long an idle worker sleeps before it looks for jobs to steal again, when no other
+      /// worker has jobs waiting; while one does the idle worker looks again after StealAfter
+      static constexpr std::chrono::milliseconds IdleInterval{5};
+      /// bucket N of the queue wait histograms counts waits below 2^N microseconds
+      static constexpr size_t NumWaitBuckets = 16;
+
+      explicit WorkerPool(std::string name);
+
+      ~WorkerPool();
+
+      WorkerPool(const WorkerPool&) = delete;
+      WorkerPool&
+      operator=(const WorkerPool&) = delete;
+
+      /// start the workers, 0 starts one per core
+      void
+      Start(size_t numWorkers);
+
+      /// run the jobs already queued and join the workers
+      void
+      Stop();
+
+      /// queue a job on the worker that owns affinity, false if the pool is not running
+      bool
+      Submit(WorkLane lane, uint64_t affinity, Job_t job);
+
+      /// queue a job with no affinity: on the calling worker when a job queues more work, spread
+      /// round robin otherwise
+      bool
+      Submit(WorkLane lane, Job_t job);
+
+      size_t
+      NumWorkers() const
+      {
+        return m_Workers.size();
+      }
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      struct Entry
+      {
+        Job_t job;
+        Clock_t::time_point queuedAt;
+        WorkLane lane;
+      };
+
+      struct Worker
+      {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::array<std::deque<Entry>, NumWorkLanes> lanes GUARDED_BY(mutex);
+        /// handshake jobs taken in a row
+        size_t handshakeRun GUARDED_BY(mutex) = 0;
+        /// jobs in lanes, read without the lock to pick a worker to steal from
+        std::atomic<size_t> queued{0};
+        /// waiting for jobs, only set while holding mutex
+        std::atomic<bool> sleeping{false};
+        std::thread thread;
+      };
+
+      /// counters of a lane, updated by every worker
+      struct LaneStats
+      {
+        std::atomic<uint64_t> queued{0};
+        std::atomic<uint64_t> queueWatermark{0};
+        std::atomic<uint64_t> jobs{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> runMicros{0};
+        std::array<std::atomic<uint64_t>, NumWaitBuckets> waits{};
+
+        void
+        RecordWait(Clock_t::duration wait);
+
+        util::StatusObject
+        ExtractStatus() const;
+      };
+
+      bool
+      Push(size_t idx, WorkLane lane, Job_t job);
+
+      void
+      Work(size_t idx);
+
+      std::optional<Entry>
+      PopLocal(Worker& worker);
+
+      std::optional<Entry>
+      Steal(size_t thief);
+
+      /// does a worker other than thief have jobs that are not about to be run by their owner
+      bool
+      OthersHaveJobs(size_t thief) const;
+
+      void
+      RunJob(Entry entry);
+
+      const std::string m_Name;
+      std::vector<std::unique_ptr<Worker>> m_Workers;
+      std::atomic<bool> m_Running{false};
+      std::atomic<size_t> m_NextWorker{0};
+      std::array<LaneStats, NumWorkLanes> m_Lanes;
+    };
+  }  // namespace thread
+}  // namespace llarp
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef LLARP_UTIL_TIMER_WHEEL_HPP
+#define LLARP_UTIL_TIMER_WHEEL_HPP
+
+#include <util/time.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// hierarchical timer wheel, schedules and fires in O(1) no matter how many timers are armed
+    ///
+    /// the finest level has a slot per tick, each coarser level a slot per rotation of the one
+    /// below it, timers move down a level when their slot comes up. timers cannot be cancelled,
+    /// whoever handles a fired timer checks whether it still wants it. not thread safe.
+    template <typename Val_t>
+    class TimerWheel
+    {
+     public:
+      using Time_t = std::chrono::milliseconds;
+
+      static constexpr size_t RootBits = 8;
+      static constexpr size_t LevelBits = 6;
+      static constexpr size_t Levels = 4;
+
+      explicit TimerWheel(Time_t resolution = 1ms, Time_t now = 0s) : m_Resolution{resolution}
+      {
+        if (now == 0s)
+          now = llarp::time_now_ms();
+        m_Current = ToTick(now);
+      }
+
+      /// fire val on the first Advance at or after when, timers already due fire on the next one
+      void
+      Schedule(Time_t when, Val_t val)
+      {
+        Place(Entry{std::max(ToTick(when), m_Current), std::move(val)});
+        m_Size++;
+      }
+
+      /// fire everything due by now, visit is called with each fired value and may schedule more
+      template <typename Visit_t>
+      void
+      Advance(Time_t now, Visit_t visit)
+      {
+        const auto target = ToTick(now);
+        std::vector<Entry> fired;
+        while (m_Current <= target)
+        {
+          if (m_Size == 0)
+          {
+            m_Current = target + 1;
+            return;
+          }
+          const size_t idx = m_Current & RootMask;
+          if (idx == 0)
+          {
+            for (size_t level = 1; level < Levels; ++level)
+            {
+              if (Cascade(level) != 0)
+                break;
+            }
+          }
+          else if (m_RootSize == 0)
+          {
+            // nothing due this rotation, skip ahead to where the next level cascades down
+            m_Current = std::min(target + 1, (m_Current | RootMask) + 1);
+            continue;
+          }
+          fired.clear();
+          fired.swap(m_Root[idx]);
+          m_Current++;
+          m_Size -= fired.size();
+          m_RootSize -= fired.size();
+          for (auto& entry : fired)
+            visit(std::move(entry.val));
+        }
+      }
+
+      /// number of armed timers
+      size_t
+      Size() const
+      {
+        return m_Size;
+      }
+
+     private:
+      static constexpr size_t RootSize = size_t{1} << RootBits;
+      static constexpr size_t RootMask = RootSize - 1;
+      static constexpr size_t LevelSize = size_t{1} << LevelBits;
+      static constexpr size_t LevelMask = LevelSize - 1;
+
+      struct Entry
+      {
+        uint64_t tick;
+        Val_t val;
+      };
+
+      uint64_t
+      ToTick(Time_t t) const
+      {
+        return t.count() / m_Resolution.count();
+      }
+
+      static constexpr size_t
+      Shift(size_t level)
+      {
+        return RootBits + (level - 1) * LevelBits;
+      }
+
+      void
+      Place(Entry entry)
+      {
+        const auto delta = entry.tick - m_Current;
+        if (delta < RootSize)
+        {
+          m_Root[entry.tick & RootMask].emplace_back(std::move(entry));
+          m_RootSize++;
+          return;
+        }
+        for (size_t level = 1; level < Levels; ++level)
+        {
+          if (delta < (uint64_t{1} << (Shift(level) + LevelBits)) or level == Levels - 1)
+          {
+            // anything past the last level parks in its furthest slot and is placed again later
+            const auto tick = level == Levels - 1
+                ? std::min<uint64_t>(entry.tick, m_Current + (uint64_t{1} << Shift(Levels)) - 1)
+                : entry.tick;
+            m_Wheels[level - 1][(tick >> Shift(level)) & LevelMask].emplace_back(std::move(entry));
+            return;
+          }
+        }
+      }
+
+      /// move the current slot of a level down, returns that slot's index
+      size_t
+      Cascade(size_t level)
+      {
+        const size_t idx = (m_Current >> Shift(level)) & LevelMask;
+        std::vector<Entry> entries;
+        entries.swap(m_Wheels[level - 1][idx]);
+        for (auto& entry : entries)
+          Place(std::move(entry));
+        return idx;
+      }
+
+      const Time_t m_Resolution;
+      /// the next tick to fire
+      uint64_t m_Current;
+      size_t m_Size = 0;
+      /// timers in the finest level
+      size_t m_RootSize = 0;
+      std::array<std::vector<Entry>, RootSize> m_Root;
+      std::array<std::array<std::vector<Entry>, LevelSize>, Levels - 1> m_Wheels;
+    };
+  }  // namespace util
+}  // namespace llarp
+
+#endif
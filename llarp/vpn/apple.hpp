@@ -30,6 +30,8 @@
 #include <unistd.h>
 #include <errno.h>
 
+#include <utility>
+
 namespace llarp::vpn
 {
   class AppleInterface : public NetworkInterface
@@ -132,15 +134,18 @@ namespace llarp::vpn
     ReadNextPacket() override
     {
       net::IPPacket pkt{};
+      pkt.resize_for_overwrite(pkt.capacity());
       unsigned int pktinfo = 0;
       const struct iovec vecs[2] = {{.iov_base = &pktinfo, .iov_len = sizeof(unsigned int)},
-                                    {.iov_base = pkt.buf, .iov_len = sizeof(pkt.buf)}};
+                                    {.iov_base = pkt.data(), .iov_len = pkt.size()}};
       int n = readv(m_FD, vecs, 2);
-      if (n >= (int)(sizeof(unsigned int)))
+      if (n > (int)(sizeof(unsigned int)))
       {
         n -= sizeof(unsigned int);
-        pkt.sz = n;
+        pkt.resize(n);
       }
+      else
+        pkt.clear();
       return pkt;
     }
 
@@ -152,13 +157,13 @@ namespace llarp::vpn
 
       const struct iovec vecs[2] = {
           {.iov_base = pkt.IsV6() ? &af6 : &af4, .iov_len = sizeof(unsigned int)},
-          {.iov_base = pkt.buf, .iov_len = pkt.sz}};
+          {.iov_base = const_cast<byte_t*>(std::as_const(pkt).data()), .iov_len = pkt.size()}};
 
       ssize_t n = writev(m_FD, vecs, 2);
       if (n >= (int)sizeof(unsigned int))
       {
         n -= sizeof(unsigned int);
-        return static_cast<size_t>(n) == pkt.sz;
+        return static_cast<size_t>(n) == pkt.size();
       }
       return false;
     }
@@ -5,9 +5,16 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
 #include <vpn/common.hpp>
+#include <vpn/offload.hpp>
 #include <linux/if_tun.h>
 
+#include <cstring>
+#include <utility>
+#include <vector>
+
 namespace llarp::vpn
 {
   struct in6_ifreq
@@ -19,26 +26,60 @@ namespace llarp::vpn
 
   class LinuxInterface : public NetworkInterface
   {
-    const int m_fd;
+    /// one fd per queue, the first one is polled by the event loop when there is only one
+    std::vector<int> m_fds;
     const InterfaceInfo m_Info;
 
-   public:
-    LinuxInterface(InterfaceInfo info)
-        : NetworkInterface{}, m_fd{::open("/dev/net/tun", O_RDWR)}, m_Info{std::move(info)}
+    /// the packets cut from the last super packet read from a queue, with offloads on
+    struct Pending
+    {
+      std::vector<byte_t> readBuf;
+      std::vector<net::IPPacket> pkts;
+      size_t next = 0;
+    };
+    std::vector<Pending> m_Pending;
 
+    [[noreturn]] void
+    Fail(std::string what)
     {
-      if (m_fd == -1)
-        throw std::runtime_error("cannot open /dev/net/tun " + std::string{strerror(errno)});
+      what += std::string{strerror(errno)};
+      for (const auto fd : m_fds)
+        ::close(fd);
+      m_fds.clear();
+      throw std::runtime_error(what);
+    }
 
+   public:
+    LinuxInterface(InterfaceInfo info) : NetworkInterface{}, m_Info{std::move(info)}
+    {
       ifreq ifr{};
       in6_ifreq ifr6{};
       ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+      if (m_Info.queues > 1)
+        ifr.ifr_flags |= IFF_MULTI_QUEUE;
+      if (m_Info.offload)
+        ifr.ifr_flags |= IFF_VNET_HDR;
       std::copy_n(
           m_Info.ifname.c_str(),
           std::min(m_Info.ifname.size(), sizeof(ifr.ifr_name)),
           ifr.ifr_name);
-      if (::ioctl(m_fd, TUNSETIFF, &ifr) == -1)
-        throw std::runtime_error("cannot set interface name: " + std::string{strerror(errno)});
+      // every queue attaches to the same interface, the name the kernel gave the first one is
+      // left in ifr for the others
+      while (m_fds.size() < std::max(m_Info.queues, size_t{1}))
+      {
+        const int fd = ::open("/dev/net/tun", O_RDWR);
+        if (fd == -1)
+          Fail("cannot open /dev/net/tun ");
+        m_fds.push_back(fd);
+        if (::ioctl(fd, TUNSETIFF, &ifr) == -1)
+          Fail("cannot set interface name: ");
+        // queue workers read until there is nothing left and then wait in WaitForPacket
+        if (m_Info.queues > 1 and ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) == -1)
+          Fail("cannot make tun queue non blocking: ");
+        if (m_Info.offload and not EnableOffloads(fd))
+          Fail("cannot enable tun offloads: ");
+      }
+      m_Pending.resize(m_fds.size());
       IOCTL control{AF_INET};
 
       control.ioctl(SIOCGIFFLAGS, &ifr);
@@ -74,39 +115,130 @@ namespace llarp::vpn
 
     virtual ~LinuxInterface()
     {
-      if (m_fd != -1)
-        ::close(m_fd);
+      for (const auto fd : m_fds)
+        ::close(fd);
     }
 
     int
     PollFD() const override
     {
-      return m_fd;
+      return m_fds[0];
     }
 
     net::IPPacket
     ReadNextPacket() override
     {
+      return ReadNextPacketFrom(0);
+    }
+
+    bool
+    WritePacket(net::IPPacket pkt) override
+    {
+      return WritePacketTo(0, std::move(pkt));
+    }
+
+    size_t
+    NumQueues() const override
+    {
+      return m_fds.size();
+    }
+
+    /// have the kernel hand us tcp super packets, and udp ones where it can
+    static bool
+    EnableOffloads(int fd)
+    {
+      const unsigned int offloads = TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6;
+#ifdef TUN_F_USO4
+      if (::ioctl(fd, TUNSETOFFLOAD, offloads | TUN_F_USO4 | TUN_F_USO6) == 0)
+        return true;
+#endif
+      return ::ioctl(fd, TUNSETOFFLOAD, offloads) == 0;
+    }
+
+    net::IPPacket
+    ReadOffloaded(size_t queue)
+    {
+      auto& pending = m_Pending[queue];
+      if (pending.next == pending.pkts.size())
+      {
+        pending.pkts.clear();
+        pending.next = 0;
+        pending.readBuf.resize(sizeof(VirtioNetHeader) + MaxSuperPacketSize);
+        const auto sz = read(m_fds[queue], pending.readBuf.data(), pending.readBuf.size());
+        if (sz > ssize_t{sizeof(VirtioNetHeader)})
+        {
+          VirtioNetHeader hdr;
+          std::memcpy(&hdr, pending.readBuf.data(), sizeof(hdr));
+          SplitSuperPacket(
+              hdr,
+              pending.readBuf.data() + sizeof(hdr),
+              sz - sizeof(hdr),
+              pending.pkts);
+        }
+      }
       net::IPPacket pkt;
-      const auto sz = read(m_fd, pkt.buf, sizeof(pkt.buf));
-      if (sz >= 0)
-        pkt.sz = std::min(sz, ssize_t{sizeof(pkt.buf)});
+      if (pending.next < pending.pkts.size())
+        pkt = std::move(pending.pkts[pending.next++]);
       return pkt;
     }
 
     bool
-    WritePacket(net::IPPacket pkt) override
+    WriteOffloaded(size_t queue, const VirtioNetHeader& hdr, const byte_t* data, size_t sz)
+    {
+      iovec vecs[2] = {
+          {const_cast<VirtioNetHeader*>(&hdr), sizeof(hdr)}, {const_cast<byte_t*>(data), sz}};
+      return writev(m_fds[queue], vecs, 2) == static_cast<ssize_t>(sizeof(hdr) + sz);
+    }
+
+    net::IPPacket
+    ReadNextPacketFrom(size_t queue) override
+    {
+      if (m_Info.offload)
+        return ReadOffloaded(queue);
+      net::IPPacket pkt;
+      pkt.resize_for_overwrite(pkt.capacity());
+      const auto sz = read(m_fds[queue], pkt.data(), pkt.size());
+      if (sz > 0)
+        pkt.resize(sz);
+      else
+        pkt.clear();
+      return pkt;
+    }
+
+    bool
+    WaitForPacket(size_t queue, std::chrono::milliseconds timeout) override
+    {
+      pollfd pfd{m_fds[queue], POLLIN, 0};
+      return ::poll(&pfd, 1, timeout.count()) > 0;
+    }
+
+    size_t
+    WritePacketsTo(size_t queue, std::vector<net::IPPacket> pkts) override
+    {
+      if (not m_Info.offload)
+        return NetworkInterface::WritePacketsTo(queue, std::move(pkts));
+      return CoalescePackets(
+          pkts, [this, queue](const VirtioNetHeader& hdr, const byte_t* data, size_t sz) {
+            return WriteOffloaded(queue, hdr, data, sz);
+          });
+    }
+
+    bool
+    WritePacketTo(size_t queue, net::IPPacket pkt) override
     {
-      const auto sz = write(m_fd, pkt.buf, pkt.sz);
+      if (m_Info.offload)
+        return WriteOffloaded(queue, VirtioNetHeader{}, std::as_const(pkt).data(), pkt.size());
+      const auto sz = write(m_fds[queue], std::as_const(pkt).data(), pkt.size());
       if (sz <= 0)
         return false;
-      return sz == static_cast<ssize_t>(pkt.sz);
+      return sz == static_cast<ssize_t>(pkt.size());
     }
 
+    /// the rest of a super packet read by the event loop
     bool
     HasNextPacket() override
     {
-      return false;
+      return m_Pending[0].next < m_Pending[0].pkts.size();
     }
 
     std::string
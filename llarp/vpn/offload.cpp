@@ -0,0 +1,323 @@
+#include <vpn/offload.hpp>
+
+#include <algorithm>
+#include <optional>
+
+namespace llarp::vpn
+{
+  namespace
+  {
+    constexpr byte_t TCP = 6;
+    constexpr byte_t UDP = 17;
+    constexpr size_t TCPChecksumOffset = 16;
+    constexpr size_t UDPChecksumOffset = 6;
+    constexpr size_t UDPHeaderSize = 8;
+
+    constexpr byte_t TCPFlagFIN = 0x01;
+    constexpr byte_t TCPFlagPSH = 0x08;
+    constexpr byte_t TCPFlagACK = 0x10;
+    constexpr byte_t TCPFlagCWR = 0x80;
+
+    uint16_t
+    Get16(const byte_t* ptr)
+    {
+      return (uint16_t{ptr[0]} << 8) | ptr[1];
+    }
+
+    uint32_t
+    Get32(const byte_t* ptr)
+    {
+      return (uint32_t{Get16(ptr)} << 16) | Get16(ptr + 2);
+    }
+
+    void
+    Put16(byte_t* ptr, uint16_t val)
+    {
+      ptr[0] = val >> 8;
+      ptr[1] = val;
+    }
+
+    void
+    Put32(byte_t* ptr, uint32_t val)
+    {
+      Put16(ptr, val >> 16);
+      Put16(ptr + 2, val);
+    }
+
+    /// one's complement sum of big endian 16 bit words, not folded
+    uint32_t
+    Sum16(const byte_t* buf, size_t sz, uint32_t sum = 0)
+    {
+      for (; sz > 1; sz -= 2, buf += 2)
+        sum += Get16(buf);
+      if (sz)
+        sum += uint32_t{buf[0]} << 8;
+      return sum;
+    }
+
+    uint16_t
+    Fold(uint32_t sum)
+    {
+      while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+      return sum;
+    }
+
+    /// where the parts of an ip packet are
+    struct Layout
+    {
+      bool v6;
+      size_t ipLen;
+      byte_t proto;
+    };
+
+    std::optional<Layout>
+    Parse(const byte_t* data, size_t sz)
+    {
+      if (sz < 20)
+        return std::nullopt;
+      if ((data[0] >> 4) == 4)
+      {
+        const size_t ipLen = (data[0] & 0x0f) * 4;
+        if (ipLen < 20 or sz < ipLen)
+          return std::nullopt;
+        return Layout{false, ipLen, data[9]};
+      }
+      // no extension headers, the kernel only offloads tcp and udp right after the ipv6 header
+      if ((data[0] >> 4) == 6 and sz >= 40)
+        return Layout{true, 40, data[6]};
+      return std::nullopt;
+    }
+
+    uint32_t
+    PseudoHeaderSum(const byte_t* ip, const Layout& layout, size_t l4Len)
+    {
+      const auto sum = layout.v6 ? Sum16(ip + 8, 32) : Sum16(ip + 12, 8);
+      return sum + layout.proto + (l4Len >> 16) + (l4Len & 0xffff);
+    }
+
+    /// set the ip lengths of a packet of sz bytes and the ipv4 header checksum
+    void
+    FinishIPHeader(byte_t* ip, const Layout& layout, size_t sz)
+    {
+      if (layout.v6)
+      {
+        Put16(ip + 4, sz - layout.ipLen);
+        return;
+      }
+      Put16(ip + 2, sz);
+      Put16(ip + 10, 0);
+      Put16(ip + 10, ~Fold(Sum16(ip, layout.ipLen)));
+    }
+
+    /// the parts of a tcp segment that coalescing looks at
+    struct Segment
+    {
+      Layout layout;
+      size_t hdrsLen;
+      size_t payload;
+      uint32_t seq;
+      byte_t flags;
+    };
+
+    std::optional<Segment>
+    ParseSegment(const net::IPPacket& pkt)
+    {
+      const auto layout = Parse(pkt.data(), pkt.size());
+      if (not layout or layout->proto != TCP or pkt.size() < layout->ipLen + 20)
+        return std::nullopt;
+      // fragments and ip options are not coalesced
+      if (not layout->v6 and (layout->ipLen != 20 or (Get16(pkt.data() + 6) & 0x3fff)))
+        return std::nullopt;
+      const byte_t* tcp = pkt.data() + layout->ipLen;
+      const size_t hdrsLen = layout->ipLen + (tcp[12] >> 4) * 4;
+      if (hdrsLen > pkt.size() or hdrsLen < layout->ipLen + 20)
+        return std::nullopt;
+      const byte_t flags = tcp[13];
+      if ((flags & ~TCPFlagPSH) != TCPFlagACK)
+        return std::nullopt;
+      return Segment{*layout, hdrsLen, pkt.size() - hdrsLen, Get32(tcp + 4), flags};
+    }
+
+    /// are the headers of two segments the same but for what differs between segments of a
+    /// super packet: lengths, ipv4 id and checksums, sequence number and flags
+    bool
+    SameHeaders(const byte_t* a, const byte_t* b, const Segment& seg)
+    {
+      const auto skip = [&seg](size_t off) {
+        if (seg.layout.v6)
+        {
+          if (off == 4 or off == 5)
+            return true;
+        }
+        else if ((off >= 2 and off < 6) or off == 10 or off == 11)
+          return true;
+        if (off < seg.layout.ipLen)
+          return false;
+        off -= seg.layout.ipLen;
+        return (off >= 4 and off < 8) or off == 13 or off == 16 or off == 17;
+      };
+      for (size_t off = 0; off < seg.hdrsLen; ++off)
+      {
+        if (a[off] != b[off] and not skip(off))
+          return false;
+      }
+      return true;
+    }
+  }  // namespace
+
+  bool
+  SplitSuperPacket(
+      const VirtioNetHeader& hdr, const byte_t* data, size_t sz, std::vector<net::IPPacket>& out)
+  {
+    const uint8_t gso = hdr.gsoType & ~VirtioNetHeader::GSOECN;
+    if (gso == VirtioNetHeader::GSONone)
+    {
+      if (sz > net::IPPacket::MaxSize)
+        return false;
+      const size_t field = size_t{hdr.csumStart} + hdr.csumOffset;
+      const bool needsChecksum = hdr.flags & VirtioNetHeader::NeedsChecksum;
+      if (needsChecksum and field + 2 > sz)
+        return false;
+      auto& pkt = out.emplace_back();
+      pkt.resize_for_overwrite(sz);
+      byte_t* ip = pkt.data();
+      std::copy_n(data, sz, ip);
+      // the field holds the pseudo header sum already, summing over it completes the checksum
+      if (needsChecksum)
+        Put16(ip + field, ~Fold(Sum16(ip + hdr.csumStart, sz - hdr.csumStart)));
+      return true;
+    }
+
+    const bool tcp = gso == VirtioNetHeader::GSOTCPv4 or gso == VirtioNetHeader::GSOTCPv6;
+    if (not tcp and gso != VirtioNetHeader::GSOUDPL4)
+      return false;
+    const auto layout = Parse(data, sz);
+    if (not layout or layout->proto != (tcp ? TCP : UDP))
+      return false;
+    if (sz < layout->ipLen + (tcp ? 20 : UDPHeaderSize))
+      return false;
+    const size_t hdrsLen =
+        layout->ipLen + (tcp ? (data[layout->ipLen + 12] >> 4) * 4 : UDPHeaderSize);
+    if (sz < hdrsLen or hdrsLen >= net::IPPacket::MaxSize)
+      return false;
+    // tcp segments can be cut smaller than the sender asked for, but every udp segment is a
+    // datagram of its own and cutting it would change what the other end receives
+    if (not tcp and hdr.gsoSize > net::IPPacket::MaxSize - hdrsLen)
+      return false;
+    const size_t segSize = std::min<size_t>(hdr.gsoSize, net::IPPacket::MaxSize - hdrsLen);
+    if (segSize == 0)
+      return false;
+
+    const size_t payload = sz - hdrsLen;
+    const size_t numSegs = std::max<size_t>(1, (payload + segSize - 1) / segSize);
+    const uint32_t seq = tcp ? Get32(data + layout->ipLen + 4) : 0;
+    const uint16_t id = layout->v6 ? 0 : Get16(data + 4);
+    const byte_t flags = tcp ? data[layout->ipLen + 13] : 0;
+    for (size_t idx = 0; idx < numSegs; ++idx)
+    {
+      const size_t off = idx * segSize;
+      const size_t chunk = std::min(segSize, payload - off);
+      auto& pkt = out.emplace_back();
+      pkt.resize_for_overwrite(hdrsLen + chunk);
+      byte_t* ip = pkt.data();
+      std::copy_n(data, hdrsLen, ip);
+      std::copy_n(data + hdrsLen + off, chunk, ip + hdrsLen);
+
+      byte_t* l4 = ip + layout->ipLen;
+      const size_t l4Len = pkt.size() - layout->ipLen;
+      if (not layout->v6)
+        Put16(ip + 4, id + idx);
+      FinishIPHeader(ip, *layout, pkt.size());
+      size_t checksumOffset = UDPChecksumOffset;
+      if (tcp)
+      {
+        Put32(l4 + 4, seq + off);
+        byte_t segFlags = flags;
+        if (idx + 1 < numSegs)
+          segFlags &= ~(TCPFlagFIN | TCPFlagPSH);
+        if (idx > 0)
+          segFlags &= ~TCPFlagCWR;
+        l4[13] = segFlags;
+        checksumOffset = TCPChecksumOffset;
+      }
+      else
+        Put16(l4 + 4, l4Len);
+      Put16(l4 + checksumOffset, 0);
+      uint16_t checksum = ~Fold(Sum16(l4, l4Len, PseudoHeaderSum(ip, *layout, l4Len)));
+      // zero means no checksum for udp
+      if (not tcp and checksum == 0)
+        checksum = 0xffff;
+      Put16(l4 + checksumOffset, checksum);
+    }
+    return true;
+  }
+
+  size_t
+  CoalescePackets(
+      const std::vector<net::IPPacket>& pkts,
+      const std::function<bool(const VirtioNetHeader&, const byte_t*, size_t)>& write)
+  {
+    std::vector<byte_t> super;
+    size_t written = 0;
+    size_t first = 0;
+    while (first < pkts.size())
+    {
+      const auto& head = pkts[first];
+      const auto seg = ParseSegment(head);
+      size_t end = first + 1;
+      size_t total = head.size();
+      if (seg and seg->payload > 0)
+      {
+        // only the last segment may be short or pushed
+        auto prev = *seg;
+        while (end < pkts.size() and end - first < MaxCoalescedSegments
+               and prev.payload == seg->payload and not(prev.flags & TCPFlagPSH))
+        {
+          const auto next = ParseSegment(pkts[end]);
+          if (not next or next->layout.v6 != seg->layout.v6 or next->hdrsLen != seg->hdrsLen
+              or next->payload == 0 or next->payload > seg->payload
+              or next->seq != prev.seq + prev.payload or total + next->payload > MaxSuperPacketSize
+              or not SameHeaders(head.data(), pkts[end].data(), *seg))
+            break;
+          total += next->payload;
+          prev = *next;
+          ++end;
+        }
+      }
+      if (end - first == 1)
+      {
+        if (write(VirtioNetHeader{}, head.data(), head.size()))
+          written++;
+        first = end;
+        continue;
+      }
+
+      super.assign(head.data(), head.data() + head.size());
+      for (size_t idx = first + 1; idx < end; ++idx)
+      {
+        const auto& pkt = pkts[idx];
+        super.insert(super.end(), pkt.data() + seg->hdrsLen, pkt.data() + pkt.size());
+      }
+      byte_t* ip = super.data();
+      byte_t* tcp = ip + seg->layout.ipLen;
+      FinishIPHeader(ip, seg->layout, super.size());
+      tcp[13] |= pkts[end - 1].data()[seg->layout.ipLen + 13] & TCPFlagPSH;
+      // the kernel finishes the checksum of each segment it cuts from this
+      const size_t l4Len = super.size() - seg->layout.ipLen;
+      Put16(tcp + TCPChecksumOffset, Fold(PseudoHeaderSum(ip, seg->layout, l4Len)));
+
+      VirtioNetHeader hdr;
+      hdr.flags = VirtioNetHeader::NeedsChecksum;
+      hdr.gsoType = seg->layout.v6 ? VirtioNetHeader::GSOTCPv6 : VirtioNetHeader::GSOTCPv4;
+      hdr.hdrLen = seg->hdrsLen;
+      hdr.gsoSize = seg->payload;
+      hdr.csumStart = seg->layout.ipLen;
+      hdr.csumOffset = TCPChecksumOffset;
+      if (write(hdr, super.data(), super.size()))
+        written += end - first;
+      first = end;
+    }
+    return written;
+  }
+}  // namespace llarp::vpn
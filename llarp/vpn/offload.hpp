@@ -0,0 +1,56 @@
+#pragma once
+
+#include <net/ip_packet.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace llarp::vpn
+{
+  /// the header a tun opened with IFF_VNET_HDR puts in front of every packet, as struct
+  /// virtio_net_hdr in native byte order
+  struct VirtioNetHeader
+  {
+    /// the transport checksum is left for us, seeded with the pseudo header sum
+    static constexpr uint8_t NeedsChecksum = 1;
+
+    static constexpr uint8_t GSONone = 0;
+    static constexpr uint8_t GSOTCPv4 = 1;
+    static constexpr uint8_t GSOTCPv6 = 4;
+    static constexpr uint8_t GSOUDPL4 = 5;
+    /// or'd into gsoType when the segments carry ecn
+    static constexpr uint8_t GSOECN = 0x80;
+
+    uint8_t flags = 0;
+    uint8_t gsoType = GSONone;
+    uint16_t hdrLen = 0;
+    uint16_t gsoSize = 0;
+    uint16_t csumStart = 0;
+    uint16_t csumOffset = 0;
+  };
+
+  static_assert(sizeof(VirtioNetHeader) == 10);
+
+  /// biggest packet an offloading tun hands us or takes from us
+  constexpr size_t MaxSuperPacketSize = 65535;
+
+  /// most tcp segments we coalesce into one super packet
+  constexpr size_t MaxCoalescedSegments = 64;
+
+  /// cut a packet read from an offloading tun into packets that fit a net::IPPacket, segmenting
+  /// tcp and udp super packets and filling in the checksums the kernel left to us
+  /// returns false if the packet is malformed or too big and was dropped, which includes udp
+  /// super packets whose datagrams do not each fit a net::IPPacket
+  bool
+  SplitSuperPacket(
+      const VirtioNetHeader& hdr, const byte_t* data, size_t sz, std::vector<net::IPPacket>& out);
+
+  /// calls write, in order, for every packet to write to an offloading tun, with consecutive tcp
+  /// segments of the same flow coalesced into super packets
+  /// returns how many of pkts made it into a write that returned true
+  size_t
+  CoalescePackets(
+      const std::vector<net::IPPacket>& pkts,
+      const std::function<bool(const VirtioNetHeader&, const byte_t*, size_t)>& write);
+}  // namespace llarp::vpn
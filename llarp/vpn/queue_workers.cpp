@@ -0,0 +1,197 @@
+#include <vpn/queue_workers.hpp>
+
+#include <util/logging/logger.hpp>
+#include <util/thread/threading.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+
+namespace llarp::vpn
+{
+  QueueWorkers::QueueWorkers(std::shared_ptr<NetworkInterface> netif, BatchHandler handler)
+      : m_NetIf{std::move(netif)}, m_Handler{std::move(handler)}
+  {
+    while (m_Queues.size() < m_NetIf->NumQueues())
+      m_Queues.emplace_back(std::make_unique<Queue>());
+  }
+
+  QueueWorkers::~QueueWorkers()
+  {
+    Stop();
+  }
+
+  void
+  QueueWorkers::Start()
+  {
+    if (m_Running.exchange(true))
+      return;
+    for (size_t idx = 0; idx < m_Queues.size(); ++idx)
+    {
+      m_Queues[idx]->reader = std::thread{[this, idx]() { Read(idx); }};
+      m_Queues[idx]->writer = std::thread{[this, idx]() { Write(idx); }};
+    }
+  }
+
+  void
+  QueueWorkers::Stop()
+  {
+    if (not m_Running.exchange(false))
+      return;
+    for (auto& queue : m_Queues)
+    {
+      queue->reader.join();
+      queue->writer.join();
+    }
+  }
+
+  bool
+  QueueWorkers::WritePacket(net::IPPacket pkt)
+  {
+    auto& queue = *m_Queues[FlowQueue(pkt, m_Queues.size())];
+    if (queue.writes.tryPushBack(std::move(pkt)) == thread::QueueReturn::Success)
+      return true;
+    queue.writeDrops.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  size_t
+  QueueWorkers::FlowQueue(const net::IPPacket& pkt, size_t numQueues)
+  {
+    if (numQueues <= 1)
+      return 0;
+    constexpr byte_t TCP = 6;
+    constexpr byte_t UDP = 17;
+    // both addresses, the protocol and for tcp and udp both ports
+    std::array<byte_t, 32 + 1 + 4> key{};
+    size_t keySize = 0;
+    size_t transport = 0;
+    byte_t proto = 0;
+    bool hasPorts = false;
+    const byte_t* data = pkt.data();
+    if (pkt.size() >= 20 and pkt.IsV4())
+    {
+      proto = data[9];
+      transport = (data[0] & 0x0f) * 4;
+      // only the first fragment starts with the transport header, the others carry payload there
+      const uint16_t fragOffset = ((data[6] & 0x1f) << 8) | data[7];
+      hasPorts = fragOffset == 0;
+      std::copy_n(data + 12, 8, key.begin());
+      keySize = 8;
+    }
+    else if (pkt.size() >= 40 and pkt.IsV6())
+    {
+      // a fragment header shows up as the next header so fragments never look like tcp or udp
+      proto = data[6];
+      transport = 40;
+      hasPorts = true;
+      std::copy_n(data + 8, 32, key.begin());
+      keySize = 32;
+    }
+    else
+      return 0;
+    key[keySize++] = proto;
+    if (hasPorts and (proto == TCP or proto == UDP) and pkt.size() >= transport + 4)
+    {
+      std::copy_n(data + transport, 4, key.begin() + keySize);
+      keySize += 4;
+    }
+    const std::string_view view{reinterpret_cast<const char*>(key.data()), keySize};
+    return std::hash<std::string_view>{}(view) % numQueues;
+  }
+
+  void
+  QueueWorkers::Read(size_t idx)
+  {
+    util::SetThreadName("tun-read-" + std::to_string(idx));
+    auto& queue = *m_Queues[idx];
+    std::vector<net::IPPacket> batch;
+    // the error we last logged, so one that keeps coming back is logged once
+    int failing = 0;
+    while (m_Running.load(std::memory_order_relaxed))
+    {
+      errno = 0;
+      auto pkt = m_NetIf->ReadNextPacketFrom(idx);
+      const int err = errno;
+      if (not pkt.empty())
+      {
+        failing = 0;
+        queue.packetsRead.fetch_add(1, std::memory_order_relaxed);
+        queue.bytesRead.fetch_add(pkt.size(), std::memory_order_relaxed);
+        batch.emplace_back(std::move(pkt));
+        if (batch.size() < MaxReadBatch)
+          continue;
+      }
+      if (not batch.empty())
+      {
+        m_Handler(std::move(batch));
+        batch = {};
+        continue;
+      }
+      if (err != 0 and err != EAGAIN and err != EWOULDBLOCK and err != EINTR)
+      {
+        // a queue in error polls as readable, so waiting for a packet would spin on it
+        queue.readErrors.fetch_add(1, std::memory_order_relaxed);
+        if (err != failing)
+          LogError("cannot read tun queue ", idx, ": ", strerror(err), ", backing off");
+        failing = err;
+        std::this_thread::sleep_for(WakeInterval);
+        continue;
+      }
+      m_NetIf->WaitForPacket(idx, WakeInterval);
+    }
+  }
+
+  void
+  QueueWorkers::Write(size_t idx)
+  {
+    util::SetThreadName("tun-write-" + std::to_string(idx));
+    auto& queue = *m_Queues[idx];
+    while (m_Running.load(std::memory_order_relaxed))
+    {
+      auto pkt = queue.writes.popFrontWithTimeout(WakeInterval);
+      if (not pkt)
+        continue;
+      std::vector<net::IPPacket> batch;
+      batch.emplace_back(std::move(*pkt));
+      size_t bytes = batch.back().size();
+      while (batch.size() < MaxWriteBatch)
+      {
+        pkt = queue.writes.tryPopFront();
+        if (not pkt)
+          break;
+        bytes += pkt->size();
+        batch.emplace_back(std::move(*pkt));
+      }
+      const size_t num = batch.size();
+      const size_t written = m_NetIf->WritePacketsTo(idx, std::move(batch));
+      queue.packetsWritten.fetch_add(written, std::memory_order_relaxed);
+      queue.bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+      queue.writeDrops.fetch_add(num - written, std::memory_order_relaxed);
+    }
+  }
+
+  util::StatusObject
+  QueueWorkers::Queue::ExtractStatus() const
+  {
+    return util::StatusObject{
+        {"packetsRead", packetsRead.load(std::memory_order_relaxed)},
+        {"bytesRead", bytesRead.load(std::memory_order_relaxed)},
+        {"packetsWritten", packetsWritten.load(std::memory_order_relaxed)},
+        {"bytesWritten", bytesWritten.load(std::memory_order_relaxed)},
+        {"writeDrops", writeDrops.load(std::memory_order_relaxed)},
+        {"readErrors", readErrors.load(std::memory_order_relaxed)},
+        {"writeQueued", writes.size()}};
+  }
+
+  util::StatusObject
+  QueueWorkers::ExtractStatus() const
+  {
+    std::vector<util::StatusObject> queues;
+    for (const auto& queue : m_Queues)
+      queues.emplace_back(queue->ExtractStatus());
+    return util::StatusObject{{"queues", queues}};
+  }
+}  // namespace llarp::vpn
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <ev/vpn.hpp>
+#include <util/status.hpp>
+#include <util/thread/queue.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace llarp::vpn
+{
+  /// reads and writes every queue of a multi-queue interface on threads of its own
+  ///
+  /// each queue gets a reader thread, which hands the packets it reads to the handler in batches,
+  /// and a writer thread, which writes the packets steered to that queue. packets are steered by
+  /// their flow so the packets of one flow are written in order.
+  class QueueWorkers
+  {
+   public:
+    /// called on the reader thread of a queue with the packets it read in a row
+    using BatchHandler = std::function<void(std::vector<net::IPPacket>)>;
+
+    /// most packets a reader hands over at once
+    static constexpr size_t MaxReadBatch = 64;
+    /// most packets a writer hands the interface at once, for it to coalesce
+    static constexpr size_t MaxWriteBatch = 64;
+    /// packets waiting to be written to a queue before we drop
+    static constexpr size_t WriteQueueSize = 1024;
+    /// how long a worker blocks before it checks whether we stopped, and how long a reader backs
+    /// off after a read error
+    static constexpr std::chrono::milliseconds WakeInterval{100};
+
+    QueueWorkers(std::shared_ptr<NetworkInterface> netif, BatchHandler handler);
+
+    ~QueueWorkers();
+
+    void
+    Start();
+
+    /// stop and join all workers, blocks up to WakeInterval
+    void
+    Stop();
+
+    size_t
+    NumQueues() const
+    {
+      return m_Queues.size();
+    }
+
+    /// queue a packet to be written on the queue of its flow
+    /// returns false if we dropped it
+    bool
+    WritePacket(net::IPPacket pkt);
+
+    /// the queue out of numQueues that a packet's flow goes to
+    static size_t
+    FlowQueue(const net::IPPacket& pkt, size_t numQueues);
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    struct Queue
+    {
+      Queue() : writes{WriteQueueSize}
+      {}
+
+      thread::Queue<net::IPPacket> writes;
+      std::thread reader;
+      std::thread writer;
+      std::atomic<uint64_t> packetsRead{0};
+      std::atomic<uint64_t> bytesRead{0};
+      std::atomic<uint64_t> packetsWritten{0};
+      std::atomic<uint64_t> bytesWritten{0};
+      std::atomic<uint64_t> writeDrops{0};
+      std::atomic<uint64_t> readErrors{0};
+
+      util::StatusObject
+      ExtractStatus() const;
+    };
+
+    void
+    Read(size_t idx);
+
+    void
+    Write(size_t idx);
+
+    const std::shared_ptr<NetworkInterface> m_NetIf;
+    const BatchHandler m_Handler;
+    std::vector<std::unique_ptr<Queue>> m_Queues;
+    std::atomic<bool> m_Running{false};
+  };
+}  // namespace llarp::vpn
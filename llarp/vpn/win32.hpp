@@ -393,7 +393,8 @@ namespace llarp::vpn
       void
       Read(HANDLE dev)
       {
-        ReadFile(dev, pkt.buf, sizeof(pkt.buf), nullptr, &hdr);
+        pkt.resize_for_overwrite(pkt.capacity());
+        ReadFile(dev, pkt.data(), pkt.size(), nullptr, &hdr);
       }
     };
 
@@ -402,11 +403,11 @@ namespace llarp::vpn
     bool
     WritePacket(net::IPPacket pkt)
     {
-      LogDebug("write packet ", pkt.sz);
+      LogDebug("write packet ", pkt.size());
       asio_evt_pkt* ev = new asio_evt_pkt{false};
-      std::copy_n(pkt.buf, pkt.sz, ev->pkt.buf);
-      ev->pkt.sz = pkt.sz;
-      WriteFile(m_Device, ev->pkt.buf, ev->pkt.sz, nullptr, &ev->hdr);
+      // the packet has to outlive the write, which is done when we get its completion
+      ev->pkt = std::move(pkt);
+      WriteFile(m_Device, ev->pkt.data(), ev->pkt.size(), nullptr, &ev->hdr);
       return true;
     }
 
@@ -426,8 +427,8 @@ namespace llarp::vpn
         LogDebug("got iocp event size=", size, " read=", pkt->read);
         if (pkt->read)
         {
-          pkt->pkt.sz = size;
-          m_ReadQueue.pushBack(pkt->pkt);
+          pkt->pkt.resize(size);
+          m_ReadQueue.pushBack(std::move(pkt->pkt));
           pkt->Read(m_Device);
         }
         else
@@ -0,0 +1,54 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace llarp;
+
+/// num random packets of sz bytes each with a random nonce
+static std::vector<std::vector<byte_t>>
+MakePackets(size_t num, size_t sz)
+{
+  std::vector<std::vector<byte_t>> pkts(num, std::vector<byte_t>(sz));
+  for (auto& pkt : pkts)
+    CryptoManager::instance()->randbytes(pkt.data(), pkt.size());
+  return pkts;
+}
+
+static std::vector<ManagedBuffer>
+Buffers(std::vector<std::vector<byte_t>>& pkts)
+{
+  std::vector<ManagedBuffer> bufs;
+  for (auto& pkt : pkts)
+    bufs.emplace_back(llarp_buffer_t{pkt});
+  return bufs;
+}
+
+TEST_CASE("encrypt_hmac_batch packets per second", "[benchmark][batch]")
+{
+  sodium::CryptoLibSodium crypto;
+  CryptoManager manager{&crypto};
+
+  SharedSecret key;
+  key.Randomize();
+  constexpr size_t totalPackets = 64 * 1024;
+  const size_t batch = GENERATE(1, 2, 4, 8, 16, 32, 64);
+  auto pkts = MakePackets(batch, 1472);
+  auto bufs = Buffers(pkts);
+  std::unique_ptr<bool[]> valid{new bool[batch]};
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < totalPackets; n += batch)
+  {
+    CryptoManager::instance()->encrypt_hmac_batch(bufs.data(), bufs.size(), key);
+    CryptoManager::instance()->verify_decrypt_batch(bufs.data(), bufs.size(), key, valid.get());
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  WARN(
+      "batch " << batch << ": " << static_cast<uint64_t>(totalPackets / elapsed.count())
+               << " packets/s per core (encrypt + decrypt)");
+}
@@ -0,0 +1,53 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <vector>
+
+using namespace llarp;
+
+/// random keys and nonces for a path of numHops hops
+static void
+MakeHops(size_t numHops, std::vector<SharedSecret>& keys, std::vector<TunnelNonce>& nonces)
+{
+  keys.resize(numHops);
+  nonces.resize(numHops);
+  for (auto& key : keys)
+    key.Randomize();
+  for (auto& nonce : nonces)
+    nonce.Randomize();
+}
+
+TEST_CASE("xchacha20_multi versus per hop xchacha20", "[benchmark][xchacha]")
+{
+  sodium::CryptoLibSodium crypto;
+  CryptoManager manager{&crypto};
+
+  constexpr size_t iterations = 10000;
+  const size_t numHops = GENERATE(1, 4, 8);
+  std::vector<SharedSecret> keys;
+  std::vector<TunnelNonce> nonces;
+  MakeHops(numHops, keys, nonces);
+
+  std::vector<byte_t> data(8064);
+  const llarp_buffer_t buf(data);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < iterations; ++n)
+  {
+    for (size_t idx = 0; idx < numHops; ++idx)
+      CryptoManager::instance()->xchacha20(buf, keys[idx], nonces[idx]);
+  }
+  const auto looped = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < iterations; ++n)
+    CryptoManager::instance()->xchacha20_multi(buf, keys.data(), nonces.data(), numHops);
+  const auto fused = std::chrono::steady_clock::now();
+
+  using us = std::chrono::duration<double, std::micro>;
+  WARN(
+      numHops << " hops, " << data.size() << " bytes: per hop "
+              << us(looped - start).count() / iterations << "us, multi "
+              << us(fused - looped).count() / iterations << "us");
+}
@@ -0,0 +1,67 @@
+#include <dht/xor_trie.hpp>
+#include <dht/kademlia.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using llarp::dht::Key_t;
+using llarp::dht::XorTrie;
+
+static Key_t
+RandomKey(std::mt19937_64& rng)
+{
+  Key_t key;
+  for (auto& byte : key)
+    byte = rng();
+  return key;
+}
+
+TEST_CASE("XorTrie k closest versus partial sort", "[benchmark][dht][trie]")
+{
+  const size_t numNodes = GENERATE(1000, 10000, 100000);
+  constexpr size_t numQueries = 1000;
+  constexpr size_t k = 8;
+
+  std::mt19937_64 rng{numNodes};
+  XorTrie<size_t> trie;
+  std::vector<Key_t> keys;
+  for (size_t idx = 0; idx < numNodes; ++idx)
+  {
+    keys.push_back(RandomKey(rng));
+    trie.Insert(keys.back(), idx);
+  }
+  std::vector<Key_t> targets;
+  for (size_t idx = 0; idx < numQueries; ++idx)
+    targets.push_back(RandomKey(rng));
+
+  size_t found = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& target : targets)
+  {
+    std::vector<const Key_t*> all;
+    all.reserve(keys.size());
+    for (const auto& key : keys)
+      all.push_back(&key);
+    std::partial_sort(
+        all.begin(), all.begin() + k, all.end(), [compare = llarp::dht::XorMetric{target}](
+                                                     const auto* a, const auto* b) {
+          return compare(*a, *b);
+        });
+    found += k;
+  }
+  const auto sorted = std::chrono::steady_clock::now();
+  for (const auto& target : targets)
+    found += trie.FindClosest(target, k).size();
+  const auto walked = std::chrono::steady_clock::now();
+
+  using us = std::chrono::duration<double, std::micro>;
+  REQUIRE(found == 2 * k * numQueries);
+  WARN(
+      numNodes << " nodes, " << k << " closest: partial_sort "
+               << us(sorted - start).count() / numQueries << "us, trie "
+               << us(walked - sorted).count() / numQueries << "us");
+}
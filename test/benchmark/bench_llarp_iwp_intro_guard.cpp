@@ -0,0 +1,111 @@
+#include <catch2/catch.hpp>
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <iwp/intro_guard.hpp>
+#include <iwp/session.hpp>
+#include <util/endian.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using llarp::SockAddr;
+using llarp::iwp::IntroGuard;
+
+TEST_CASE("intro flood cost", "[benchmark][iwp]")
+{
+  using namespace llarp;
+  using ns = std::chrono::duration<double, std::nano>;
+  sodium::CryptoLibSodium crypto{};
+  CryptoManager manager{&crypto};
+  auto* const c = CryptoManager::instance();
+
+  SecretKey ourIdentity, ourTransport, theirIdentity, theirOnion;
+  c->identity_keygen(ourIdentity);
+  c->encryption_keygen(ourTransport);
+  c->identity_keygen(theirIdentity);
+  c->encryption_keygen(theirOnion);
+  SharedSecret introKey;
+  c->shorthash(introKey, llarp_buffer_t(ourIdentity.toPublic()));
+
+  // one properly signed intro replayed from spoofed sources, as cheap as a flood gets
+  std::vector<byte_t> intro(iwp::PacketOverhead + iwp::Introduction::SIZE);
+  {
+    byte_t* ptr = intro.data() + iwp::PacketOverhead;
+    const auto pk = theirIdentity.toPublic();
+    const auto onion = theirOnion.toPublic();
+    TunnelNonce N;
+    N.Randomize();
+    std::copy_n(pk.data(), pk.size(), ptr);
+    std::copy_n(onion.data(), onion.size(), ptr + PubKey::SIZE);
+    std::copy_n(N.data(), N.size(), ptr + PubKey::SIZE * 2);
+    Signature Z;
+    c->sign(Z, theirIdentity, llarp_buffer_t(ptr, iwp::Introduction::SIZE - Signature::SIZE));
+    std::copy_n(Z.data(), Z.size(), ptr + iwp::Introduction::SIZE - Signature::SIZE);
+    c->randbytes(intro.data() + HMACSIZE, TUNNONCESIZE);
+    ManagedBuffer buf{llarp_buffer_t{intro.data(), intro.size()}};
+    REQUIRE(c->encrypt_hmac_batch(&buf, 1, introKey));
+  }
+
+  constexpr size_t rounds = 2000;
+  double unguarded, guarded;
+  {
+    // what every intro cost before: a session, the intro key, the decrypt, the signature check,
+    // the dh and an encrypted intro ack
+    std::vector<std::shared_ptr<void>> pending;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < rounds; ++idx)
+    {
+      auto pkt = intro;
+      pending.emplace_back(std::make_shared<std::array<byte_t, sizeof(iwp::Session)>>());
+      SharedSecret key;
+      c->shorthash(key, llarp_buffer_t(ourIdentity.toPublic()));
+      ManagedBuffer buf{llarp_buffer_t{pkt.data(), pkt.size()}};
+      bool valid = false;
+      c->verify_decrypt_batch(&buf, 1, key, &valid);
+      REQUIRE(valid);
+      const byte_t* ptr = pkt.data() + iwp::PacketOverhead;
+      const PubKey ident{ptr};
+      const PubKey onion{ptr + PubKey::SIZE};
+      const TunnelNonce N{ptr + PubKey::SIZE * 2};
+      Signature Z;
+      std::copy_n(ptr + iwp::Introduction::SIZE - Signature::SIZE, Z.size(), Z.data());
+      REQUIRE(c->verify(
+          ident, llarp_buffer_t(ptr, iwp::Introduction::SIZE - Signature::SIZE), Z));
+      REQUIRE(c->transport_dh_server(key, onion, ourTransport, N));
+      std::array<byte_t, iwp::PacketOverhead + IntroGuard::Cookie_t::SIZE> ack{};
+      ManagedBuffer ackbuf{llarp_buffer_t{ack.data(), ack.size()}};
+      c->encrypt_hmac_batch(&ackbuf, 1, key);
+    }
+    unguarded = ns(std::chrono::steady_clock::now() - start).count() / rounds;
+  }
+  {
+    // under load now: the rate table, the intro key, the decrypt and an encrypted retry
+    IntroGuard guard{};
+    const auto now = 1000s;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < rounds; ++idx)
+    {
+      auto pkt = intro;
+      const SockAddr from{10, uint8_t(idx >> 8), uint8_t(idx), 1, 1090};
+      REQUIRE(guard.AllowIntro(from, now));
+      SharedSecret key;
+      c->shorthash(key, llarp_buffer_t(ourIdentity.toPublic()));
+      ManagedBuffer buf{llarp_buffer_t{pkt.data(), pkt.size()}};
+      bool valid = false;
+      c->verify_decrypt_batch(&buf, 1, key, &valid);
+      REQUIRE(valid);
+      std::array<byte_t, iwp::PacketOverhead + iwp::RetrySize> retry{};
+      htobe32buf(retry.data() + iwp::PacketOverhead, iwp::RetryMagic);
+      const auto cookie = guard.MakeCookie(from, now);
+      std::copy_n(cookie.data(), cookie.size(), retry.data() + iwp::PacketOverhead + 4);
+      ManagedBuffer retrybuf{llarp_buffer_t{retry.data(), retry.size()}};
+      c->encrypt_hmac_batch(&retrybuf, 1, key);
+    }
+    guarded = ns(std::chrono::steady_clock::now() - start).count() / rounds;
+  }
+  WARN(
+      "per spoofed intro: without cookies " << unguarded << "ns and a pending session, with "
+                                            << guarded << "ns and no state");
+}
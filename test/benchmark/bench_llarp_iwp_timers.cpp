@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include <constants/link_layer.hpp>
+#include <iwp/message_table.hpp>
+#include <util/time.hpp>
+#include <util/timer_wheel.hpp>
+
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace iwp = llarp::iwp;
+
+namespace
+{
+  /// what the timers look at, stands in for an outbound message
+  struct BenchMessage
+  {
+    llarp_time_t lastFlush;
+    llarp_time_t timerAt = 0s;
+  };
+
+  constexpr size_t BenchSessions = 1000;
+  constexpr size_t BenchInFlight = 100;
+  constexpr auto BenchRTO = 200ms;
+  constexpr auto BenchPumpInterval = 1ms;
+  constexpr size_t BenchPumps = 1000;
+}  // namespace
+
+TEST_CASE("iwp session timers versus scanning", "[benchmark][iwp][table]")
+{
+  using us = std::chrono::duration<double, std::micro>;
+  std::mt19937_64 rng{BenchSessions};
+  const llarp_time_t start = 1000000ms;
+
+  // scan every message of every session on every pump, like Session::Pump used to
+  std::vector<std::unordered_map<uint64_t, BenchMessage>> maps(BenchSessions);
+  // only look at messages whose deadline came up
+  std::vector<iwp::MessageTable<BenchMessage>> tables;
+  tables.reserve(BenchSessions);
+  llarp::util::TimerWheel<std::pair<size_t, uint64_t>> wheel{1ms, start};
+  for (size_t session = 0; session < BenchSessions; ++session)
+  {
+    tables.emplace_back(MaxSendQueueSize);
+    for (uint64_t id = 0; id < BenchInFlight; ++id)
+    {
+      const BenchMessage msg{start - llarp_time_t(rng() % BenchRTO.count())};
+      maps[session].emplace(id, msg);
+      auto* stored = tables.back().Emplace(id, msg);
+      stored->timerAt = stored->lastFlush + BenchRTO;
+      wheel.Schedule(stored->timerAt, {session, id});
+    }
+  }
+
+  size_t scanned = 0;
+  auto now = start;
+  const auto scanStart = std::chrono::steady_clock::now();
+  for (size_t pump = 0; pump < BenchPumps; ++pump)
+  {
+    now += BenchPumpInterval;
+    for (auto& map : maps)
+    {
+      for (auto& [id, msg] : map)
+      {
+        if (now - msg.lastFlush < BenchRTO)
+          continue;
+        msg.lastFlush = now;
+        scanned++;
+      }
+    }
+  }
+  const auto scanEnd = std::chrono::steady_clock::now();
+
+  size_t fired = 0;
+  now = start;
+  for (size_t pump = 0; pump < BenchPumps; ++pump)
+  {
+    now += BenchPumpInterval;
+    wheel.Advance(now, [&](std::pair<size_t, uint64_t> timer) {
+      auto* msg = tables[timer.first].Find(timer.second);
+      if (msg == nullptr or now < msg->timerAt)
+        return;
+      msg->lastFlush = now;
+      msg->timerAt = now + BenchRTO;
+      wheel.Schedule(msg->timerAt, timer);
+      fired++;
+    });
+  }
+  const auto wheelEnd = std::chrono::steady_clock::now();
+
+  // both flushed the same messages
+  REQUIRE(scanned == fired);
+  WARN(
+      BenchSessions << " sessions with " << BenchInFlight << " messages in flight: scan "
+                    << us(scanEnd - scanStart).count() / BenchPumps << "us per pump, wheel "
+                    << us(wheelEnd - scanEnd).count() / BenchPumps << "us per pump");
+}
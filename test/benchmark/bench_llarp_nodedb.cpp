@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <router_contact.hpp>
+#include <nodedb.hpp>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+using llarp_nodedb = llarp::NodeDB;
+
+/// a fresh nodedb directory under the system temp dir
+static fs::path
+MakeNodeDBDir()
+{
+  std::random_device rd;
+  auto dir = fs::temp_directory_path() / ("lokinet-nodedb-bench-" + std::to_string(rd()));
+  fs::create_directories(dir);
+  return dir;
+}
+
+static std::vector<llarp::RouterContact>
+MakeSignedRCs(size_t num)
+{
+  std::vector<llarp::RouterContact> rcs(num);
+  for (auto& rc : rcs)
+  {
+    llarp::SecretKey identity;
+    llarp::CryptoManager::instance()->identity_keygen(identity);
+    rc.pubkey = identity.toPublic();
+    REQUIRE(rc.Sign(identity));
+  }
+  return rcs;
+}
+
+/// write each rc to its own file in the skiplist directories the way older versions stored them
+static void
+WriteRCDirectory(const fs::path& dir, const std::vector<llarp::RouterContact>& rcs)
+{
+  static constexpr char hex[] = "0123456789abcdef";
+  for (const auto& rc : rcs)
+  {
+    const auto sub = dir / std::string(1, hex[rc.pubkey[0] >> 4]);
+    fs::create_directories(sub);
+    REQUIRE(rc.Write(sub / (llarp::RouterID{rc.pubkey}.ToString() + ".signed")));
+  }
+}
+
+TEST_CASE("NodeDB startup from snapshot file versus directory", "[benchmark][nodedb]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager{&crypto};
+  const auto dir = MakeNodeDBDir();
+  const auto runNow = [](auto call) { call(); };
+  constexpr size_t numRCs = 2000;
+
+  {
+    const auto rcs = MakeSignedRCs(numRCs);
+    llarp_nodedb nodeDB{dir, runNow};
+    for (const auto& rc : rcs)
+      nodeDB.Put(rc);
+    nodeDB.SaveToDisk();
+    WriteRCDirectory(dir, rcs);
+  }
+
+  using ms = std::chrono::duration<double, std::milli>;
+  const auto start = std::chrono::steady_clock::now();
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    nodeDB.LoadFromDisk();
+    REQUIRE(nodeDB.NumLoaded() == numRCs);
+  }
+  const auto fromSnapshot = std::chrono::steady_clock::now();
+  fs::remove(dir / "nodedb.snapshot");
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    nodeDB.LoadFromDisk();
+    REQUIRE(nodeDB.NumLoaded() == numRCs);
+  }
+  const auto fromDirectory = std::chrono::steady_clock::now();
+
+  WARN(
+      numRCs << " rcs: snapshot " << ms(fromSnapshot - start).count() << "ms, directory "
+             << ms(fromDirectory - fromSnapshot).count() << "ms");
+  fs::remove_all(dir);
+}
@@ -0,0 +1,87 @@
+#include <service/convo_index.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <vector>
+
+using namespace llarp;
+using namespace std::literals;
+
+namespace
+{
+  service::Address
+  MakeAddress()
+  {
+    service::Address addr;
+    addr.Randomize();
+    return addr;
+  }
+
+  service::ConvoTag
+  MakeTag()
+  {
+    service::ConvoTag tag;
+    tag.Randomize();
+    return tag;
+  }
+}  // namespace
+
+TEST_CASE("best convo lookup against a scan", "[benchmark][service]")
+{
+  using ns = std::chrono::duration<double, std::nano>;
+  constexpr size_t remotes = 4096;
+  constexpr size_t perRemote = 4;
+
+  struct Entry
+  {
+    service::Address remote;
+    llarp_time_t lastUsed;
+  };
+  std::vector<std::pair<service::ConvoTag, Entry>> convos;
+  std::vector<service::Address> addrs;
+  service::ConvoIndex index;
+  for (size_t i = 0; i < remotes; ++i)
+  {
+    addrs.emplace_back(MakeAddress());
+    for (size_t j = 0; j < perRemote; ++j)
+    {
+      const auto tag = MakeTag();
+      const llarp_time_t used(i * perRemote + j);
+      convos.emplace_back(tag, Entry{addrs.back(), used});
+      index.Add(addrs.back(), tag, false, used);
+    }
+  }
+
+  size_t found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& addr : addrs)
+  {
+    std::optional<service::ConvoTag> best;
+    llarp_time_t bestUsed = 0s;
+    for (const auto& [tag, entry] : convos)
+    {
+      if (entry.remote == addr and entry.lastUsed >= bestUsed)
+      {
+        best = tag;
+        bestUsed = entry.lastUsed;
+      }
+    }
+    if (best)
+      ++found;
+  }
+  const double scan = ns(std::chrono::steady_clock::now() - start).count() / remotes;
+  start = std::chrono::steady_clock::now();
+  for (const auto& addr : addrs)
+  {
+    if (index.Best(addr))
+      ++found;
+  }
+  const double indexed = ns(std::chrono::steady_clock::now() - start).count() / remotes;
+  REQUIRE(found == 2 * remotes);
+  WARN(
+      "best convo among " << convos.size() << " convos: scan " << scan << "ns, index " << indexed
+                          << "ns");
+}
@@ -0,0 +1,75 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <service/identity.hpp>
+#include <service/protocol.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  /// a data frame on an established convo, as the send paths fill it in
+  service::ProtocolMessage
+  MakeMessage(const service::Identity& sender, const service::ConvoTag& tag, size_t payload)
+  {
+    service::ProtocolMessage msg{tag};
+    msg.proto = service::eProtocolTrafficV4;
+    msg.sender = sender.pub;
+    msg.seqno = 1;
+    msg.payload.resize(payload, 0x42);
+    return msg;
+  }
+
+  service::ProtocolFrame
+  MakeFrame(const service::ConvoTag& tag)
+  {
+    service::ProtocolFrame frame;
+    frame.N.Randomize();
+    frame.F.Randomize();
+    frame.T = tag;
+    return frame;
+  }
+}  // namespace
+
+TEST_CASE("per frame cost of signatures and macs", "[benchmark][service]")
+{
+  using ns = std::chrono::duration<double, std::nano>;
+  sodium::CryptoLibSodium crypto{};
+  CryptoManager manager{&crypto};
+  service::Identity alice;
+  alice.RegenerateKeys();
+  service::ConvoTag tag;
+  tag.Randomize();
+  SharedSecret key;
+  key.Randomize();
+  const auto msg = MakeMessage(alice, tag, 1024);
+  const auto addr = alice.pub.Addr();
+  constexpr size_t rounds = 2000;
+
+  const auto measure = [&](bool mac) {
+    std::vector<service::ProtocolFrame> frames(rounds, MakeFrame(tag));
+    auto start = std::chrono::steady_clock::now();
+    for (auto& frame : frames)
+      REQUIRE(mac ? frame.EncryptAndMAC(msg, key, addr) : frame.EncryptAndSign(msg, key, alice));
+    const double send = ns(std::chrono::steady_clock::now() - start).count() / rounds;
+    start = std::chrono::steady_clock::now();
+    for (const auto& frame : frames)
+    {
+      REQUIRE(mac ? frame.VerifyMAC(key, addr) : frame.Verify(alice.pub));
+      service::ProtocolMessage into;
+      REQUIRE(frame.DecryptPayloadInto(key, into));
+    }
+    const double recv = ns(std::chrono::steady_clock::now() - start).count() / rounds;
+    return std::make_pair(send, recv);
+  };
+  const auto [signSend, signRecv] = measure(false);
+  const auto [macSend, macRecv] = measure(true);
+  WARN(
+      "per 1KiB frame: signed " << signSend << "ns to send, " << signRecv << "ns to receive; mac "
+                                << macSend << "ns to send, " << macRecv << "ns to receive");
+}
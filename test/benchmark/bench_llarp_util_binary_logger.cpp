@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+
+#include <util/logging/binary_logger.hpp>
+#include <util/time.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+TEST_CASE("binary log entry cost", "[benchmark][util][logging]")
+{
+  using ns = std::chrono::duration<double, std::nano>;
+  FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  constexpr size_t rounds = 100000;
+  const std::string remote(64, 'a');
+  double binary, text;
+  {
+    llarp::BinaryLogStream stream{f, "node", false};
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < rounds; ++idx)
+      stream.Record(llarp::eLogInfo, "file.cpp", __LINE__, "send ", idx, " bytes to ", remote);
+    binary = ns(std::chrono::steady_clock::now() - start).count() / rounds;
+  }
+  {
+    // what the file log type pays on the calling thread before queueing the line
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < rounds; ++idx)
+    {
+      std::stringstream ss;
+      ss << "[I] [node] " << llarp::time_now_ms().count() << " file.cpp:" << __LINE__ << "\t"
+         << "send " << idx << " bytes to " << remote;
+      const auto line = ss.str();
+      REQUIRE(not line.empty());
+    }
+    text = ns(std::chrono::steady_clock::now() - start).count() / rounds;
+  }
+  std::fclose(f);
+  WARN(
+      "per entry on the logging thread: binary " << binary << "ns, formatted text " << text
+                                                 << "ns");
+}
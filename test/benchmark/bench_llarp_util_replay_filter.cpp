@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include <crypto/types.hpp>
+#include <util/replay_filter.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+using llarp::util::NonceReplayFilter;
+
+namespace
+{
+  size_t allocated = 0;
+
+  /// counts the bytes a container holds on to
+  template <typename T>
+  struct CountingAllocator
+  {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&)
+    {}
+
+    T*
+    allocate(size_t n)
+    {
+      allocated += n * sizeof(T);
+      return std::allocator<T>{}.allocate(n);
+    }
+
+    void
+    deallocate(T* p, size_t n)
+    {
+      allocated -= n * sizeof(T);
+      std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool
+    operator==(const CountingAllocator<U>&) const
+    {
+      return true;
+    }
+
+    template <typename U>
+    bool
+    operator!=(const CountingAllocator<U>&) const
+    {
+      return false;
+    }
+  };
+}  // namespace
+
+TEST_CASE("replay filter memory per transit hop", "[benchmark][util][replay]")
+{
+  // what util::DecayingHashSet keeps per nonce
+  using Map_t = std::unordered_map<
+      llarp::TunnelNonce,
+      llarp_time_t,
+      llarp::TunnelNonce::Hash,
+      std::equal_to<llarp::TunnelNonce>,
+      CountingAllocator<std::pair<const llarp::TunnelNonce, llarp_time_t>>>;
+
+  static constexpr auto interval = 5s;
+  const auto rate = GENERATE(size_t{10}, size_t{100}, size_t{1000});
+  const llarp_time_t start = 1000000s;
+
+  Map_t map;
+  NonceReplayFilter<llarp::TunnelNonce> filter{interval};
+  filter.Decay(start);
+  size_t mapPeak = 0;
+  size_t filterPeak = 0;
+  llarp::TunnelNonce nonce;
+  // a few intervals of traffic in one direction of a hop, decayed once a second
+  for (auto now = start; now < start + interval * 4; now += 1s)
+  {
+    for (size_t idx = 0; idx < rate; ++idx)
+    {
+      nonce.Randomize();
+      map.emplace(nonce, now);
+      filter.Insert(nonce);
+    }
+    for (auto itr = map.begin(); itr != map.end();)
+    {
+      if (itr->second + interval <= now)
+        itr = map.erase(itr);
+      else
+        ++itr;
+    }
+    filter.Decay(now);
+    mapPeak = std::max(mapPeak, allocated);
+    filterPeak = std::max(filterPeak, filter.MemoryUsage());
+  }
+  WARN(
+      rate << " packets/s per direction: hashset " << mapPeak << " bytes, replay filter "
+           << filterPeak << " bytes, "
+           << (mapPeak > filterPeak ? mapPeak - filterPeak : 0) * 2 << " bytes saved per hop");
+}
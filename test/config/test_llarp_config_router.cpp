@@ -0,0 +1,47 @@
+#include <config/config.hpp>
+#include <config/definition.hpp>
+
+#include <catch2/catch.hpp>
+
+namespace
+{
+  /// define the [router] section into a fresh config definition and feed it one value
+  void
+  ParseRouterOption(llarp::RouterConfig& router, std::string_view name, std::string_view value)
+  {
+    llarp::ConfigGenParameters params;
+    params.defaultDataDir = fs::current_path();
+    llarp::ConfigDefinition conf{false};
+    router.defineConfigOptions(conf, params);
+    conf.addConfigValue("router", name, value);
+    conf.acceptAllOptions();
+  }
+}  // namespace
+
+TEST_CASE("[router]:udp-batch-size defaults to no batching", "[config]")
+{
+  llarp::RouterConfig router;
+  llarp::ConfigGenParameters params;
+  params.defaultDataDir = fs::current_path();
+  llarp::ConfigDefinition conf{false};
+  router.defineConfigOptions(conf, params);
+  conf.acceptAllOptions();
+  CHECK(router.m_UDPBatchSize == 0);
+}
+
+TEST_CASE("[router]:udp-batch-size accepts values in range", "[config]")
+{
+  const auto size = GENERATE(0, 1, 32, 1024);
+  llarp::RouterConfig router;
+  CHECK_NOTHROW(ParseRouterOption(router, "udp-batch-size", std::to_string(size)));
+  CHECK(router.m_UDPBatchSize == size_t(size));
+}
+
+TEST_CASE("[router]:udp-batch-size rejects values out of range", "[config]")
+{
+  const auto size = GENERATE(-1, 1025, 65536);
+  llarp::RouterConfig router;
+  CHECK_THROWS_AS(
+      ParseRouterOption(router, "udp-batch-size", std::to_string(size)), std::invalid_argument);
+  CHECK(router.m_UDPBatchSize == 0);
+}
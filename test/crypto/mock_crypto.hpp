@@ -22,6 +22,17 @@ namespace llarp
                    bool(const llarp_buffer_t &, const llarp_buffer_t &,
                         const SharedSecret &, const byte_t *));
 
+      MOCK_METHOD4(xchacha20_multi,
+                   bool(const llarp_buffer_t &, const SharedSecret *,
+                        const TunnelNonce *, size_t));
+
+      MOCK_METHOD3(encrypt_hmac_batch,
+                   bool(const ManagedBuffer *, size_t, const SharedSecret &));
+
+      MOCK_METHOD4(verify_decrypt_batch,
+                   void(const ManagedBuffer *, size_t, const SharedSecret &,
+                        bool *));
+
       MOCK_METHOD4(dh_client,
                    bool(SharedSecret &, const PubKey &, const SecretKey &,
                         const TunnelNonce &));
@@ -0,0 +1,83 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace llarp;
+
+static constexpr size_t Overhead = HMACSIZE + TUNNONCESIZE;
+
+/// num random packets of sz bytes each with a random nonce
+static std::vector<std::vector<byte_t>>
+MakePackets(size_t num, size_t sz)
+{
+  std::vector<std::vector<byte_t>> pkts(num, std::vector<byte_t>(sz));
+  for (auto& pkt : pkts)
+    CryptoManager::instance()->randbytes(pkt.data(), pkt.size());
+  return pkts;
+}
+
+static std::vector<ManagedBuffer>
+Buffers(std::vector<std::vector<byte_t>>& pkts)
+{
+  std::vector<ManagedBuffer> bufs;
+  for (auto& pkt : pkts)
+    bufs.emplace_back(llarp_buffer_t{pkt});
+  return bufs;
+}
+
+TEST_CASE("encrypt_hmac_batch matches per packet xchacha20 and hmac", "[crypto][batch]")
+{
+  sodium::CryptoLibSodium crypto;
+  CryptoManager manager{&crypto};
+
+  SharedSecret key;
+  key.Randomize();
+  const size_t sz = GENERATE(Overhead, Overhead + 1, 200, 1472);
+  auto pkts = MakePackets(8, sz);
+  auto expected = pkts;
+
+  for (auto& pkt : expected)
+  {
+    const TunnelNonce nonce{pkt.data() + HMACSIZE};
+    const llarp_buffer_t body{pkt.data() + Overhead, pkt.size() - Overhead};
+    REQUIRE(crypto.xchacha20(body, key, nonce));
+    const llarp_buffer_t authed{pkt.data() + HMACSIZE, pkt.size() - HMACSIZE};
+    REQUIRE(crypto.hmac(pkt.data(), authed, key));
+  }
+
+  auto bufs = Buffers(pkts);
+  REQUIRE(crypto.encrypt_hmac_batch(bufs.data(), bufs.size(), key));
+  REQUIRE(pkts == expected);
+}
+
+TEST_CASE("verify_decrypt_batch round trips and rejects bad packets", "[crypto][batch]")
+{
+  sodium::CryptoLibSodium crypto;
+  CryptoManager manager{&crypto};
+
+  SharedSecret key;
+  key.Randomize();
+  auto pkts = MakePackets(4, 512);
+  const auto plaintext = pkts;
+
+  auto bufs = Buffers(pkts);
+  REQUIRE(crypto.encrypt_hmac_batch(bufs.data(), bufs.size(), key));
+
+  // flip a bit in the ciphertext of one and in the nonce of another
+  pkts[1][Overhead + 10] ^= 1;
+  pkts[2][HMACSIZE] ^= 1;
+  // and truncate one below the header
+  pkts[3].resize(Overhead - 1);
+  bufs = Buffers(pkts);
+
+  bool valid[4];
+  crypto.verify_decrypt_batch(bufs.data(), bufs.size(), key, valid);
+  REQUIRE(valid[0]);
+  REQUIRE(std::equal(pkts[0].begin() + Overhead, pkts[0].end(), plaintext[0].begin() + Overhead));
+  REQUIRE(not valid[1]);
+  REQUIRE(not valid[2]);
+  REQUIRE(not valid[3]);
+}
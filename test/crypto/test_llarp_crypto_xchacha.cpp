@@ -0,0 +1,45 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace llarp;
+
+/// random keys and nonces for a path of numHops hops
+static void
+MakeHops(size_t numHops, std::vector<SharedSecret>& keys, std::vector<TunnelNonce>& nonces)
+{
+  keys.resize(numHops);
+  nonces.resize(numHops);
+  for (auto& key : keys)
+    key.Randomize();
+  for (auto& nonce : nonces)
+    nonce.Randomize();
+}
+
+TEST_CASE("xchacha20_multi matches xchacha20 once per key", "[crypto][xchacha]")
+{
+  sodium::CryptoLibSodium crypto;
+  CryptoManager manager{&crypto};
+
+  const size_t numHops = GENERATE(1, 2, 4, 8, 11);
+  const size_t size = GENERATE(0, 1, 63, 64, 65, 4095, 4096, 4097, 8064);
+
+  std::vector<SharedSecret> keys;
+  std::vector<TunnelNonce> nonces;
+  MakeHops(numHops, keys, nonces);
+
+  std::vector<byte_t> expected(size);
+  crypto.randbytes(expected.data(), expected.size());
+  auto fused = expected;
+
+  const llarp_buffer_t expectedBuf(expected);
+  for (size_t idx = 0; idx < numHops; ++idx)
+    REQUIRE(crypto.xchacha20(expectedBuf, keys[idx], nonces[idx]));
+
+  const llarp_buffer_t fusedBuf(fused);
+  REQUIRE(crypto.xchacha20_multi(fusedBuf, keys.data(), nonces.data(), numHops));
+  REQUIRE(fused == expected);
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+
+#include <dht/messages/gotintro.hpp>
+
+#include <optional>
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  using Reply_t = std::optional<std::vector<service::EncryptedIntroSet>>;
+
+  /// lookup that records what it would have replied with
+  struct RecordingTX final : public dht::TX<dht::TXOwner, service::EncryptedIntroSet>
+  {
+    RecordingTX(const dht::TXOwner& owner, Reply_t& reply)
+        : dht::TX<dht::TXOwner, service::EncryptedIntroSet>(owner, owner, nullptr), m_Reply(reply)
+    {}
+
+    bool
+    Validate(const service::EncryptedIntroSet&) const override
+    {
+      return true;
+    }
+
+    void
+    Start(const dht::TXOwner&) override
+    {}
+
+    void
+    SendReply() override
+    {
+      m_Reply = valuesFound;
+    }
+
+    Reply_t& m_Reply;
+  };
+
+  service::EncryptedIntroSet
+  MakeIntroSet(byte_t tag)
+  {
+    service::EncryptedIntroSet introset;
+    introset.derivedSigningKey.Fill(tag);
+    introset.signedAt = 1s * tag;
+    return introset;
+  }
+}  // namespace
+
+TEST_CASE("GotIntro keeps the valid introsets when one of several is bad", "[dht][introset]")
+{
+  dht::GotIntroMessage::PendingLookups_t pending;
+  const dht::TXOwner owner{dht::Key_t{}, 1};
+  Reply_t reply;
+  pending.NewTX(owner, owner, owner, new RecordingTX{owner, reply});
+  REQUIRE(pending.HasPendingLookupFrom(owner));
+
+  const std::vector<service::EncryptedIntroSet> introsets{
+      MakeIntroSet(1), MakeIntroSet(2), MakeIntroSet(3)};
+  dht::GotIntroMessage::FinishLookup(pending, owner, introsets, {true, false, true});
+
+  REQUIRE(reply.has_value());
+  REQUIRE(not pending.HasPendingLookupFrom(owner));
+  REQUIRE(reply->size() == 2);
+  CHECK(reply->at(0) == introsets[0]);
+  CHECK(reply->at(1) == introsets[2]);
+}
+
+TEST_CASE("GotIntro finishes the lookup as not found when every introset is bad", "[dht][introset]")
+{
+  dht::GotIntroMessage::PendingLookups_t pending;
+  const dht::TXOwner owner{dht::Key_t{}, 2};
+  Reply_t reply;
+  pending.NewTX(owner, owner, owner, new RecordingTX{owner, reply});
+
+  dht::GotIntroMessage::FinishLookup(
+      pending, owner, {MakeIntroSet(1), MakeIntroSet(2)}, {false, false});
+
+  REQUIRE(reply.has_value());
+  REQUIRE(not pending.HasPendingLookupFrom(owner));
+  CHECK(reply->empty());
+}
@@ -0,0 +1,115 @@
+#include <dht/xor_trie.hpp>
+#include <dht/kademlia.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using llarp::dht::Key_t;
+using llarp::dht::XorTrie;
+
+static Key_t
+RandomKey(std::mt19937_64& rng)
+{
+  Key_t key;
+  for (auto& byte : key)
+    byte = rng();
+  return key;
+}
+
+/// the n closest keys by sorting everything, what the trie has to agree with
+static std::vector<Key_t>
+SortedClosest(std::vector<Key_t> keys, const Key_t& target, size_t n)
+{
+  const auto mid = keys.begin() + std::min(n, keys.size());
+  std::partial_sort(keys.begin(), mid, keys.end(), llarp::dht::XorMetric{target});
+  keys.erase(mid, keys.end());
+  return keys;
+}
+
+TEST_CASE("XorTrie insert, find, replace and erase", "[dht][trie]")
+{
+  XorTrie<int> trie;
+  Key_t a, b, c;
+  a.Fill(0x01);
+  b.Fill(0x02);
+  c = a;
+  c[31] = 0x00;
+
+  REQUIRE(trie.empty());
+  REQUIRE(trie.Find(a) == nullptr);
+  REQUIRE(not trie.Erase(a));
+
+  trie.Insert(a, 1);
+  trie.Insert(b, 2);
+  trie.Insert(c, 3);
+  REQUIRE(trie.size() == 3);
+  REQUIRE(*trie.Find(a) == 1);
+  REQUIRE(*trie.Find(b) == 2);
+  REQUIRE(*trie.Find(c) == 3);
+
+  trie.Insert(a, 10);
+  REQUIRE(trie.size() == 3);
+  REQUIRE(*trie.Find(a) == 10);
+
+  REQUIRE(trie.Erase(c));
+  REQUIRE(not trie.Has(c));
+  REQUIRE(trie.Has(a));
+  REQUIRE(trie.size() == 2);
+  REQUIRE(not trie.Erase(c));
+
+  std::vector<Key_t> order;
+  trie.ForEach([&order](const Key_t& key, int) { order.push_back(key); });
+  REQUIRE(order == std::vector<Key_t>{a, b});
+}
+
+TEST_CASE("XorTrie copies do not see later changes", "[dht][trie]")
+{
+  XorTrie<int> trie;
+  Key_t a, b;
+  a.Fill(0x10);
+  b.Fill(0x20);
+  trie.Insert(a, 1);
+
+  const auto copy = trie;
+  trie.Insert(b, 2);
+  trie.Insert(a, 3);
+  trie.Erase(b);
+
+  REQUIRE(copy.size() == 1);
+  REQUIRE(*copy.Find(a) == 1);
+  REQUIRE(not copy.Has(b));
+  REQUIRE(*trie.Find(a) == 3);
+}
+
+TEST_CASE("XorTrie closest matches sorting by xor distance", "[dht][trie]")
+{
+  std::mt19937_64 rng{GENERATE(1, 2, 3)};
+  const size_t want = GENERATE(1, 8, 1000);
+  XorTrie<size_t> trie;
+  std::vector<Key_t> keys;
+  for (size_t idx = 0; idx < 500; ++idx)
+  {
+    keys.push_back(RandomKey(rng));
+    trie.Insert(keys.back(), idx);
+  }
+  // drop some so erase gets exercised too
+  for (size_t idx = 0; idx < 100; ++idx)
+  {
+    REQUIRE(trie.Erase(keys.back()));
+    keys.pop_back();
+  }
+  REQUIRE(trie.size() == keys.size());
+
+  for (int n = 0; n < 50; ++n)
+  {
+    const auto target = n == 0 ? keys[0] : RandomKey(rng);
+    const auto expected = SortedClosest(keys, target, want);
+    const auto closest = trie.FindClosest(target, want);
+    REQUIRE(closest.size() == expected.size());
+    for (size_t idx = 0; idx < closest.size(); ++idx)
+      REQUIRE(closest[idx].first == expected[idx]);
+  }
+}
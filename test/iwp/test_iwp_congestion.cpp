@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+
+#include <iwp/congestion.hpp>
+
+using llarp::iwp::CongestionControl;
+
+TEST_CASE("iwp congestion window grows and backs off", "[iwp][congestion]")
+{
+  CongestionControl cc;
+  REQUIRE(cc.Window() == CongestionControl::InitialWindow);
+
+  // slow start doubles per window acked
+  cc.OnAcked(CongestionControl::InitialWindow);
+  REQUIRE(cc.Window() == CongestionControl::InitialWindow * 2);
+
+  // a loss halves it and only counts once per round trip
+  cc.OnRTTSample(50ms);
+  cc.OnLoss(1000ms);
+  REQUIRE(cc.Window() == CongestionControl::InitialWindow);
+  cc.OnLoss(1010ms);
+  REQUIRE(cc.Window() == CongestionControl::InitialWindow);
+  cc.OnLoss(1100ms);
+  REQUIRE(cc.Window() == CongestionControl::InitialWindow / 2);
+
+  // congestion avoidance grows one fragment per window acked
+  const auto window = cc.Window();
+  cc.OnAcked(window - 1);
+  REQUIRE(cc.Window() == window);
+  cc.OnAcked(1);
+  REQUIRE(cc.Window() == window + 1);
+
+  // a dropped message falls back to the minimum
+  cc.OnTimeout(2000ms);
+  REQUIRE(cc.Window() == CongestionControl::MinWindow);
+}
+
+TEST_CASE("iwp congestion window admits messages", "[iwp][congestion]")
+{
+  CongestionControl cc;
+  REQUIRE(cc.CanSend(0, CongestionControl::InitialWindow));
+  REQUIRE(cc.CanSend(2, CongestionControl::InitialWindow - 2));
+  REQUIRE_FALSE(cc.CanSend(3, CongestionControl::InitialWindow - 2));
+  // a message bigger than the window still goes out on an idle session
+  cc.OnTimeout(0ms);
+  REQUIRE(cc.CanSend(0, 8));
+  REQUIRE_FALSE(cc.CanSend(1, 8));
+}
+
+TEST_CASE("iwp retransmit timeout follows rtt", "[iwp][congestion]")
+{
+  CongestionControl cc;
+  REQUIRE(cc.RTO() == CongestionControl::InitialRTO);
+
+  for (int i = 0; i < 16; ++i)
+    cc.OnRTTSample(20ms);
+  REQUIRE(cc.SRTT() == 20ms);
+  REQUIRE(cc.RTO() == CongestionControl::MinRTO);
+
+  for (int i = 0; i < 32; ++i)
+    cc.OnRTTSample(250ms);
+  REQUIRE(cc.SRTT() > 200ms);
+  REQUIRE(cc.RTO() > cc.SRTT());
+
+  // a path slower than the initial rto still gets an rto above its rtt
+  for (int i = 0; i < 32; ++i)
+    cc.OnRTTSample(900ms);
+  REQUIRE(cc.SRTT() > 800ms);
+  REQUIRE(cc.RTO() > cc.SRTT());
+}
+
+TEST_CASE("iwp retransmit timeout backs off until a fresh sample", "[iwp][congestion]")
+{
+  CongestionControl cc;
+  for (int i = 0; i < 16; ++i)
+    cc.OnRTTSample(200ms);
+  const auto base = cc.RTO();
+  REQUIRE(cc.BaseRTO() == base);
+
+  // expiring again within the same rto counts once
+  cc.OnRTOExpired(1000ms);
+  REQUIRE(cc.RTO() == base * 2);
+  cc.OnRTOExpired(1010ms);
+  REQUIRE(cc.RTO() == base * 2);
+  cc.OnRTOExpired(1000ms + base * 2);
+  REQUIRE(cc.RTO() == base * 4);
+  REQUIRE(cc.BaseRTO() == base);
+
+  // backoff is bounded
+  llarp_time_t now = 10s;
+  for (size_t i = 0; i < CongestionControl::MaxBackoff * 2; ++i)
+  {
+    cc.OnRTOExpired(now);
+    now += CongestionControl::MaxRTO;
+  }
+  REQUIRE(cc.RTO() == base * (1 << CongestionControl::MaxBackoff));
+
+  cc.OnRTTSample(200ms);
+  REQUIRE(cc.RTO() == base);
+}
+
+TEST_CASE("iwp pacing spreads a window over a round trip", "[iwp][congestion]")
+{
+  CongestionControl cc;
+  // no pacing before we know the rtt
+  cc.Refill(1000ms);
+  for (int i = 0; i < 100; ++i)
+    REQUIRE(cc.TakePacingBudget(1500));
+
+  cc.OnRTTSample(100ms);
+  cc.Refill(2000ms);
+  size_t sent = 0;
+  while (cc.TakePacingBudget(1500))
+    sent++;
+  // one burst goes out at once, then we have to wait
+  REQUIRE(sent > 0);
+  REQUIRE(sent <= CongestionControl::InitialWindow + 1);
+  REQUIRE_FALSE(cc.TakePacingBudget(1500));
+
+  // after a whole rtt at least a window's worth is allowed again
+  cc.Refill(2100ms);
+  sent = 0;
+  while (cc.TakePacingBudget(1500))
+    sent++;
+  REQUIRE(sent >= CongestionControl::InitialWindow);
+}
+
+TEST_CASE("iwp pacing counts in the session's packet size", "[iwp][congestion]")
+{
+  const size_t packetSize = GENERATE(size_t{600}, size_t{1100}, size_t{4400});
+  CongestionControl cc;
+  cc.SetPacketSize(packetSize);
+  cc.OnRTTSample(100ms);
+
+  // the burst and the rate are a window of packets whatever their size
+  cc.Refill(1000ms);
+  size_t sent = 0;
+  while (cc.TakePacingBudget(packetSize))
+    sent++;
+  REQUIRE(sent == CongestionControl::InitialWindow);
+
+  cc.Refill(1100ms);
+  sent = 0;
+  while (cc.TakePacingBudget(packetSize))
+    sent++;
+  REQUIRE(sent == CongestionControl::InitialWindow);
+}
@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <iwp/intro_guard.hpp>
+
+using llarp::SockAddr;
+using llarp::iwp::IntroGuard;
+
+namespace
+{
+  SockAddr
+  IPv6(const char* str, uint16_t port)
+  {
+    in6_addr ip;
+    REQUIRE(inet_pton(AF_INET6, str, &ip) == 1);
+    SockAddr addr{ip};
+    addr.setPort(port);
+    return addr;
+  }
+}  // namespace
+
+TEST_CASE("intro cookies only check for the address they were made for", "[iwp]")
+{
+  llarp::sodium::CryptoLibSodium crypto{};
+  llarp::CryptoManager manager{&crypto};
+  IntroGuard guard{};
+  const auto now = 1000s;
+  const SockAddr from{10, 0, 0, 1, 1090};
+  const auto cookie = guard.MakeCookie(from, now);
+  REQUIRE(guard.CheckCookie(from, cookie, now));
+  REQUIRE_FALSE(guard.CheckCookie(SockAddr{10, 0, 0, 2, 1090}, cookie, now));
+  REQUIRE_FALSE(guard.CheckCookie(SockAddr{10, 0, 0, 1, 1091}, cookie, now));
+  REQUIRE_FALSE(guard.CheckCookie(from, IntroGuard::Cookie_t{}, now));
+  // another router makes other cookies
+  IntroGuard other{};
+  REQUIRE_FALSE(other.CheckCookie(from, cookie, now));
+}
+
+TEST_CASE("intro cookies expire", "[iwp]")
+{
+  llarp::sodium::CryptoLibSodium crypto{};
+  llarp::CryptoManager manager{&crypto};
+  IntroGuard guard{};
+  const SockAddr from{10, 0, 0, 1, 1090};
+  // made at the very end of an interval it still holds for the whole next one
+  const llarp_time_t made = IntroGuard::CookieInterval * 100 - 1ms;
+  const auto cookie = guard.MakeCookie(from, made);
+  REQUIRE(guard.CheckCookie(from, cookie, made + IntroGuard::CookieInterval));
+  REQUIRE_FALSE(guard.CheckCookie(from, cookie, made + 1ms + IntroGuard::CookieInterval * 2));
+}
+
+TEST_CASE("intros are rate limited per source prefix", "[iwp]")
+{
+  llarp::sodium::CryptoLibSodium crypto{};
+  llarp::CryptoManager manager{&crypto};
+  IntroGuard guard{};
+  const auto now = 1000s;
+  // every host and port in a /24 counts against the same limit
+  for (uint16_t idx = 0; idx < IntroGuard::MaxIntrosPerPrefix; ++idx)
+    REQUIRE(guard.AllowIntro(SockAddr{10, 0, 0, uint8_t(idx), uint16_t(1000 + idx)}, now));
+  REQUIRE_FALSE(guard.AllowIntro(SockAddr{10, 0, 0, 200, 1}, now));
+  REQUIRE(guard.rateLimited == 1);
+  REQUIRE(guard.AllowIntro(SockAddr{10, 0, 1, 1, 1}, now));
+  REQUIRE(guard.AllowIntro(SockAddr{10, 0, 0, 200, 1}, now + IntroGuard::RateInterval));
+
+  // and every address in an ipv6 /48
+  const auto later = now + IntroGuard::RateInterval * 2;
+  for (uint16_t idx = 0; idx < IntroGuard::MaxIntrosPerPrefix; ++idx)
+    REQUIRE(guard.AllowIntro(IPv6("2001:db8:1::1", 1000 + idx), later));
+  REQUIRE_FALSE(guard.AllowIntro(IPv6("2001:db8:1:ffff::2", 1), later));
+  REQUIRE(guard.AllowIntro(IPv6("2001:db8:2::1", 1), later));
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <iwp/message_buffer.hpp>
+#include <iwp/message_table.hpp>
+#include <iwp/session.hpp>
+
+#include <vector>
+
+namespace iwp = llarp::iwp;
+
+namespace
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager cmanager(&crypto);
+
+  llarp::ILinkSession::Message_t
+  MakeMessage(size_t sz)
+  {
+    llarp::ILinkSession::Message_t msg(sz);
+    cmanager.instance()->randbytes(msg.data(), msg.size());
+    return msg;
+  }
+
+  /// feed the data fragments an outbound message flushes into an inbound one
+  size_t
+  Deliver(iwp::OutboundMessage& tx, iwp::InboundMessage& rx, llarp_time_t now)
+  {
+    std::vector<llarp::ILinkSession::Packet_t> frags;
+    const auto sent = tx.FlushUnAcked(
+        [&](llarp::ILinkSession::Packet_t pkt) { frags.emplace_back(std::move(pkt)); }, now);
+    for (const auto& pkt : frags)
+    {
+      const uint16_t idx = bufbe16toh(pkt.data() + iwp::PacketOverhead + iwp::CommandOverhead);
+      const llarp_buffer_t buf(
+          pkt.data() + iwp::PacketOverhead + 12, pkt.size() - (iwp::PacketOverhead + 12));
+      rx.HandleData(idx, buf, now);
+    }
+    return sent;
+  }
+}  // namespace
+
+TEST_CASE("iwp messages use their own fragment size", "[iwp][fragment]")
+{
+  const auto fragsz = GENERATE(
+      iwp::MinFragmentSize, iwp::DefaultFragmentSize, size_t{1344}, iwp::MaxFragmentSize);
+  const auto now = llarp::time_now_ms();
+  iwp::OutboundMessage tx{0, MakeMessage(MAX_LINK_MSG_SIZE), now, nullptr, fragsz};
+  REQUIRE(tx.NumFragments() == (MAX_LINK_MSG_SIZE + fragsz - 1) / fragsz);
+
+  const auto xmit = tx.XMIT();
+  REQUIRE(xmit.size() == iwp::PacketOverhead + iwp::CommandOverhead + 42 + fragsz);
+
+  iwp::InboundMessage rx{0, MAX_LINK_MSG_SIZE, tx.m_Digest, now, fragsz};
+  rx.HandleData(0, llarp_buffer_t{xmit.data() + xmit.size() - fragsz, fragsz}, now);
+  REQUIRE(Deliver(tx, rx, now) == tx.NumFragments() - 1);
+  REQUIRE(rx.IsCompleted());
+  REQUIRE(rx.Verify());
+
+  // the acks make it back to the sender in one or two mask bytes
+  const auto acks = rx.ACKS();
+  uint16_t mask = acks[iwp::PacketOverhead + 10];
+  if (tx.NumFragments() > 8)
+    mask |= uint16_t{acks[iwp::PacketOverhead + 11]} << 8;
+  tx.Ack(mask);
+  REQUIRE(tx.IsTransmitted());
+  REQUIRE(tx.NumUnAcked() == 0);
+}
+
+TEST_CASE("iwp resends only fragments that were not acked", "[iwp][fragment]")
+{
+  const auto now = llarp::time_now_ms();
+  iwp::OutboundMessage tx{0, MakeMessage(MAX_LINK_MSG_SIZE), now, nullptr, iwp::MinFragmentSize};
+  REQUIRE(tx.NumFragments() == iwp::MaxFragments);
+  // everything but the last fragment made it
+  tx.Ack(0x7fff);
+  REQUIRE_FALSE(tx.IsTransmitted());
+  REQUIRE(tx.NumUnAcked() == 1);
+  size_t resent = 0;
+  tx.FlushUnAcked([&](llarp::ILinkSession::Packet_t) { resent++; }, now);
+  REQUIRE(resent == 1);
+}
+
+TEST_CASE("iwp rejects fragments off the fragment grid", "[iwp][fragment]")
+{
+  const auto now = llarp::time_now_ms();
+  const auto msg = MakeMessage(3000);
+  llarp::ShortHash h;
+  iwp::InboundMessage rx{0, 3000, h, now, 1344};
+  rx.HandleData(1024, llarp_buffer_t{msg.data() + 1024, 1344}, now);
+  REQUIRE(rx.m_Acks.none());
+  rx.HandleData(1344, llarp_buffer_t{msg.data() + 1344, 1344}, now);
+  REQUIRE(rx.m_Acks.test(1));
+}
+
+TEST_CASE("iwp message table finds messages by msgid", "[iwp][table]")
+{
+  iwp::MessageTable<int> table{64};
+  for (uint64_t id = 100; id < 120; ++id)
+    REQUIRE(table.Emplace(id, int(id)) != nullptr);
+  REQUIRE(table.size() == 20);
+  // the same msgid twice is refused
+  REQUIRE(table.Emplace(105, 0) == nullptr);
+  for (uint64_t id = 100; id < 120; ++id)
+  {
+    REQUIRE(table.Find(id) != nullptr);
+    REQUIRE(*table.Find(id) == int(id));
+  }
+  REQUIRE(table.Find(99) == nullptr);
+  REQUIRE(table.Find(100 + 64) == nullptr);
+
+  table.Erase(110);
+  REQUIRE(table.Find(110) == nullptr);
+  REQUIRE(table.size() == 19);
+  // a msgid that lands on a live one once the ring is at its max size is refused
+  REQUIRE(table.Emplace(101 + 64, 0) == nullptr);
+  REQUIRE(table.Emplace(110 + 64, 0) != nullptr);
+  REQUIRE(table.size() == 20);
+}
@@ -110,7 +110,7 @@ struct IWPLinkContext
         // pump done handler
         []() {},
         // do work function
-        [l = m_Loop](llarp::Work_t work) { l->call_soon(work); });
+        [l = m_Loop](uint64_t, llarp::Work_t work) { l->call_soon(work); });
     REQUIRE(link->Configure(
         m_Loop, llarp::net::LoopbackInterfaceName(), AF_INET, *localAddr.getPort()));
 
@@ -258,7 +258,7 @@ TEST_CASE("IWP send messages", "[iwp]")
         alice->Call([session, endIfDone, alice, &aliceNumSent]() {
           // generate a discard message that is 512 bytes long
           llarp::DiscardMessage msg;
-          std::vector<byte_t> msgBuff(512);
+          llarp::ILinkSession::Message_t msgBuff(512);
           llarp_buffer_t buf(msgBuff);
           // add random padding
           llarp::CryptoManager::instance()->randomize(buf);
@@ -284,7 +284,7 @@ TEST_CASE("IWP send messages", "[iwp]")
         bob->Call([session, endIfDone, bob, &bobNumSent]() {
           // generate a discard message that is 512 bytes long
           llarp::DiscardMessage msg;
-          std::vector<byte_t> msgBuff(512);
+          llarp::ILinkSession::Message_t msgBuff(512);
           llarp_buffer_t buf(msgBuff);
           // add random padding
           llarp::CryptoManager::instance()->randomize(buf);
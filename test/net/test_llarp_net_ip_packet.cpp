@@ -0,0 +1,136 @@
+#include <net/ip_packet.hpp>
+#include <util/codel.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <utility>
+
+using namespace llarp;
+
+namespace
+{
+  /// an ipv4 udp packet from 10.0.0.1 to 10.0.0.2 with sz bytes in all
+  net::IPPacket
+  MakePacket(size_t sz = 64)
+  {
+    std::vector<byte_t> data(sz);
+    data[0] = 0x45;
+    data[2] = sz >> 8;
+    data[3] = sz;
+    data[9] = 17;
+    const byte_t addrs[] = {10, 0, 0, 1, 10, 0, 0, 2};
+    std::copy_n(addrs, sizeof(addrs), data.begin() + 12);
+    net::IPPacket pkt;
+    REQUIRE(pkt.Load(llarp_buffer_t{data}));
+    return pkt;
+  }
+
+  struct PutNoTime
+  {
+    void
+    operator()(net::IPPacket& pkt) const
+    {
+      pkt.timestamp = 1s;
+    }
+  };
+
+  struct GetNoTime
+  {
+    llarp_time_t
+    operator()() const
+    {
+      return 1s;
+    }
+  };
+
+  using Queue_t = util::CoDelQueue<
+      net::IPPacket,
+      net::IPPacket::GetTime,
+      PutNoTime,
+      net::IPPacket::CompareOrder,
+      GetNoTime,
+      util::NullMutex,
+      util::NullLock>;
+}  // namespace
+
+TEST_CASE("ip packets hold up to their capacity", "[net]")
+{
+  net::IPPacket empty;
+  REQUIRE(empty.empty());
+  REQUIRE(empty.Version() == 0);
+  REQUIRE(not empty.IsV4());
+
+  const auto pkt = MakePacket(40);
+  REQUIRE(pkt.size() == 40);
+  REQUIRE(pkt.IsV4());
+  REQUIRE(pkt.dstv4() == huint32_t{0x0a000002});
+
+  std::vector<byte_t> big(net::IPPacket::capacity() + 1);
+  net::IPPacket tooBig;
+  REQUIRE(not tooBig.Load(llarp_buffer_t{big}));
+  big.pop_back();
+  REQUIRE(tooBig.Load(llarp_buffer_t{big}));
+  REQUIRE(tooBig.size() == net::IPPacket::capacity());
+}
+
+TEST_CASE("ip packet copies share bytes until one is written to", "[net]")
+{
+  auto pkt = MakePacket();
+  const auto* bytes = std::as_const(pkt).data();
+
+  auto copy = pkt;
+  REQUIRE(std::as_const(copy).data() == bytes);
+
+  copy.ZeroAddresses();
+  REQUIRE(std::as_const(copy).data() != bytes);
+  REQUIRE(copy.dstv4() == huint32_t{0});
+  REQUIRE(std::as_const(pkt).data() == bytes);
+  REQUIRE(pkt.dstv4() == huint32_t{0x0a000002});
+
+  // nobody shares the bytes any more, so writing does not copy them
+  pkt.ZeroSourceAddress();
+  REQUIRE(std::as_const(pkt).data() == bytes);
+
+  auto moved = std::move(pkt);
+  REQUIRE(std::as_const(moved).data() == bytes);
+  REQUIRE(pkt.empty());
+}
+
+TEST_CASE("icmp unreachable replies fit what they reflect", "[net]")
+{
+  const auto pkt = MakePacket();
+  const auto reply = pkt.MakeICMPUnreachable();
+  REQUIRE(reply.has_value());
+  REQUIRE(reply->size() == 20 + 8 + 20 + 8);
+  REQUIRE(reply->dstv4() == pkt.srcv4());
+
+  REQUIRE(not MakePacket(24).MakeICMPUnreachable().has_value());
+}
+
+TEST_CASE("the codel queue moves packets through without copying them", "[net]")
+{
+  Queue_t queue{"test", PutNoTime{}, GetNoTime{}};
+  const auto& stats = net::IPPacket::Buffer_t::PoolStats();
+  const auto inUse = stats.inUse.load();
+
+  std::vector<const byte_t*> sent;
+  for (size_t idx = 0; idx < 4; ++idx)
+  {
+    auto pkt = MakePacket();
+    sent.emplace_back(std::as_const(pkt).data());
+    queue.Emplace(std::move(pkt));
+  }
+  REQUIRE(queue.Size() == sent.size());
+  REQUIRE(stats.inUse.load() == inUse + sent.size());
+
+  std::vector<net::IPPacket> got;
+  queue.Process([&](net::IPPacket& pkt) { got.emplace_back(std::move(pkt)); });
+  REQUIRE(queue.Size() == 0);
+  REQUIRE(got.size() == sent.size());
+  for (size_t idx = 0; idx < got.size(); ++idx)
+    REQUIRE(std::as_const(got[idx]).data() == sent[idx]);
+
+  // the queue let go of every packet it handed out
+  got.clear();
+  REQUIRE(stats.inUse.load() == inUse);
+}
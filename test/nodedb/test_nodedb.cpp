@@ -1,9 +1,18 @@
 #include <catch2/catch.hpp>
 #include "config/config.hpp"
 
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
 #include <router_contact.hpp>
 #include <nodedb.hpp>
 
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <set>
+#include <thread>
+
 using llarp_nodedb = llarp::NodeDB;
 
 TEST_CASE("FindClosestTo returns correct number of elements", "[nodedb][dht]")
@@ -65,3 +74,335 @@ TEST_CASE("FindClosestTo returns properly ordered set", "[nodedb][dht]")
   REQUIRE(c.pubkey == results[0].pubkey);
   REQUIRE(b.pubkey == results[1].pubkey);
 }
+
+TEST_CASE("NodeDB keeps its index consistent across puts and removes", "[nodedb]")
+{
+  llarp_nodedb nodeDB{fs::current_path(), [](auto) {}};
+
+  constexpr uint64_t numRCs = 16;
+  for (uint64_t i = 0; i < numRCs; ++i)
+  {
+    llarp::RouterContact rc;
+    rc.pubkey[0] = i;
+    nodeDB.Put(rc);
+  }
+  // replacing an rc does not add another entry
+  llarp::RouterContact replaced;
+  replaced.pubkey[0] = 3;
+  replaced.version = 1;
+  nodeDB.Put(replaced);
+  REQUIRE(nodeDB.NumLoaded() == numRCs);
+  REQUIRE(nodeDB.Get(replaced.pubkey)->version == 1);
+
+  // remove every other rc, each removal moves the last entry into the hole
+  for (uint64_t i = 0; i < numRCs; i += 2)
+  {
+    llarp::RouterID pk;
+    pk[0] = i;
+    nodeDB.Remove(pk);
+  }
+  REQUIRE(nodeDB.NumLoaded() == numRCs / 2);
+  for (uint64_t i = 0; i < numRCs; ++i)
+  {
+    llarp::RouterID pk;
+    pk[0] = i;
+    const auto rc = nodeDB.Get(pk);
+    REQUIRE(nodeDB.Has(pk) == (i % 2 == 1));
+    REQUIRE(rc.has_value() == (i % 2 == 1));
+    if (rc)
+      REQUIRE(rc->pubkey == pk);
+  }
+
+  size_t visited = 0;
+  nodeDB.VisitAll([&visited](const auto&) { visited++; });
+  REQUIRE(visited == numRCs / 2);
+}
+
+TEST_CASE("NodeDB puts many rcs at once keeping only the newest", "[nodedb]")
+{
+  llarp_nodedb nodeDB{fs::current_path(), [](auto) {}};
+
+  llarp::RouterContact old;
+  old.pubkey[0] = 1;
+  old.last_updated = 10s;
+  nodeDB.Put(old);
+
+  std::vector<llarp::RouterContact> rcs;
+  for (uint64_t i = 0; i < 8; ++i)
+  {
+    llarp::RouterContact rc;
+    rc.pubkey[0] = i;
+    rc.last_updated = 20s;
+    rcs.push_back(rc);
+  }
+  // a stale copy of one we already have and an older duplicate within the batch
+  rcs[2].last_updated = 5s;
+  nodeDB.Put(rcs[2]);
+  rcs[2].last_updated = 1s;
+  llarp::RouterContact dup;
+  dup.pubkey[0] = 3;
+  dup.last_updated = 15s;
+  rcs.push_back(dup);
+
+  nodeDB.PutManyIfNewer(rcs);
+  REQUIRE(nodeDB.NumLoaded() == 8);
+  REQUIRE(nodeDB.Get(old.pubkey)->last_updated == 20s);
+  REQUIRE(nodeDB.Get(rcs[2].pubkey)->last_updated == 5s);
+  REQUIRE(nodeDB.Get(dup.pubkey)->last_updated == 20s);
+}
+
+TEST_CASE("NodeDB GetRandom only returns rcs passing the filter", "[nodedb]")
+{
+  llarp_nodedb nodeDB{fs::current_path(), nullptr};
+
+  REQUIRE(not nodeDB.GetRandom([](const auto&) { return true; }));
+
+  constexpr uint64_t numRCs = 64;
+  for (uint64_t i = 0; i < numRCs; ++i)
+  {
+    llarp::RouterContact rc;
+    rc.pubkey[0] = i;
+    nodeDB.Put(rc);
+  }
+
+  std::set<uint8_t> seen;
+  for (int n = 0; n < 1000; ++n)
+  {
+    const auto rc = nodeDB.GetRandom([](const auto& rc) { return rc.pubkey[0] % 4 == 0; });
+    REQUIRE(rc);
+    REQUIRE(rc->pubkey[0] % 4 == 0);
+    seen.insert(rc->pubkey[0]);
+  }
+  // every matching rc should have come up at least once
+  REQUIRE(seen.size() == numRCs / 4);
+
+  // a filter nothing passes still terminates
+  REQUIRE(not nodeDB.GetRandom([](const auto&) { return false; }));
+}
+
+TEST_CASE("NodeDB readers on other threads see consistent snapshots", "[nodedb]")
+{
+  llarp_nodedb nodeDB{fs::current_path(), [](auto) {}};
+
+  constexpr uint64_t numRCs = 200;
+  std::atomic<bool> done{false};
+  std::atomic<bool> consistent{true};
+
+  std::vector<std::thread> readers;
+  for (int n = 0; n < 4; ++n)
+  {
+    readers.emplace_back([&]() {
+      while (not done)
+      {
+        // whatever snapshot we land on it only ever holds keys we wrote
+        const auto pick = nodeDB.GetRandom([](const auto&) { return true; });
+        if (pick and pick->pubkey[0] >= numRCs)
+          consistent = false;
+        if (nodeDB.NumLoaded() > numRCs)
+          consistent = false;
+      }
+    });
+  }
+
+  for (int round = 0; round < 10; ++round)
+  {
+    for (uint64_t i = 0; i < numRCs; ++i)
+    {
+      llarp::RouterContact rc;
+      rc.pubkey[0] = i;
+      nodeDB.Put(rc);
+    }
+    nodeDB.RemoveIf([round](const auto& rc) { return rc.pubkey[0] % 10 == round; });
+  }
+  done = true;
+  for (auto& reader : readers)
+    reader.join();
+
+  REQUIRE(consistent);
+  REQUIRE(nodeDB.NumLoaded() == numRCs - numRCs / 10);
+}
+
+/// a fresh nodedb directory under the system temp dir
+static fs::path
+MakeNodeDBDir()
+{
+  std::random_device rd;
+  auto dir = fs::temp_directory_path() / ("lokinet-nodedb-test-" + std::to_string(rd()));
+  fs::create_directories(dir);
+  return dir;
+}
+
+static std::vector<llarp::RouterContact>
+MakeSignedRCs(size_t num)
+{
+  std::vector<llarp::RouterContact> rcs(num);
+  for (auto& rc : rcs)
+  {
+    llarp::SecretKey identity;
+    llarp::CryptoManager::instance()->identity_keygen(identity);
+    rc.pubkey = identity.toPublic();
+    REQUIRE(rc.Sign(identity));
+  }
+  return rcs;
+}
+
+/// write each rc to its own file in the skiplist directories the way older versions stored them,
+/// returns the files written
+static std::vector<fs::path>
+WriteRCDirectory(const fs::path& dir, const std::vector<llarp::RouterContact>& rcs)
+{
+  static constexpr char hex[] = "0123456789abcdef";
+  std::vector<fs::path> files;
+  for (const auto& rc : rcs)
+  {
+    const auto sub = dir / std::string(1, hex[rc.pubkey[0] >> 4]);
+    fs::create_directories(sub);
+    files.push_back(sub / (llarp::RouterID{rc.pubkey}.ToString() + ".signed"));
+    REQUIRE(rc.Write(files.back()));
+  }
+  return files;
+}
+
+TEST_CASE("NodeDB snapshot file keeps rcs across restarts", "[nodedb]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager{&crypto};
+  const auto dir = MakeNodeDBDir();
+  const auto runNow = [](auto call) { call(); };
+  const auto rcs = MakeSignedRCs(20);
+
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    for (const auto& rc : rcs)
+      nodeDB.Put(rc);
+    nodeDB.SaveToDisk();
+  }
+  REQUIRE(fs::exists(dir / "nodedb.snapshot"));
+
+  const auto extra = MakeSignedRCs(1).front();
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    nodeDB.LoadFromDisk();
+    REQUIRE(nodeDB.NumLoaded() == rcs.size());
+    for (const auto& rc : rcs)
+      REQUIRE(nodeDB.Get(rc.pubkey) == rc);
+
+    // the periodic flush only appends what changed
+    for (size_t idx = 0; idx < 5; ++idx)
+      nodeDB.Remove(rcs[idx].pubkey);
+    nodeDB.Put(extra);
+    nodeDB.Tick(llarp::time_now_ms() + 10min);
+  }
+
+  const auto checkAfterFlush = [&](llarp_nodedb& nodeDB) {
+    REQUIRE(nodeDB.NumLoaded() == rcs.size() - 5 + 1);
+    for (size_t idx = 0; idx < rcs.size(); ++idx)
+      REQUIRE(nodeDB.Has(rcs[idx].pubkey) == (idx >= 5));
+    REQUIRE(nodeDB.Get(extra.pubkey) == extra);
+  };
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    nodeDB.LoadFromDisk();
+    checkAfterFlush(nodeDB);
+  }
+
+  // a record cut short by a crash does not lose what came before it
+  {
+    std::ofstream f{dir / "nodedb.snapshot", std::ios::binary | std::ios::app};
+    const char partial[] = {10, 0, 0, 0, 1, 2, 3};
+    f.write(partial, sizeof(partial));
+  }
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    nodeDB.LoadFromDisk();
+    checkAfterFlush(nodeDB);
+  }
+
+  // without a snapshot the directory layout is imported, a snapshot written and the files it
+  // replaces removed
+  fs::remove(dir / "nodedb.snapshot");
+  std::vector<llarp::RouterContact> kept{rcs.begin() + 5, rcs.end()};
+  kept.push_back(extra);
+  const auto files = WriteRCDirectory(dir, kept);
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    nodeDB.LoadFromDisk();
+    checkAfterFlush(nodeDB);
+  }
+  REQUIRE(fs::exists(dir / "nodedb.snapshot"));
+  for (const auto& file : files)
+    REQUIRE(not fs::exists(file));
+  {
+    llarp_nodedb nodeDB{dir, runNow};
+    nodeDB.LoadFromDisk();
+    checkAfterFlush(nodeDB);
+  }
+
+  fs::remove_all(dir);
+}
+
+TEST_CASE("NodeDB flush queued before a save does not undo it", "[nodedb]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager{&crypto};
+  const auto dir = MakeNodeDBDir();
+  std::vector<std::function<void()>> diskJobs;
+  const auto rcs = MakeSignedRCs(2);
+
+  {
+    llarp_nodedb nodeDB{dir, [&](auto call) { diskJobs.emplace_back(std::move(call)); }};
+    for (const auto& rc : rcs)
+      nodeDB.Put(rc);
+    nodeDB.Tick(llarp::time_now_ms() + 10min);
+    REQUIRE(diskJobs.size() == 1);
+
+    // the save lands on disk before the flush queued ahead of it gets to run
+    nodeDB.Remove(rcs[0].pubkey);
+    nodeDB.SaveToDisk();
+    for (auto& job : diskJobs)
+      job();
+  }
+
+  {
+    llarp_nodedb nodeDB{dir, [](auto call) { call(); }};
+    nodeDB.LoadFromDisk();
+    REQUIRE(nodeDB.NumLoaded() == 1);
+    REQUIRE(not nodeDB.Has(rcs[0].pubkey));
+    REQUIRE(nodeDB.Get(rcs[1].pubkey) == rcs[1]);
+  }
+
+  fs::remove_all(dir);
+}
+
+TEST_CASE("NodeDB hands snapshot decoding to the work function", "[nodedb]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager{&crypto};
+  const auto dir = MakeNodeDBDir();
+  const auto rcs = MakeSignedRCs(300);
+
+  {
+    llarp_nodedb nodeDB{dir, [](auto call) { call(); }};
+    for (const auto& rc : rcs)
+      nodeDB.Put(rc);
+    nodeDB.SaveToDisk();
+  }
+
+  // the jobs run on threads of their own while the load waits for them
+  std::vector<std::thread> workers;
+  {
+    llarp_nodedb nodeDB{
+        dir,
+        [](auto call) { call(); },
+        [&](auto call) { workers.emplace_back(std::move(call)); }};
+    nodeDB.LoadFromDisk();
+    REQUIRE(not workers.empty());
+    REQUIRE(nodeDB.NumLoaded() == rcs.size());
+    for (const auto& rc : rcs)
+      REQUIRE(nodeDB.Get(rc.pubkey) == rc);
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  fs::remove_all(dir);
+}
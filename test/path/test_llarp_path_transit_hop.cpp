@@ -0,0 +1,147 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <messages/relay.hpp>
+#include <path/transit_hop.hpp>
+#include <router/stub_router.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  /// a relay message as it reached SendToOrQueue
+  struct Relayed
+  {
+    RouterID remote;
+    std::thread::id thread;
+    TunnelNonce Y;
+  };
+
+  struct TransitHopContext
+  {
+    sodium::CryptoLibSodium crypto;
+    CryptoManager manager{&crypto};
+    test::StubRouter router;
+    std::shared_ptr<path::TransitHop> hop = std::make_shared<path::TransitHop>();
+    std::vector<Relayed> relayed;
+
+    TransitHopContext()
+    {
+      router.us.Randomize();
+      hop->info.upstream.Randomize();
+      hop->info.downstream.Randomize();
+      hop->info.txID.Randomize();
+      hop->info.rxID.Randomize();
+      hop->pathKey.Randomize();
+      hop->nonceXOR.Randomize();
+      router.onSend = [this](const RouterID& remote, const ILinkMessage& msg) {
+        TunnelNonce Y;
+        if (const auto* down = dynamic_cast<const RelayDownstreamMessage*>(&msg))
+          Y = down->Y;
+        else if (const auto* up = dynamic_cast<const RelayUpstreamMessage*>(&msg))
+          Y = up->Y;
+        else
+          return false;
+        relayed.push_back({remote, std::this_thread::get_id(), Y});
+        return true;
+      };
+    }
+
+    /// hand num messages to the hop in one direction, returns the nonces they will go out with
+    std::vector<TunnelNonce>
+    Receive(bool upstream, size_t num)
+    {
+      std::vector<TunnelNonce> expected;
+      std::vector<byte_t> payload(128);
+      for (size_t idx = 0; idx < num; ++idx)
+      {
+        TunnelNonce Y;
+        Y.Randomize();
+        const llarp_buffer_t buf{payload};
+        if (upstream)
+          REQUIRE(hop->HandleUpstream(buf, Y, &router));
+        else
+          REQUIRE(hop->HandleDownstream(buf, Y, &router));
+        expected.emplace_back(Y ^ hop->nonceXOR);
+      }
+      if (upstream)
+        hop->FlushUpstream(&router);
+      else
+        hop->FlushDownstream(&router);
+      return expected;
+    }
+
+    /// run everything queued for the transit shards on a thread of its own
+    void
+    RunShard()
+    {
+      std::thread shard{[jobs = router.TakeTransitJobs()]() {
+        for (const auto& job : jobs)
+          job();
+      }};
+      shard.join();
+    }
+
+    /// run everything queued for the logic thread on this one
+    void
+    RunLogic()
+    {
+      for (const auto& job : router.TakeLogicJobs())
+        job();
+    }
+  };
+}  // namespace
+
+TEST_CASE("transit shards leave forwarding to the logic thread", "[path][transit]")
+{
+  const bool upstream = GENERATE(false, true);
+  TransitHopContext ctx;
+  const auto& nextHop = upstream ? ctx.hop->info.upstream : ctx.hop->info.downstream;
+  // a session to the next hop already exists, the case that used to be sent from the shard
+  ctx.router.links.sessions[ctx.hop->info.upstream] = 0;
+  ctx.router.links.sessions[ctx.hop->info.downstream] = 0;
+
+  const auto expected = ctx.Receive(upstream, 32);
+  ctx.RunShard();
+  // the shard did the crypto but left the link layer alone
+  REQUIRE(ctx.relayed.empty());
+  REQUIRE(ctx.router.links.Callers().empty());
+
+  ctx.RunLogic();
+  REQUIRE(ctx.relayed.size() == expected.size());
+  for (size_t idx = 0; idx < expected.size(); ++idx)
+  {
+    REQUIRE(ctx.relayed[idx].remote == nextHop);
+    REQUIRE(ctx.relayed[idx].thread == std::this_thread::get_id());
+    REQUIRE(ctx.relayed[idx].Y == expected[idx]);
+  }
+  for (const auto& caller : ctx.router.links.Callers())
+    REQUIRE(caller == std::this_thread::get_id());
+}
+
+TEST_CASE("relayed traffic keeps its order when the next hop session shows up", "[path][transit]")
+{
+  const bool upstream = GENERATE(false, true);
+  TransitHopContext ctx;
+
+  // the first batch is queued while there is no session yet, the second once there is one, and
+  // the logic thread only gets to either after both went through the shard
+  auto expected = ctx.Receive(upstream, 16);
+  ctx.RunShard();
+  ctx.router.links.sessions[ctx.hop->info.upstream] = 0;
+  ctx.router.links.sessions[ctx.hop->info.downstream] = 0;
+  const auto second = ctx.Receive(upstream, 16);
+  expected.insert(expected.end(), second.begin(), second.end());
+  ctx.RunShard();
+  REQUIRE(ctx.relayed.empty());
+
+  ctx.RunLogic();
+  REQUIRE(ctx.relayed.size() == expected.size());
+  for (size_t idx = 0; idx < expected.size(); ++idx)
+    REQUIRE(ctx.relayed[idx].Y == expected[idx]);
+}
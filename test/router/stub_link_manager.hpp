@@ -0,0 +1,191 @@
+#ifndef TEST_LLARP_ROUTER_STUB_LINK_MANAGER
+#define TEST_LLARP_ROUTER_STUB_LINK_MANAGER
+
+#include <link/i_link_manager.hpp>
+#include <router_contact.hpp>
+#include <router_id.hpp>
+
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace test
+  {
+    /// link manager with made up sessions that keeps everything it is asked to send
+    struct StubLinkManager final : public ILinkManager
+    {
+      /// routers we have a session with and how many messages wait in each
+      std::unordered_map<RouterID, size_t> sessions;
+      /// routers whose session is with a client
+      std::unordered_set<RouterID> clients;
+      /// every message handed to SendTo, in order
+      std::vector<std::pair<RouterID, ILinkSession::Message_t>> sent;
+      size_t pumps = 0;
+
+      /// threads that looked at or used a session, the link layers are only safe to touch from
+      /// the logic thread
+      std::vector<std::thread::id>
+      Callers() const
+      {
+        std::lock_guard<std::mutex> lock{m_CallersMutex};
+        return m_Callers;
+      }
+
+      LinkLayer_ptr
+      GetCompatibleLink(const RouterContact&) const override
+      {
+        return nullptr;
+      }
+
+      IOutboundSessionMaker*
+      GetSessionMaker() const override
+      {
+        throw std::logic_error{"StubLinkManager has no session maker"};
+      }
+
+      bool
+      SendTo(
+          const RouterID& remote,
+          ILinkSession::Message_t msg,
+          ILinkSession::CompletionHandler) override
+      {
+        Called();
+        if (sessions.count(remote) == 0)
+          return false;
+        sent.emplace_back(remote, std::move(msg));
+        return true;
+      }
+
+      bool
+      HasSessionTo(const RouterID& remote) const override
+      {
+        Called();
+        return sessions.count(remote) > 0;
+      }
+
+      std::optional<size_t>
+      SendQueueBacklog(const RouterID& remote) const override
+      {
+        Called();
+        const auto itr = sessions.find(remote);
+        if (itr == sessions.end())
+          return std::nullopt;
+        return itr->second;
+      }
+
+      std::optional<bool>
+      SessionIsClient(RouterID remote) const override
+      {
+        Called();
+        if (sessions.count(remote) == 0)
+          return std::nullopt;
+        return clients.count(remote) > 0;
+      }
+
+      void
+      PumpLinks() override
+      {
+        Called();
+        pumps++;
+      }
+
+      void
+      AddLink(LinkLayer_ptr, bool) override
+      {}
+
+      bool
+      StartLinks(Logic_ptr) override
+      {
+        return true;
+      }
+
+      void
+      Stop() override
+      {}
+
+      void
+      PersistSessionUntil(const RouterID&, llarp_time_t) override
+      {}
+
+      void
+      ForEachPeer(std::function<void(const ILinkSession*, bool)>, bool) const override
+      {}
+
+      void
+      ForEachPeer(std::function<void(ILinkSession*)>) override
+      {}
+
+      void
+      ForEachInboundLink(std::function<void(LinkLayer_ptr)>) const override
+      {}
+
+      void
+      ForEachOutboundLink(std::function<void(LinkLayer_ptr)>) const override
+      {}
+
+      void
+      DeregisterPeer(RouterID remote) override
+      {
+        sessions.erase(remote);
+        clients.erase(remote);
+      }
+
+      size_t
+      NumberOfConnectedRouters() const override
+      {
+        return sessions.size() - clients.size();
+      }
+
+      size_t
+      NumberOfConnectedClients() const override
+      {
+        return clients.size();
+      }
+
+      size_t
+      NumberOfPendingConnections() const override
+      {
+        return 0;
+      }
+
+      bool
+      GetRandomConnectedRouter(RouterContact&) const override
+      {
+        return false;
+      }
+
+      void
+      CheckPersistingSessions(llarp_time_t) override
+      {}
+
+      void
+      updatePeerDb(std::shared_ptr<PeerDb>) override
+      {}
+
+      util::StatusObject
+      ExtractStatus() const override
+      {
+        return {};
+      }
+
+     private:
+      void
+      Called() const
+      {
+        std::lock_guard<std::mutex> lock{m_CallersMutex};
+        m_Callers.push_back(std::this_thread::get_id());
+      }
+
+      mutable std::mutex m_CallersMutex;
+      mutable std::vector<std::thread::id> m_Callers;
+    };
+  }  // namespace test
+}  // namespace llarp
+
+#endif
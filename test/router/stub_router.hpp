@@ -0,0 +1,456 @@
+#ifndef TEST_LLARP_ROUTER_STUB_ROUTER
+#define TEST_LLARP_ROUTER_STUB_ROUTER
+
+#include <router/abstractrouter.hpp>
+#include <router/stub_link_manager.hpp>
+#include <util/thread/logic.hpp>
+#include <util/time.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llarp
+{
+  namespace test
+  {
+    /// router that holds on to the jobs it is given so a test decides which thread runs them
+    /// and when, anything a test does not need throws
+    struct StubRouter final : public AbstractRouter
+    {
+      using Job_t = std::function<void(void)>;
+
+      RouterID us;
+      StubLinkManager links;
+      /// called from SendToOrQueue on whatever thread called it
+      std::function<bool(const RouterID&, const ILinkMessage&)> onSend;
+
+      StubRouter() : m_Logic{std::make_shared<Logic>()}
+      {
+        m_Logic->SetQueuer([this](Job_t job) { Push(m_LogicJobs, std::move(job)); });
+      }
+
+      /// take the jobs queued for the logic thread so far
+      std::vector<Job_t>
+      TakeLogicJobs()
+      {
+        return Take(m_LogicJobs);
+      }
+
+      /// take the jobs queued for the transit shards so far
+      std::vector<Job_t>
+      TakeTransitJobs()
+      {
+        return Take(m_TransitJobs);
+      }
+
+      std::shared_ptr<Logic>
+      logic() const override
+      {
+        return m_Logic;
+      }
+
+      void
+      QueueWork(Job_t job) override
+      {
+        Push(m_TransitJobs, std::move(job));
+      }
+
+      void
+      QueueCryptoWork(thread::WorkLane, uint64_t, Job_t job) override
+      {
+        Push(m_TransitJobs, std::move(job));
+      }
+
+      void
+      QueueDiskIO(Job_t job) override
+      {
+        job();
+      }
+
+      void
+      QueueTransitWork(const PathID_t&, Job_t job) override
+      {
+        Push(m_TransitJobs, std::move(job));
+      }
+
+      ILinkManager&
+      linkManager() override
+      {
+        return links;
+      }
+
+      const byte_t*
+      pubkey() const override
+      {
+        return us.data();
+      }
+
+      llarp_time_t
+      Now() const override
+      {
+        return time_now_ms();
+      }
+
+      bool
+      SendToOrQueue(const RouterID& remote, const ILinkMessage* msg, SendStatusHandler) override
+      {
+        return onSend and onSend(remote, *msg);
+      }
+
+      void
+      PumpLL() override
+      {
+        links.PumpLinks();
+      }
+
+      bool
+      HandleRecvLinkMessageBuffer(ILinkSession*, const llarp_buffer_t&) override
+      {
+        return false;
+      }
+
+      LMQ_ptr
+      lmq() const override
+      {
+        return nullptr;
+      }
+
+      vpn::Platform*
+      GetVPNPlatform() const override
+      {
+        return nullptr;
+      }
+
+      std::shared_ptr<rpc::LokidRpcClient>
+      RpcClient() const override
+      {
+        return nullptr;
+      }
+
+      llarp_dht_context*
+      dht() const override
+      {
+        return nullptr;
+      }
+
+      std::shared_ptr<NodeDB>
+      nodedb() const override
+      {
+        return nullptr;
+      }
+
+      const path::PathContext&
+      pathContext() const override
+      {
+        NotStubbed("pathContext");
+      }
+
+      path::PathContext&
+      pathContext() override
+      {
+        NotStubbed("pathContext");
+      }
+
+      const RouterContact&
+      rc() const override
+      {
+        NotStubbed("rc");
+      }
+
+      exit::Context&
+      exitContext() override
+      {
+        NotStubbed("exitContext");
+      }
+
+      std::shared_ptr<KeyManager>
+      keyManager() const override
+      {
+        return nullptr;
+      }
+
+      const SecretKey&
+      identity() const override
+      {
+        NotStubbed("identity");
+      }
+
+      const SecretKey&
+      encryption() const override
+      {
+        NotStubbed("encryption");
+      }
+
+      Profiling&
+      routerProfiling() override
+      {
+        NotStubbed("routerProfiling");
+      }
+
+      llarp_ev_loop_ptr
+      netloop() const override
+      {
+        return nullptr;
+      }
+
+      service::Context&
+      hiddenServiceContext() override
+      {
+        NotStubbed("hiddenServiceContext");
+      }
+
+      const service::Context&
+      hiddenServiceContext() const override
+      {
+        NotStubbed("hiddenServiceContext");
+      }
+
+      IOutboundMessageHandler&
+      outboundMessageHandler() override
+      {
+        NotStubbed("outboundMessageHandler");
+      }
+
+      IOutboundSessionMaker&
+      outboundSessionMaker() override
+      {
+        NotStubbed("outboundSessionMaker");
+      }
+
+      RoutePoker&
+      routePoker() override
+      {
+        NotStubbed("routePoker");
+      }
+
+      I_RCLookupHandler&
+      rcLookupHandler() override
+      {
+        NotStubbed("rcLookupHandler");
+      }
+
+      SignatureVerifier&
+      signatureVerifier() override
+      {
+        NotStubbed("signatureVerifier");
+      }
+
+      std::shared_ptr<PeerDb>
+      peerDb() override
+      {
+        return nullptr;
+      }
+
+      bool
+      Sign(Signature&, const llarp_buffer_t&) const override
+      {
+        return false;
+      }
+
+      bool
+      Configure(std::shared_ptr<Config>, bool, std::shared_ptr<NodeDB>) override
+      {
+        return false;
+      }
+
+      bool
+      IsServiceNode() const override
+      {
+        return true;
+      }
+
+      bool
+      StartRpcServer() override
+      {
+        return false;
+      }
+
+      bool
+      Run() override
+      {
+        return false;
+      }
+
+      bool
+      IsRunning() const override
+      {
+        return true;
+      }
+
+      bool
+      LooksAlive() const override
+      {
+        return true;
+      }
+
+      void
+      Stop() override
+      {}
+
+      void
+      Thaw() override
+      {}
+
+      void
+      Die() override
+      {}
+
+      bool
+      IsBootstrapNode(RouterID) const override
+      {
+        return false;
+      }
+
+      void
+      ConnectToRandomRouters(int) override
+      {}
+
+      bool
+      TryConnectAsync(RouterContact, uint16_t) override
+      {
+        return false;
+      }
+
+      void
+      SessionClosed(RouterID) override
+      {}
+
+      llarp_time_t
+      Uptime() const override
+      {
+        return 0s;
+      }
+
+      bool
+      GetRandomGoodRouter(RouterID&) override
+      {
+        return false;
+      }
+
+      void
+      PersistSessionUntil(const RouterID&, llarp_time_t) override
+      {}
+
+      bool
+      ParseRoutingMessageBuffer(
+          const llarp_buffer_t&, routing::IMessageHandler*, const PathID_t&) override
+      {
+        return false;
+      }
+
+      size_t
+      NumberOfConnectedRouters() const override
+      {
+        return links.NumberOfConnectedRouters();
+      }
+
+      size_t
+      NumberOfConnectedClients() const override
+      {
+        return links.NumberOfConnectedClients();
+      }
+
+      bool
+      GetRandomConnectedRouter(RouterContact&) const override
+      {
+        return false;
+      }
+
+      void
+      HandleDHTLookupForExplore(RouterID, const std::vector<RouterContact>&) override
+      {}
+
+      void
+      LookupRouter(RouterID, RouterLookupHandler) override
+      {}
+
+      bool
+      CheckRenegotiateValid(RouterContact, RouterContact) override
+      {
+        return false;
+      }
+
+      void
+      SetRouterWhitelist(const std::vector<RouterID>) override
+      {}
+
+      void
+      ForEachPeer(std::function<void(const ILinkSession*, bool)>, bool) const override
+      {}
+
+      bool
+      ConnectionToRouterAllowed(const RouterID&) const override
+      {
+        return true;
+      }
+
+      bool
+      HasSessionTo(const RouterID& router) const override
+      {
+        return links.HasSessionTo(router);
+      }
+
+      uint32_t
+      NextPathBuildNumber() override
+      {
+        return 0;
+      }
+
+      std::string
+      ShortName() const override
+      {
+        return "stub";
+      }
+
+      util::StatusObject
+      ExtractStatus() const override
+      {
+        return {};
+      }
+
+      void
+      GossipRCIfNeeded(const RouterContact) override
+      {}
+
+     protected:
+      void
+      HandleRouterEvent(tooling::RouterEventPtr) const override
+      {}
+
+     private:
+      [[noreturn]] static void
+      NotStubbed(const char* name)
+      {
+        throw std::logic_error{std::string{"StubRouter::"} + name + " is not stubbed"};
+      }
+
+      void
+      Push(std::vector<Job_t>& jobs, Job_t job)
+      {
+        std::lock_guard<std::mutex> lock{m_JobsMutex};
+        jobs.emplace_back(std::move(job));
+      }
+
+      std::vector<Job_t>
+      Take(std::vector<Job_t>& jobs)
+      {
+        std::vector<Job_t> taken;
+        std::lock_guard<std::mutex> lock{m_JobsMutex};
+        taken.swap(jobs);
+        return taken;
+      }
+
+      std::shared_ptr<Logic> m_Logic;
+      std::mutex m_JobsMutex;
+      std::vector<Job_t> m_LogicJobs;
+      std::vector<Job_t> m_TransitJobs;
+    };
+  }  // namespace test
+}  // namespace llarp
+
+#endif
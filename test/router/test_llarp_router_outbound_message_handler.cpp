@@ -0,0 +1,296 @@
+#include <router/outbound_message_handler.hpp>
+
+#include <messages/link_message.hpp>
+#include <router/i_rc_lookup_handler.hpp>
+#include <router/stub_link_manager.hpp>
+#include <util/thread/logic.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  /// a message that encodes to exactly size bytes starting with its path id
+  struct SizedMessage final : public ILinkMessage
+  {
+    size_t size;
+
+    SizedMessage(const PathID_t& path, size_t sz) : size{sz}
+    {
+      pathid = path;
+    }
+
+    bool
+    DecodeKey(const llarp_buffer_t&, llarp_buffer_t*) override
+    {
+      return false;
+    }
+
+    bool
+    BEncode(llarp_buffer_t* buf) const override
+    {
+      if (buf->size_left() < size)
+        return false;
+      std::memset(buf->cur, 'x', size);
+      std::copy_n(pathid.begin(), pathid.size(), buf->cur);
+      buf->cur += size;
+      return true;
+    }
+
+    bool
+    HandleMessage(AbstractRouter*) const override
+    {
+      return false;
+    }
+
+    void
+    Clear() override
+    {}
+
+    const char*
+    Name() const override
+    {
+      return "Sized";
+    }
+
+    uint16_t
+    Priority() const override
+    {
+      return 0;
+    }
+  };
+
+  /// every router is allowed
+  struct StubRCLookupHandler final : public I_RCLookupHandler
+  {
+    void
+    AddValidRouter(const RouterID&) override
+    {}
+
+    void
+    RemoveValidRouter(const RouterID&) override
+    {}
+
+    void
+    SetRouterWhitelist(const std::vector<RouterID>&) override
+    {}
+
+    void
+    GetRC(const RouterID&, RCRequestCallback, bool) override
+    {}
+
+    bool
+    RemoteIsAllowed(const RouterID&) const override
+    {
+      return true;
+    }
+
+    bool
+    CheckRC(const RouterContact&) const override
+    {
+      return true;
+    }
+
+    void
+    CheckRCs(std::vector<RouterContact>, std::function<void(std::vector<RouterContact>)>)
+        const override
+    {}
+
+    bool
+    GetRandomWhitelistRouter(RouterID&) const override
+    {
+      return false;
+    }
+
+    bool
+    CheckRenegotiateValid(RouterContact, RouterContact) override
+    {
+      return false;
+    }
+
+    void
+    PeriodicUpdate(llarp_time_t) override
+    {}
+
+    void
+    ExploreNetwork() override
+    {}
+
+    size_t
+    NumberOfStrictConnectRouters() const override
+    {
+      return 0;
+    }
+  };
+
+  struct HandlerContext
+  {
+    test::StubLinkManager links;
+    StubRCLookupHandler lookup;
+    std::shared_ptr<Logic> logic = std::make_shared<Logic>();
+    std::vector<std::function<void(void)>> logicJobs;
+    OutboundMessageHandler handler;
+    std::vector<SendStatus> statuses;
+
+    explicit HandlerContext(size_t maxQueueSize = MAX_OUTBOUND_QUEUE_SIZE) : handler{maxQueueSize}
+    {
+      logic->SetQueuer([this](auto job) { logicJobs.emplace_back(std::move(job)); });
+      handler.Init(&links, &lookup, logic);
+    }
+
+    /// a router we have a session with whose link can take room more messages
+    RouterID
+    MakeRouter(size_t room = MAX_SESSION_BACKLOG)
+    {
+      RouterID router;
+      router.Randomize();
+      links.sessions[router] = MAX_SESSION_BACKLOG - room;
+      return router;
+    }
+
+    void
+    Queue(const RouterID& remote, const PathID_t& path, size_t size, size_t num)
+    {
+      for (size_t idx = 0; idx < num; ++idx)
+      {
+        const SizedMessage msg{path, size};
+        REQUIRE(handler.QueueMessage(
+            remote, &msg, [this](SendStatus status) { statuses.push_back(status); }));
+      }
+    }
+
+    /// bytes handed to the link layer per path since the last call
+    std::map<PathID_t, size_t>
+    TakeSentBytes()
+    {
+      std::map<PathID_t, size_t> bytes;
+      for (const auto& [router, msg] : links.sent)
+      {
+        PathID_t path;
+        std::copy_n(msg.data(), path.size(), path.begin());
+        bytes[path] += msg.size();
+      }
+      links.sent.clear();
+      return bytes;
+    }
+
+    void
+    RunLogic()
+    {
+      std::vector<std::function<void(void)>> jobs;
+      jobs.swap(logicJobs);
+      for (const auto& job : jobs)
+        job();
+    }
+  };
+
+  PathID_t
+  MakePath()
+  {
+    PathID_t path;
+    path.Randomize();
+    return path;
+  }
+}  // namespace
+
+TEST_CASE("outbound paths share a tick by bytes, not by messages", "[router][outbound]")
+{
+  HandlerContext ctx;
+  // the session holds back the tick long before either path runs dry
+  const auto router = ctx.MakeRouter(40);
+  const auto small = MakePath();
+  const auto large = MakePath();
+  ctx.Queue(router, small, 256, MAX_PATH_QUEUE_SIZE);
+  ctx.Queue(router, large, 4096, MAX_PATH_QUEUE_SIZE);
+
+  ctx.handler.Tick();
+  auto sent = ctx.TakeSentBytes();
+  REQUIRE(ctx.links.sent.empty());
+  REQUIRE(sent[small] > 0);
+  REQUIRE(sent[large] > 0);
+  // a path is at most one quantum and one message ahead of the other
+  const auto ahead = std::max(sent[small], sent[large]) - std::min(sent[small], sent[large]);
+  REQUIRE(ahead <= OUTBOUND_PATH_QUANTUM + 4096);
+
+  // next tick the session has room again and the paths take turns where they left off
+  ctx.handler.Tick();
+  const auto more = ctx.TakeSentBytes();
+  sent[small] += more.at(small);
+  sent[large] += more.at(large);
+  const auto stillAhead = std::max(sent[small], sent[large]) - std::min(sent[small], sent[large]);
+  REQUIRE(stillAhead <= OUTBOUND_PATH_QUANTUM + 4096);
+  ctx.RunLogic();
+  REQUIRE(ctx.statuses.empty());
+}
+
+TEST_CASE("outbound control traffic gets its share while paths are busy", "[router][outbound]")
+{
+  HandlerContext ctx;
+  const PathID_t control{};
+  const size_t numControl = GENERATE(size_t{50}, size_t{200});
+  const auto controlRouter = ctx.MakeRouter();
+  const auto pathRouter = ctx.MakeRouter();
+  ctx.Queue(controlRouter, control, 1024, numControl);
+  // more than the paths can send in one tick
+  ctx.Queue(pathRouter, MakePath(), 4096, MAX_PATH_QUEUE_SIZE);
+  ctx.Queue(pathRouter, MakePath(), 4096, MAX_PATH_QUEUE_SIZE);
+
+  ctx.handler.Tick();
+  auto sent = ctx.TakeSentBytes();
+  const auto share = MAX_OUTBOUND_BYTES_PER_TICK / OUTBOUND_CONTROL_SHARE;
+  const auto controlSent = sent[control];
+  sent.erase(control);
+  size_t pathSent = 0;
+  for (const auto& [path, bytes] : sent)
+    pathSent += bytes;
+  REQUIRE(controlSent == std::min(numControl * 1024, share));
+  // the paths get the rest of the tick, whatever control did not take of its share included
+  REQUIRE(pathSent + 4096 > MAX_OUTBOUND_BYTES_PER_TICK - controlSent);
+  REQUIRE(pathSent + controlSent <= MAX_OUTBOUND_BYTES_PER_TICK);
+}
+
+TEST_CASE("outbound control traffic goes out at once when paths are idle", "[router][outbound]")
+{
+  HandlerContext ctx;
+  const PathID_t control{};
+  const auto router = ctx.MakeRouter();
+  ctx.Queue(router, control, 1024, 400);
+
+  ctx.handler.Tick();
+  REQUIRE(ctx.TakeSentBytes().at(control) == 400 * 1024);
+}
+
+TEST_CASE("outbound control queue drops past its cap with congestion", "[router][outbound]")
+{
+  constexpr size_t extra = 5;
+  HandlerContext ctx{MAX_CONTROL_QUEUE_SIZE + extra};
+  const PathID_t control{};
+  const auto router = ctx.MakeRouter();
+  ctx.Queue(router, control, 64, MAX_CONTROL_QUEUE_SIZE + extra);
+
+  ctx.handler.Tick();
+  ctx.RunLogic();
+  REQUIRE(ctx.statuses.size() == extra);
+  for (const auto status : ctx.statuses)
+    REQUIRE(status == SendStatus::Congestion);
+  // nothing that made it into the queue is lost
+  size_t sent = ctx.links.sent.size();
+  while (sent < MAX_CONTROL_QUEUE_SIZE)
+  {
+    ctx.links.sent.clear();
+    ctx.handler.Tick();
+    REQUIRE(not ctx.links.sent.empty());
+    sent += ctx.links.sent.size();
+  }
+  REQUIRE(sent == MAX_CONTROL_QUEUE_SIZE);
+  ctx.RunLogic();
+  REQUIRE(ctx.statuses.size() == extra);
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <router/signature_verifier.hpp>
+#include <router_contact.hpp>
+#include <util/thread/logic.hpp>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager cmanager(&crypto);
+
+  llarp::RouterContact
+  MakeRC()
+  {
+    llarp::RouterContact rc;
+    llarp::SecretKey sign;
+    cmanager.instance()->identity_keygen(sign);
+    llarp::SecretKey encr;
+    cmanager.instance()->encryption_keygen(encr);
+    rc.enckey = encr.toPublic();
+    rc.pubkey = sign.toPublic();
+    REQUIRE(rc.Sign(sign));
+    return rc;
+  }
+}  // namespace
+
+TEST_CASE("SignatureVerifier checks a batch on the workers", "[RC][signature][verify]")
+{
+  // stand in for the logic thread: completions are queued and run by the test afterwards
+  std::mutex logicMutex;
+  std::vector<std::function<void(void)>> logicQueue;
+  auto logic = std::make_shared<llarp::Logic>();
+  logic->SetQueuer([&](std::function<void(void)> f) {
+    std::lock_guard<std::mutex> lock{logicMutex};
+    logicQueue.emplace_back(std::move(f));
+  });
+
+  std::vector<std::thread> workers;
+  llarp::SignatureVerifier verifier{
+      logic, [&](std::function<void(void)> f) { workers.emplace_back(std::move(f)); }};
+
+  std::vector<llarp::RouterContact> rcs;
+  for (size_t idx = 0; idx < 20; ++idx)
+    rcs.emplace_back(MakeRC());
+  // break a few signatures
+  rcs[3].signature[0] ^= 1;
+  rcs[11].signature[0] ^= 1;
+  rcs[19].signature[0] ^= 1;
+  const auto submitted = rcs;
+
+  size_t calls = 0;
+  std::vector<llarp::RouterContact> gotRCs;
+  std::vector<bool> gotValid;
+  verifier.VerifyRCs(
+      std::move(rcs),
+      llarp::time_now_ms(),
+      [&](std::vector<llarp::RouterContact> checked, std::vector<bool> valid) {
+        calls++;
+        gotRCs = std::move(checked);
+        gotValid = std::move(valid);
+      });
+
+  for (auto& worker : workers)
+    worker.join();
+
+  REQUIRE(calls == 0);
+  REQUIRE(logicQueue.size() == 1);
+  logicQueue[0]();
+  REQUIRE(calls == 1);
+
+  REQUIRE(gotRCs == submitted);
+  REQUIRE(gotValid.size() == submitted.size());
+  for (size_t idx = 0; idx < gotValid.size(); ++idx)
+    CHECK(gotValid[idx] == (idx != 3 and idx != 11 and idx != 19));
+
+  const auto status = verifier.ExtractStatus();
+  CHECK(status["batches"] == 1);
+  CHECK(status["checked"] == 20);
+  CHECK(status["invalid"] == 3);
+  CHECK(status["pending"] == 0);
+}
+
+TEST_CASE("SignatureVerifier completes an empty batch", "[RC][signature][verify]")
+{
+  std::vector<std::function<void(void)>> logicQueue;
+  auto logic = std::make_shared<llarp::Logic>();
+  logic->SetQueuer([&](std::function<void(void)> f) { logicQueue.emplace_back(std::move(f)); });
+
+  llarp::SignatureVerifier verifier{logic, [](std::function<void(void)>) { FAIL("no work"); }};
+
+  bool called = false;
+  verifier.VerifyRCs({}, llarp::time_now_ms(), [&](auto checked, auto valid) {
+    called = true;
+    CHECK(checked.empty());
+    CHECK(valid.empty());
+  });
+  REQUIRE(logicQueue.size() == 1);
+  logicQueue[0]();
+  REQUIRE(called);
+}
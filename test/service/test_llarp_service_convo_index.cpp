@@ -0,0 +1,97 @@
+#include <service/convo_index.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+
+using namespace llarp;
+using namespace std::literals;
+
+namespace
+{
+  service::Address
+  MakeAddress()
+  {
+    service::Address addr;
+    addr.Randomize();
+    return addr;
+  }
+
+  service::ConvoTag
+  MakeTag()
+  {
+    service::ConvoTag tag;
+    tag.Randomize();
+    return tag;
+  }
+}  // namespace
+
+TEST_CASE("the best convo follows use", "[service]")
+{
+  service::ConvoIndex index;
+  const auto remote = MakeAddress();
+  const auto first = MakeTag(), second = MakeTag();
+  REQUIRE_FALSE(index.Best(remote));
+
+  index.Add(remote, first, false, 1s);
+  index.Add(remote, second, false, 2s);
+  REQUIRE(index.Best(remote) == second);
+  index.Touch(remote, first, 3s);
+  REQUIRE(index.Best(remote) == first);
+  // touching a convo the index does not have changes nothing
+  index.Touch(remote, MakeTag(), 4s);
+  REQUIRE(index.Best(remote) == first);
+}
+
+TEST_CASE("removing the best convo picks the next most recent", "[service]")
+{
+  service::ConvoIndex index;
+  const auto remote = MakeAddress();
+  const auto oldest = MakeTag(), newer = MakeTag(), newest = MakeTag();
+  index.Add(remote, oldest, false, 1s);
+  index.Add(remote, newer, false, 2s);
+  index.Add(remote, newest, false, 3s);
+
+  index.Remove(remote, newest);
+  REQUIRE(index.Best(remote) == newer);
+  index.Remove(remote, oldest);
+  REQUIRE(index.Best(remote) == newer);
+  index.Remove(remote, newer);
+  REQUIRE_FALSE(index.Best(remote));
+  REQUIRE(index.NumRemotes() == 0);
+}
+
+TEST_CASE("inbound convos are counted per remote", "[service]")
+{
+  service::ConvoIndex index;
+  const auto remote = MakeAddress(), other = MakeAddress();
+  const auto in = MakeTag(), out = MakeTag();
+  index.Add(remote, in, true, 1s);
+  index.Add(remote, out, false, 1s);
+  index.Add(other, MakeTag(), false, 1s);
+  REQUIRE(index.HasInbound(remote));
+  REQUIRE_FALSE(index.HasInbound(other));
+
+  // adding the same tag twice must not count it twice
+  index.Add(remote, in, true, 2s);
+  index.Remove(remote, in);
+  REQUIRE_FALSE(index.HasInbound(remote));
+  REQUIRE(index.Best(remote) == out);
+}
+
+TEST_CASE("tags of a remote", "[service]")
+{
+  service::ConvoIndex index;
+  const auto remote = MakeAddress();
+  const auto first = MakeTag(), second = MakeTag();
+  index.Add(remote, first, false, 1s);
+  index.Add(remote, second, true, 1s);
+  index.Add(MakeAddress(), MakeTag(), false, 1s);
+
+  std::set<service::ConvoTag> tags;
+  REQUIRE_FALSE(index.GetTags(MakeAddress(), tags));
+  REQUIRE(index.GetTags(remote, tags));
+  REQUIRE(tags == std::set<service::ConvoTag>{first, second});
+  REQUIRE_FALSE(index.GetTags(remote, tags));
+  REQUIRE(index.NumRemotes() == 2);
+}
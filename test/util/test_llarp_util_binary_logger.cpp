@@ -0,0 +1,101 @@
+#include <catch2/catch.hpp>
+
+#include <util/logging/binary_logger.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  struct Point
+  {
+    int x, y;
+  };
+
+  std::ostream&
+  operator<<(std::ostream& out, const Point& p)
+  {
+    return out << "(" << p.x << "," << p.y << ")";
+  }
+
+  /// the text after the tab of every decoded line
+  std::vector<std::string>
+  Decode(FILE* f)
+  {
+    std::rewind(f);
+    std::stringstream out;
+    REQUIRE(llarp::DecodeBinaryLog(f, out));
+    std::vector<std::string> msgs;
+    std::string line;
+    while (std::getline(out, line))
+      msgs.emplace_back(line.substr(line.find('\t') + 1));
+    return msgs;
+  }
+}  // namespace
+
+TEST_CASE("binary log entries decode to the text they were logged with", "[util][logging]")
+{
+  FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  {
+    llarp::BinaryLogStream stream{f, "node", false};
+    const std::string str{"string"};
+    stream.Record(llarp::eLogInfo, "file.cpp", 12, "int ", -5, " uint ", 7u, " char ", 'c');
+    stream.Record(llarp::eLogWarn, "file.cpp", 13, str, " ", 1.5, " ", Point{1, 2});
+    stream.ImmediateFlush();
+  }
+  REQUIRE(Decode(f) == std::vector<std::string>{"int -5 uint 7 char c", "string 1.5 (1,2)"});
+
+  std::rewind(f);
+  std::stringstream out;
+  REQUIRE(llarp::DecodeBinaryLog(f, out));
+  std::string first;
+  std::getline(out, first);
+  REQUIRE(first.find("[NFO] [node](") == 0);
+  REQUIRE(first.find("UTC file.cpp:12\t") != std::string::npos);
+  std::fclose(f);
+}
+
+TEST_CASE("binary log keeps entries of every thread", "[util][logging]")
+{
+  FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  constexpr int threads = 4;
+  constexpr int perThread = 1000;
+  {
+    llarp::BinaryLogStream stream{f, "node", false};
+    std::vector<std::thread> workers;
+    for (int idx = 0; idx < threads; ++idx)
+      workers.emplace_back([&stream, idx]() {
+        for (int n = 0; n < perThread; ++n)
+          stream.Record(llarp::eLogDebug, "file.cpp", idx, idx, ":", n);
+      });
+    for (auto& worker : workers)
+      worker.join();
+  }
+  const auto msgs = Decode(f);
+  REQUIRE(msgs.size() == threads * perThread);
+  // the rings are drained in order, so each thread's entries stay in order
+  std::vector<int> next(threads, 0);
+  for (const auto& msg : msgs)
+  {
+    const auto sep = msg.find(':');
+    const int idx = std::stoi(msg.substr(0, sep));
+    REQUIRE(std::stoi(msg.substr(sep + 1)) == next[idx]++);
+  }
+  std::fclose(f);
+}
+
+TEST_CASE("binary log rejects other files", "[util][logging]")
+{
+  FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  std::fputs("[I] not a binary log\n", f);
+  std::rewind(f);
+  std::stringstream out;
+  REQUIRE_FALSE(llarp::DecodeBinaryLog(f, out));
+  std::fclose(f);
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+
+#include <util/bucket_queue.hpp>
+
+#include <memory>
+#include <vector>
+
+using llarp::util::BucketQueue;
+
+TEST_CASE("BucketQueue pops the lowest priority first", "[util][queue]")
+{
+  BucketQueue<int> queue;
+  REQUIRE(queue.Empty());
+  queue.Push(5, 50);
+  queue.Push(0, 1);
+  queue.Push(65535, 100);
+  queue.Push(0, 2);
+  queue.Push(5, 51);
+  REQUIRE(queue.Size() == 5);
+  REQUIRE(queue.Front() == 1);
+
+  std::vector<int> popped;
+  while (not queue.Empty())
+    popped.push_back(queue.Pop());
+  // same priority comes out in the order it went in
+  REQUIRE(popped == std::vector<int>{1, 2, 50, 51, 100});
+}
+
+TEST_CASE("BucketQueue keeps order while its rings grow and wrap", "[util][queue]")
+{
+  BucketQueue<std::unique_ptr<int>> queue;
+  int next = 0;
+  int expect = 0;
+  for (size_t round = 0; round < 10; ++round)
+  {
+    for (size_t idx = 0; idx < 7 * round; ++idx)
+      queue.Push(1, std::make_unique<int>(next++));
+    for (size_t idx = 0; idx < 5 * round; ++idx)
+      REQUIRE(*queue.Pop() == expect++);
+  }
+  while (not queue.Empty())
+    REQUIRE(*queue.Pop() == expect++);
+  REQUIRE(expect == next);
+}
+
+TEST_CASE("BucketQueue swap", "[util][queue]")
+{
+  BucketQueue<int> queue, other;
+  queue.Push(1, 1);
+  queue.Push(2, 2);
+  queue.swap(other);
+  REQUIRE(queue.Empty());
+  REQUIRE(other.Size() == 2);
+  REQUIRE(other.Pop() == 1);
+}
@@ -0,0 +1,125 @@
+#include <util/buffer_pool.hpp>
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using Buffer_t = llarp::util::PooledBuffer<128>;
+
+TEST_CASE("PooledBuffer behaves like a fixed capacity byte vector", "[buffer-pool]")
+{
+  Buffer_t empty;
+  REQUIRE(empty.empty());
+  REQUIRE(empty.data() == nullptr);
+
+  Buffer_t buf(16);
+  REQUIRE(buf.size() == 16);
+  for (const auto& b : buf)
+    REQUIRE(b == 0);
+  buf[3] = 42;
+  buf.resize(32);
+  REQUIRE(buf.size() == 32);
+  REQUIRE(buf[3] == 42);
+  REQUIRE(buf[31] == 0);
+  REQUIRE_THROWS_AS(buf.resize(Buffer_t::MaxSize + 1), std::length_error);
+
+  const byte_t data[] = {1, 2, 3, 4};
+  Buffer_t copied{data, sizeof(data)};
+  REQUIRE(copied.size() == sizeof(data));
+  REQUIRE(std::equal(copied.begin(), copied.end(), std::begin(data)));
+}
+
+TEST_CASE("PooledBuffer copies share and moves transfer", "[buffer-pool]")
+{
+  Buffer_t buf(8);
+  REQUIRE(buf.unique());
+  {
+    const Buffer_t shared = buf;
+    REQUIRE(shared.data() == std::as_const(buf).data());
+    REQUIRE(not buf.unique());
+  }
+  REQUIRE(buf.unique());
+
+  const auto* ptr = buf.data();
+  Buffer_t moved = std::move(buf);
+  REQUIRE(moved.data() == ptr);
+  REQUIRE(buf.empty());
+  REQUIRE(buf.data() == nullptr);
+}
+
+TEST_CASE("PooledBuffer detach copies only shared bytes", "[buffer-pool]")
+{
+  Buffer_t buf(8);
+  buf[0] = 7;
+  const auto ptr = buf.data();
+  buf.detach();
+  REQUIRE(buf.data() == ptr);
+
+  Buffer_t shared = buf;
+  shared.detach();
+  REQUIRE(shared.unique());
+  REQUIRE(buf.unique());
+  REQUIRE(shared.data() != buf.data());
+  REQUIRE(shared.size() == buf.size());
+  REQUIRE(shared[0] == 7);
+}
+
+TEST_CASE("PooledBuffer writes through a copy do not show up in the original", "[buffer-pool]")
+{
+  Buffer_t buf(8);
+  buf[0] = 1;
+  const auto* ptr = std::as_const(buf).data();
+
+  Buffer_t indexed = buf;
+  indexed[0] = 2;
+  REQUIRE(std::as_const(buf)[0] == 1);
+  REQUIRE(std::as_const(indexed)[0] == 2);
+
+  Buffer_t written = buf;
+  std::fill(written.begin(), written.end(), 3);
+  REQUIRE(std::as_const(buf)[0] == 1);
+
+  Buffer_t grown = buf;
+  grown.resize(16);
+  grown.data()[15] = 4;
+  REQUIRE(buf.size() == 8);
+  REQUIRE(std::as_const(grown)[0] == 1);
+
+  Buffer_t shrunk = buf;
+  shrunk.resize_for_overwrite(4);
+  REQUIRE(buf.size() == 8);
+  REQUIRE(shrunk.size() == 4);
+
+  // the original kept its bytes and is the only one left holding them
+  REQUIRE(buf.unique());
+  REQUIRE(std::as_const(buf).data() == ptr);
+  REQUIRE(buf[0] == 1);
+}
+
+TEST_CASE("BufferPool recycles released buffers", "[buffer-pool]")
+{
+  const auto& stats = Buffer_t::PoolStats();
+  const byte_t* first = nullptr;
+  {
+    Buffer_t buf(1);
+    first = buf.data();
+  }
+  const auto hits = stats.hits.load();
+  Buffer_t again(1);
+  REQUIRE(again.data() == first);
+  REQUIRE(stats.hits.load() == hits + 1);
+  REQUIRE(stats.highWater.load() >= stats.inUse.load());
+}
+
+TEST_CASE("BufferPool handles buffers released on another thread", "[buffer-pool]")
+{
+  std::vector<Buffer_t> bufs;
+  for (size_t idx = 0; idx < 256; ++idx)
+    bufs.emplace_back(Buffer_t(64));
+  const auto inUse = Buffer_t::PoolStats().inUse.load();
+  std::thread worker{[bufs = std::move(bufs)]() mutable { bufs.clear(); }};
+  worker.join();
+  REQUIRE(Buffer_t::PoolStats().inUse.load() == inUse - 256);
+}
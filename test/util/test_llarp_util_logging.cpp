@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include <util/logging/logger.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+  /// keeps the messages logged while it is installed
+  struct CaptureLogStream : public llarp::ILogStream
+  {
+    std::vector<std::string>& lines;
+
+    explicit CaptureLogStream(std::vector<std::string>& l) : lines{l}
+    {}
+
+    void
+    PreLog(std::stringstream&, llarp::LogLevel, const char*, int, const std::string&) const override
+    {}
+
+    void
+    Print(llarp::LogLevel, const char*, const std::string& msg) override
+    {
+      lines.emplace_back(msg);
+    }
+
+    void
+    PostLog(std::stringstream&) const override
+    {}
+
+    void
+    ImmediateFlush() override
+    {}
+
+    void Tick(llarp_time_t) override
+    {}
+  };
+
+  /// swaps in a capturing log stream at a given level for the scope of a test
+  struct CaptureLogs
+  {
+    std::vector<std::string> lines;
+    llarp::ILogStream_ptr oldStream;
+    llarp::LogLevel oldLevel;
+
+    explicit CaptureLogs(llarp::LogLevel lvl)
+    {
+      auto& ctx = llarp::LogContext::Instance();
+      oldStream = std::move(ctx.logStream);
+      oldLevel = ctx.curLevel;
+      ctx.logStream = std::make_unique<CaptureLogStream>(lines);
+      ctx.curLevel = lvl;
+    }
+
+    ~CaptureLogs()
+    {
+      auto& ctx = llarp::LogContext::Instance();
+      ctx.logStream = std::move(oldStream);
+      ctx.curLevel = oldLevel;
+    }
+  };
+
+  /// logs a line of its own while being formatted
+  struct LogsWhenPrinted
+  {
+  };
+
+  std::ostream&
+  operator<<(std::ostream& out, const LogsWhenPrinted&)
+  {
+    llarp::LogWarn("inner");
+    return out << "outer";
+  }
+}  // namespace
+
+TEST_CASE("log arguments are only evaluated when the line is logged", "[util][logging]")
+{
+  CaptureLogs capture{llarp::eLogInfo};
+  size_t evaluated = 0;
+  const auto arg = [&]() {
+    evaluated++;
+    return "x";
+  };
+  llarp::LogDebug("debug ", arg());
+  REQUIRE(evaluated == 0);
+  REQUIRE(capture.lines.empty());
+  llarp::LogInfo("info ", arg());
+  REQUIRE(evaluated == 1);
+  REQUIRE(capture.lines == std::vector<std::string>{"info x"});
+}
+
+TEST_CASE("log lines formatted one after another do not run together", "[util][logging]")
+{
+  CaptureLogs capture{llarp::eLogInfo};
+  llarp::LogInfo("first ", 1);
+  llarp::LogInfo("second ", 2);
+  REQUIRE(capture.lines == std::vector<std::string>{"first 1", "second 2"});
+}
+
+TEST_CASE("logging while formatting a log line", "[util][logging]")
+{
+  CaptureLogs capture{llarp::eLogInfo};
+  llarp::LogInfo("before ", LogsWhenPrinted{}, " after");
+  REQUIRE(capture.lines == std::vector<std::string>{"inner", "before outer after"});
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+
+#include <crypto/types.hpp>
+#include <util/replay_filter.hpp>
+
+using llarp::util::NonceReplayFilter;
+using llarp::util::SequenceReplayFilter;
+
+TEST_CASE("SequenceReplayFilter rejects repeats", "[util][replay]")
+{
+  SequenceReplayFilter<128> filter;
+  REQUIRE(filter.Size() == 0);
+  REQUIRE_FALSE(filter.Contains(0));
+  REQUIRE(filter.Insert(0));
+  REQUIRE_FALSE(filter.Insert(0));
+  // out of order inside the window is fine
+  REQUIRE(filter.Insert(10));
+  REQUIRE(filter.Insert(5));
+  REQUIRE_FALSE(filter.Insert(5));
+  REQUIRE_FALSE(filter.Contains(6));
+  REQUIRE(filter.Size() == 3);
+}
+
+TEST_CASE("SequenceReplayFilter treats numbers below the window as seen", "[util][replay]")
+{
+  SequenceReplayFilter<128> filter;
+  REQUIRE(filter.Insert(1000));
+  REQUIRE_FALSE(filter.Contains(1000 - 127));
+  REQUIRE(filter.Contains(1000 - 128));
+  REQUIRE_FALSE(filter.Insert(1000 - 128));
+  REQUIRE(filter.Insert(1000 - 127));
+}
+
+TEST_CASE("SequenceReplayFilter forgets bits the window slides past", "[util][replay]")
+{
+  SequenceReplayFilter<128> filter;
+  for (uint64_t seq = 0; seq < 128; seq += 2)
+    REQUIRE(filter.Insert(seq));
+  REQUIRE(filter.Size() == 64);
+  // the bits for 128 and up reuse the words 0 to 127 had, they must start clear
+  REQUIRE(filter.Insert(129));
+  REQUIRE_FALSE(filter.Contains(128));
+  REQUIRE(filter.Insert(128));
+  REQUIRE(filter.Contains(2));
+  REQUIRE(filter.Size() == 64 - 1 + 2);
+  // a jump past the whole window drops everything
+  REQUIRE(filter.Insert(10000));
+  REQUIRE(filter.Size() == 1);
+  REQUIRE_FALSE(filter.Contains(9999));
+}
+
+TEST_CASE("NonceReplayFilter rejects repeats", "[util][replay]")
+{
+  NonceReplayFilter<llarp::TunnelNonce> filter{5s};
+  llarp::TunnelNonce nonce;
+  REQUIRE(filter.Empty());
+  REQUIRE(filter.Insert(nonce));
+  REQUIRE_FALSE(filter.Insert(nonce));
+  REQUIRE(filter.Contains(nonce));
+
+  std::vector<llarp::TunnelNonce> nonces(1000);
+  for (auto& n : nonces)
+  {
+    n.Randomize();
+    REQUIRE(filter.Insert(n));
+  }
+  for (const auto& n : nonces)
+    REQUIRE_FALSE(filter.Insert(n));
+}
+
+TEST_CASE("NonceReplayFilter remembers for one to two intervals", "[util][replay]")
+{
+  static constexpr auto interval = 5s;
+  static constexpr auto now = 1000s;
+  NonceReplayFilter<llarp::TunnelNonce> filter{interval};
+  llarp::TunnelNonce first, second;
+  first.Randomize();
+  second.Randomize();
+
+  filter.Decay(now);
+  REQUIRE(filter.Insert(first));
+  filter.Decay(now + interval - 1ms);
+  REQUIRE(filter.Contains(first));
+  filter.Decay(now + interval);
+  REQUIRE(filter.Insert(second));
+  // still there a generation later
+  REQUIRE(filter.Contains(first));
+  REQUIRE_FALSE(filter.Insert(first));
+  filter.Decay(now + interval * 2);
+  REQUIRE_FALSE(filter.Contains(first));
+  REQUIRE(filter.Contains(second));
+  filter.Decay(now + interval * 3);
+  REQUIRE(filter.Empty());
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include <util/timer_wheel.hpp>
+
+#include <random>
+#include <vector>
+
+using llarp::util::TimerWheel;
+using Time_t = TimerWheel<int>::Time_t;
+
+TEST_CASE("TimerWheel fires timers when they are due", "[util][timer]")
+{
+  const Time_t start = 1000000ms;
+  TimerWheel<int> wheel{1ms, start};
+  std::vector<int> fired;
+  const auto collect = [&](int val) { fired.push_back(val); };
+
+  wheel.Schedule(start + 5ms, 5);
+  wheel.Schedule(start + 1ms, 1);
+  wheel.Schedule(start + 300ms, 300);
+  REQUIRE(wheel.Size() == 3);
+
+  wheel.Advance(start, collect);
+  REQUIRE(fired.empty());
+  wheel.Advance(start + 4ms, collect);
+  REQUIRE(fired == std::vector<int>{1});
+  wheel.Advance(start + 299ms, collect);
+  REQUIRE(fired == std::vector<int>{1, 5});
+  wheel.Advance(start + 300ms, collect);
+  REQUIRE(fired == std::vector<int>{1, 5, 300});
+  REQUIRE(wheel.Size() == 0);
+}
+
+TEST_CASE("TimerWheel fires overdue timers on the next advance", "[util][timer]")
+{
+  const Time_t start = 1000000ms;
+  TimerWheel<int> wheel{1ms, start};
+  wheel.Advance(start + 10ms, [](int) {});
+  wheel.Schedule(start, 1);
+  size_t fired = 0;
+  wheel.Advance(start + 10ms, [&](int) { fired++; });
+  REQUIRE(fired == 1);
+}
+
+TEST_CASE("TimerWheel timers may schedule more timers", "[util][timer]")
+{
+  const Time_t start = 1000000ms;
+  TimerWheel<int> wheel{1ms, start};
+  Time_t now = start;
+  size_t fired = 0;
+  wheel.Schedule(start + 1ms, 0);
+  for (size_t step = 0; step < 10; ++step)
+  {
+    now += 1ms;
+    wheel.Advance(now, [&](int val) {
+      fired++;
+      wheel.Schedule(now + 1ms, val + 1);
+    });
+  }
+  REQUIRE(fired == 10);
+  REQUIRE(wheel.Size() == 1);
+}
+
+TEST_CASE("TimerWheel keeps timers across all levels", "[util][timer]")
+{
+  const Time_t start = 1234567ms;
+  TimerWheel<Time_t> wheel{1ms, start};
+  std::mt19937_64 rng{42};
+  // from the finest level out past the last one
+  std::uniform_int_distribution<uint64_t> delay{0, uint64_t{1} << 28};
+  std::vector<Time_t> deadlines;
+  for (size_t idx = 0; idx < 2000; ++idx)
+  {
+    deadlines.emplace_back(start + Time_t(delay(rng)));
+    wheel.Schedule(deadlines.back(), deadlines.back());
+  }
+  // advance in big uneven steps, nothing may fire early or be skipped
+  Time_t now = start;
+  size_t fired = 0;
+  while (wheel.Size() > 0)
+  {
+    now += Time_t(1 + (rng() % 100000));
+    wheel.Advance(now, [&](Time_t when) {
+      REQUIRE(when <= now);
+      REQUIRE(when > now - 100001ms);
+      fired++;
+    });
+  }
+  REQUIRE(fired == deadlines.size());
+}
@@ -0,0 +1,189 @@
+#include <util/thread/worker_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using llarp::thread::WorkerPool;
+using llarp::thread::WorkLane;
+
+namespace
+{
+  /// counts down finished jobs so a test can wait for all of them
+  struct Latch
+  {
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t left;
+
+    explicit Latch(size_t n) : left{n}
+    {}
+
+    void
+    Done()
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (--left == 0)
+        cond.notify_all();
+    }
+
+    bool
+    Wait()
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      return cond.wait_for(lock, std::chrono::seconds{10}, [this]() { return left == 0; });
+    }
+  };
+}  // namespace
+
+TEST_CASE("WorkerPool runs every job", "[util][thread]")
+{
+  WorkerPool pool{"test"};
+  REQUIRE_FALSE(pool.Submit(WorkLane::Bulk, []() {}));
+  pool.Start(4);
+  REQUIRE(pool.NumWorkers() == 4);
+
+  constexpr size_t jobs = 10000;
+  std::atomic<size_t> ran{0};
+  Latch latch{jobs};
+  for (size_t idx = 0; idx < jobs; ++idx)
+  {
+    const auto lane = idx % 10 ? WorkLane::Bulk : WorkLane::Handshake;
+    REQUIRE(pool.Submit(lane, idx % 7, [&]() {
+      ran++;
+      latch.Done();
+    }));
+  }
+  REQUIRE(latch.Wait());
+  REQUIRE(ran == jobs);
+
+  // a job is counted once it returns, after it let the latch go
+  pool.Stop();
+  const auto status = pool.ExtractStatus();
+  REQUIRE(status["lanes"]["handshake"]["jobs"] == jobs / 10);
+  REQUIRE(status["lanes"]["bulk"]["jobs"] == jobs - jobs / 10);
+  REQUIRE_FALSE(pool.Submit(WorkLane::Bulk, []() {}));
+}
+
+TEST_CASE("WorkerPool keeps an affinity on one worker while it is idle", "[util][thread]")
+{
+  WorkerPool pool{"test"};
+  pool.Start(4);
+  std::mutex mutex;
+  std::map<std::thread::id, size_t> threads;
+  for (size_t idx = 0; idx < 100; ++idx)
+  {
+    // one at a time so there is nothing worth stealing
+    Latch latch{1};
+    pool.Submit(WorkLane::Bulk, 42, [&]() {
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        threads[std::this_thread::get_id()]++;
+      }
+      latch.Done();
+    });
+    REQUIRE(latch.Wait());
+  }
+  size_t most = 0;
+  for (const auto& [id, count] : threads)
+    most = std::max(most, count);
+  // a preempted owner can lose the odd job to a thief
+  REQUIRE(most >= 90);
+}
+
+TEST_CASE("WorkerPool idle workers steal from a busy one", "[util][thread]")
+{
+  WorkerPool pool{"test"};
+  pool.Start(4);
+  constexpr size_t jobs = 64;
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  Latch latch{jobs};
+  // every job has the same affinity, only stealing spreads them out
+  for (size_t idx = 0; idx < jobs; ++idx)
+  {
+    pool.Submit(WorkLane::Bulk, 42, [&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        threads.insert(std::this_thread::get_id());
+      }
+      latch.Done();
+    });
+  }
+  REQUIRE(latch.Wait());
+  REQUIRE(threads.size() > 1);
+  REQUIRE(pool.ExtractStatus()["lanes"]["bulk"]["stolen"] > 0);
+}
+
+TEST_CASE("WorkerPool runs handshakes ahead of queued bulk work", "[util][thread]")
+{
+  WorkerPool pool{"test"};
+  pool.Start(1);
+  std::mutex mutex;
+  std::vector<int> order;
+  Latch started{1};
+  Latch release{1};
+  Latch finished{4};
+  const auto record = [&](int val) {
+    return [&, val]() {
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        order.push_back(val);
+      }
+      finished.Done();
+    };
+  };
+  // hold the only worker so everything after queues up
+  pool.Submit(WorkLane::Bulk, [&]() {
+    started.Done();
+    release.Wait();
+  });
+  REQUIRE(started.Wait());
+  pool.Submit(WorkLane::Bulk, record(1));
+  pool.Submit(WorkLane::Bulk, record(2));
+  pool.Submit(WorkLane::Handshake, record(3));
+  pool.Submit(WorkLane::Bulk, record(4));
+  release.Done();
+  REQUIRE(finished.Wait());
+  REQUIRE(order == std::vector<int>{3, 1, 2, 4});
+}
+
+TEST_CASE("WorkerPool steals a job soon after it is old enough", "[util][thread]")
+{
+  WorkerPool pool{"test"};
+  pool.Start(2);
+  std::vector<WorkerPool::Clock_t::duration> waits;
+  for (size_t idx = 0; idx < 20; ++idx)
+  {
+    // the owner is held up until its second job has been stolen and run
+    Latch started{1};
+    Latch stolen{1};
+    Latch done{2};
+    pool.Submit(WorkLane::Bulk, 42, [&]() {
+      started.Done();
+      stolen.Wait();
+      done.Done();
+    });
+    REQUIRE(started.Wait());
+    const auto queuedAt = WorkerPool::Clock_t::now();
+    pool.Submit(WorkLane::Bulk, 42, [&]() {
+      waits.push_back(WorkerPool::Clock_t::now() - queuedAt);
+      stolen.Done();
+      done.Done();
+    });
+    REQUIRE(done.Wait());
+  }
+  // a thief that finds the job too young looks again once it can be stolen, it does not sleep
+  // for a whole IdleInterval; the median keeps a slow scheduler from failing the test
+  std::nth_element(waits.begin(), waits.begin() + waits.size() / 2, waits.end());
+  REQUIRE(waits[waits.size() / 2] < WorkerPool::IdleInterval);
+}
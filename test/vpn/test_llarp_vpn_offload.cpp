@@ -0,0 +1,289 @@
+#include <vpn/offload.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  constexpr size_t TCPHeaderSize = 32;
+
+  uint16_t
+  Get16(const byte_t* ptr)
+  {
+    return (uint16_t{ptr[0]} << 8) | ptr[1];
+  }
+
+  uint32_t
+  Get32(const byte_t* ptr)
+  {
+    return (uint32_t{Get16(ptr)} << 16) | Get16(ptr + 2);
+  }
+
+  uint32_t
+  Sum(const byte_t* buf, size_t sz, uint32_t sum = 0)
+  {
+    for (; sz > 1; sz -= 2, buf += 2)
+      sum += Get16(buf);
+    if (sz)
+      sum += uint32_t{buf[0]} << 8;
+    return sum;
+  }
+
+  uint16_t
+  Fold(uint32_t sum)
+  {
+    while (sum >> 16)
+      sum = (sum & 0xffff) + (sum >> 16);
+    return sum;
+  }
+
+  /// a tcp segment with timestamp options and a payload counting up from offset, headers and
+  /// checksums as a tun hands them over with offloads on: lengths of the whole thing and the
+  /// pseudo header sum in the checksum field
+  std::vector<byte_t>
+  MakeTCP(bool v6, uint16_t srcPort, uint32_t seq, size_t payload, size_t offset, bool push)
+  {
+    const size_t ipLen = v6 ? 40 : 20;
+    std::vector<byte_t> pkt(ipLen + TCPHeaderSize + payload);
+    byte_t* ip = pkt.data();
+    if (v6)
+    {
+      ip[0] = 0x60;
+      ip[4] = (pkt.size() - 40) >> 8;
+      ip[5] = pkt.size() - 40;
+      ip[6] = 6;
+      ip[7] = 64;
+      ip[23] = 1;
+      ip[39] = 2;
+    }
+    else
+    {
+      ip[0] = 0x45;
+      ip[2] = pkt.size() >> 8;
+      ip[3] = pkt.size();
+      ip[6] = 0x40;
+      ip[8] = 64;
+      ip[9] = 6;
+      const byte_t addrs[] = {10, 0, 0, 1, 10, 0, 0, 2};
+      std::copy_n(addrs, sizeof(addrs), ip + 12);
+    }
+    byte_t* tcp = ip + ipLen;
+    tcp[0] = srcPort >> 8;
+    tcp[1] = srcPort;
+    tcp[3] = 80;
+    tcp[4] = seq >> 24;
+    tcp[5] = seq >> 16;
+    tcp[6] = seq >> 8;
+    tcp[7] = seq;
+    tcp[11] = 1;
+    tcp[12] = (TCPHeaderSize / 4) << 4;
+    tcp[13] = push ? 0x18 : 0x10;
+    tcp[14] = 0xff;
+    // nop, nop, timestamps
+    const byte_t options[] = {1, 1, 8, 10, 0, 0, 0, 1, 0, 0, 0, 2};
+    std::copy_n(options, sizeof(options), tcp + 20);
+    for (size_t idx = 0; idx < payload; ++idx)
+      tcp[TCPHeaderSize + idx] = (offset + idx) & 0xff;
+    const size_t l4Len = pkt.size() - ipLen;
+    const uint32_t pseudo = (v6 ? Sum(ip + 8, 32) : Sum(ip + 12, 8)) + 6 + l4Len;
+    tcp[16] = Fold(pseudo) >> 8;
+    tcp[17] = Fold(pseudo);
+    return pkt;
+  }
+
+  /// the same segment with its checksums filled in
+  net::IPPacket
+  MakeFinishedTCP(
+      bool v6, uint16_t srcPort, uint32_t seq, size_t payload, size_t offset, bool push)
+  {
+    const auto data = MakeTCP(v6, srcPort, seq, payload, offset, push);
+    vpn::VirtioNetHeader hdr;
+    hdr.flags = vpn::VirtioNetHeader::NeedsChecksum;
+    hdr.csumStart = v6 ? 40 : 20;
+    hdr.csumOffset = 16;
+    std::vector<net::IPPacket> out;
+    REQUIRE(vpn::SplitSuperPacket(hdr, data.data(), data.size(), out));
+    REQUIRE(out.size() == 1);
+    if (not v6)
+    {
+      byte_t* ip = out[0].data();
+      ip[10] = 0;
+      ip[11] = 0;
+      const uint16_t check = ~Fold(Sum(ip, 20));
+      ip[10] = check >> 8;
+      ip[11] = check;
+    }
+    return out[0];
+  }
+
+  bool
+  ChecksumsValid(const byte_t* ip, size_t sz)
+  {
+    const bool v6 = (ip[0] >> 4) == 6;
+    const size_t ipLen = v6 ? 40 : 20;
+    if (not v6 and Fold(Sum(ip, ipLen)) != 0xffff)
+      return false;
+    const size_t l4Len = sz - ipLen;
+    const byte_t proto = v6 ? ip[6] : ip[9];
+    const uint32_t pseudo = (v6 ? Sum(ip + 8, 32) : Sum(ip + 12, 8)) + proto + l4Len;
+    return Fold(Sum(ip + ipLen, l4Len, pseudo)) == 0xffff;
+  }
+
+  vpn::VirtioNetHeader
+  TSOHeader(bool v6, uint16_t segSize)
+  {
+    vpn::VirtioNetHeader hdr;
+    hdr.flags = vpn::VirtioNetHeader::NeedsChecksum;
+    hdr.gsoType = v6 ? vpn::VirtioNetHeader::GSOTCPv6 : vpn::VirtioNetHeader::GSOTCPv4;
+    hdr.hdrLen = (v6 ? 40 : 20) + TCPHeaderSize;
+    hdr.gsoSize = segSize;
+    hdr.csumStart = v6 ? 40 : 20;
+    hdr.csumOffset = 16;
+    return hdr;
+  }
+}  // namespace
+
+TEST_CASE("tcp super packets are cut into checksummed segments", "[vpn]")
+{
+  const bool v6 = GENERATE(false, true);
+  const size_t ipLen = v6 ? 40 : 20;
+  const auto super = MakeTCP(v6, 1234, 1000, 3500, 0, true);
+  std::vector<net::IPPacket> out;
+  REQUIRE(vpn::SplitSuperPacket(TSOHeader(v6, 1000), super.data(), super.size(), out));
+  REQUIRE(out.size() == 4);
+  for (size_t idx = 0; idx < out.size(); ++idx)
+  {
+    const auto& pkt = out[idx];
+    const byte_t* tcp = pkt.data() + ipLen;
+    const size_t payload = idx < 3 ? 1000 : 500;
+    REQUIRE(pkt.size() == ipLen + TCPHeaderSize + payload);
+    REQUIRE(Get16(pkt.data() + (v6 ? 4 : 2)) == (v6 ? pkt.size() - 40 : pkt.size()));
+    REQUIRE(Get32(tcp + 4) == 1000 + idx * 1000);
+    // only the last segment is pushed
+    REQUIRE(tcp[13] == (idx < 3 ? 0x10 : 0x18));
+    REQUIRE(tcp[TCPHeaderSize] == ((idx * 1000) & 0xff));
+    REQUIRE(ChecksumsValid(pkt.data(), pkt.size()));
+  }
+}
+
+TEST_CASE("udp super packets are cut into datagrams", "[vpn]")
+{
+  constexpr size_t payload = 2500;
+  std::vector<byte_t> super(20 + 8 + payload);
+  super[0] = 0x45;
+  super[2] = super.size() >> 8;
+  super[3] = super.size();
+  super[9] = 17;
+  super[15] = 1;
+  super[19] = 2;
+  super[21] = 53;
+  super[23] = 53;
+
+  vpn::VirtioNetHeader hdr;
+  hdr.flags = vpn::VirtioNetHeader::NeedsChecksum;
+  hdr.gsoType = vpn::VirtioNetHeader::GSOUDPL4;
+  hdr.hdrLen = 28;
+  hdr.gsoSize = 1200;
+  hdr.csumStart = 20;
+  hdr.csumOffset = 6;
+  std::vector<net::IPPacket> out;
+  REQUIRE(vpn::SplitSuperPacket(hdr, super.data(), super.size(), out));
+  REQUIRE(out.size() == 3);
+  REQUIRE(out[2].size() == 28 + 100);
+  for (const auto& pkt : out)
+  {
+    REQUIRE(Get16(pkt.data() + 24) == pkt.size() - 20);
+    REQUIRE(ChecksumsValid(pkt.data(), pkt.size()));
+  }
+}
+
+TEST_CASE("udp super packets with datagrams too big to hold are dropped", "[vpn]")
+{
+  constexpr size_t maxPayload = net::IPPacket::MaxSize - 28;
+  std::vector<byte_t> super(28 + maxPayload * 2 + 2);
+  super[0] = 0x45;
+  super[9] = 17;
+
+  vpn::VirtioNetHeader hdr;
+  hdr.gsoType = vpn::VirtioNetHeader::GSOUDPL4;
+  hdr.hdrLen = 28;
+  hdr.gsoSize = maxPayload + 1;
+  std::vector<net::IPPacket> out;
+  REQUIRE_FALSE(vpn::SplitSuperPacket(hdr, super.data(), super.size(), out));
+  REQUIRE(out.empty());
+
+  // datagrams that just fit go through whole
+  hdr.gsoSize = maxPayload;
+  REQUIRE(vpn::SplitSuperPacket(hdr, super.data(), super.size(), out));
+  REQUIRE(out.size() == 3);
+  REQUIRE(out[0].size() == net::IPPacket::MaxSize);
+  REQUIRE(out[2].size() == 28 + 2);
+}
+
+TEST_CASE("malformed super packets are dropped", "[vpn]")
+{
+  std::vector<net::IPPacket> out;
+  const auto super = MakeTCP(false, 1234, 0, 3000, 0, true);
+  // claims udp segmentation of a tcp packet
+  auto hdr = TSOHeader(false, 1000);
+  hdr.gsoType = vpn::VirtioNetHeader::GSOUDPL4;
+  REQUIRE_FALSE(vpn::SplitSuperPacket(hdr, super.data(), super.size(), out));
+  // too big without segmentation
+  REQUIRE_FALSE(vpn::SplitSuperPacket({}, super.data(), super.size(), out));
+  // cut short
+  REQUIRE_FALSE(vpn::SplitSuperPacket(TSOHeader(false, 1000), super.data(), 30, out));
+  REQUIRE(out.empty());
+}
+
+TEST_CASE("consecutive segments of a flow are coalesced", "[vpn]")
+{
+  const bool v6 = GENERATE(false, true);
+  const size_t ipLen = v6 ? 40 : 20;
+  std::vector<net::IPPacket> pkts;
+  for (uint32_t idx = 0; idx < 4; ++idx)
+  {
+    const bool last = idx == 3;
+    const size_t payload = last ? 400 : 1000;
+    pkts.emplace_back(MakeFinishedTCP(v6, 1234, idx * 1000, payload, idx * 1000, last));
+  }
+  // another flow, then a gap in the first one
+  pkts.emplace_back(MakeFinishedTCP(v6, 4321, 0, 1000, 0, false));
+  pkts.emplace_back(MakeFinishedTCP(v6, 1234, 5000, 1000, 0, false));
+
+  std::vector<std::pair<vpn::VirtioNetHeader, std::vector<byte_t>>> written;
+  const auto num = vpn::CoalescePackets(
+      pkts, [&](const vpn::VirtioNetHeader& hdr, const byte_t* data, size_t sz) {
+        written.emplace_back(hdr, std::vector<byte_t>(data, data + sz));
+        return true;
+      });
+  REQUIRE(num == pkts.size());
+  REQUIRE(written.size() == 3);
+
+  const auto& [hdr, super] = written[0];
+  REQUIRE(hdr.gsoType == (v6 ? vpn::VirtioNetHeader::GSOTCPv6 : vpn::VirtioNetHeader::GSOTCPv4));
+  REQUIRE(hdr.gsoSize == 1000);
+  REQUIRE(hdr.hdrLen == ipLen + TCPHeaderSize);
+  REQUIRE(super.size() == ipLen + TCPHeaderSize + 3400);
+  for (size_t idx = 0; idx < 3400; ++idx)
+    REQUIRE(super[ipLen + TCPHeaderSize + idx] == (idx & 0xff));
+
+  // cutting it up again gives back the segments we started with
+  std::vector<net::IPPacket> again;
+  REQUIRE(vpn::SplitSuperPacket(hdr, super.data(), super.size(), again));
+  REQUIRE(again.size() == 4);
+  for (size_t idx = 0; idx < again.size(); ++idx)
+  {
+    REQUIRE(again[idx].size() == pkts[idx].size());
+    const auto& pkt = again[idx];
+    REQUIRE(std::equal(pkt.data() + ipLen, pkt.data() + pkt.size(), pkts[idx].data() + ipLen));
+  }
+
+  for (size_t idx = 1; idx < written.size(); ++idx)
+  {
+    REQUIRE(written[idx].first.gsoType == vpn::VirtioNetHeader::GSONone);
+    REQUIRE(written[idx].second.size() == pkts[idx + 3].size());
+  }
+}
@@ -0,0 +1,282 @@
+#include <vpn/queue_workers.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  /// an ipv4 udp packet of a flow, numbered by seqno
+  net::IPPacket
+  MakePacket(uint16_t srcPort, uint16_t dstPort, uint32_t seqno)
+  {
+    net::IPPacket pkt{};
+    pkt.resize(32);
+    byte_t* buf = pkt.data();
+    buf[0] = 0x45;
+    buf[9] = 17;
+    const byte_t addrs[] = {10, 0, 0, 1, 10, 0, 0, 2};
+    std::copy_n(addrs, sizeof(addrs), buf + 12);
+    buf[20] = srcPort >> 8;
+    buf[21] = srcPort;
+    buf[22] = dstPort >> 8;
+    buf[23] = dstPort;
+    std::copy_n(reinterpret_cast<const byte_t*>(&seqno), sizeof(seqno), buf + 28);
+    return pkt;
+  }
+
+  uint32_t
+  Seqno(const net::IPPacket& pkt)
+  {
+    uint32_t seqno;
+    std::copy_n(pkt.data() + 28, sizeof(seqno), reinterpret_cast<byte_t*>(&seqno));
+    return seqno;
+  }
+
+  uint16_t
+  SrcPort(const net::IPPacket& pkt)
+  {
+    return (pkt.data()[20] << 8) | pkt.data()[21];
+  }
+
+  /// a multi-queue interface backed by memory
+  struct MemoryInterface : public vpn::NetworkInterface
+  {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<std::deque<net::IPPacket>> toRead;
+    std::vector<std::vector<net::IPPacket>> written;
+    /// reads fail with this errno while it is set, like a queue whose interface went away
+    int readError = 0;
+    size_t reads = 0;
+
+    explicit MemoryInterface(size_t queues) : toRead(queues), written(queues)
+    {}
+
+    int
+    PollFD() const override
+    {
+      return -1;
+    }
+
+    std::string
+    IfName() const override
+    {
+      return "memory";
+    }
+
+    net::IPPacket
+    ReadNextPacket() override
+    {
+      return ReadNextPacketFrom(0);
+    }
+
+    bool
+    HasNextPacket() override
+    {
+      return false;
+    }
+
+    bool
+    WritePacket(net::IPPacket pkt) override
+    {
+      return WritePacketTo(0, std::move(pkt));
+    }
+
+    size_t
+    NumQueues() const override
+    {
+      return toRead.size();
+    }
+
+    net::IPPacket
+    ReadNextPacketFrom(size_t queue) override
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      net::IPPacket pkt{};
+      reads++;
+      if (readError)
+      {
+        errno = readError;
+        return pkt;
+      }
+      if (toRead[queue].empty())
+        return pkt;
+      pkt = toRead[queue].front();
+      toRead[queue].pop_front();
+      return pkt;
+    }
+
+    bool
+    WaitForPacket(size_t queue, std::chrono::milliseconds timeout) override
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      // poll reports a queue in error as readable right away
+      return cond.wait_for(
+          lock, timeout, [&]() { return readError != 0 or not toRead[queue].empty(); });
+    }
+
+    bool
+    WritePacketTo(size_t queue, net::IPPacket pkt) override
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      written[queue].emplace_back(std::move(pkt));
+      cond.notify_all();
+      return true;
+    }
+
+    size_t
+    NumWritten()
+    {
+      size_t num = 0;
+      for (const auto& queue : written)
+        num += queue.size();
+      return num;
+    }
+  };
+}  // namespace
+
+TEST_CASE("a flow always goes to the same queue", "[vpn]")
+{
+  std::set<size_t> used;
+  for (uint16_t port = 1000; port < 1064; ++port)
+  {
+    const auto queue = vpn::QueueWorkers::FlowQueue(MakePacket(port, 53, 0), 4);
+    REQUIRE(queue < 4);
+    REQUIRE(vpn::QueueWorkers::FlowQueue(MakePacket(port, 53, 1), 4) == queue);
+    used.insert(queue);
+  }
+  REQUIRE(used.size() > 1);
+  REQUIRE(vpn::QueueWorkers::FlowQueue(MakePacket(1000, 53, 0), 1) == 0);
+
+  net::IPPacket runt{};
+  runt.resize(4);
+  REQUIRE(vpn::QueueWorkers::FlowQueue(runt, 4) == 0);
+}
+
+TEST_CASE("ipv4 fragments after the first are steered by addresses alone", "[vpn]")
+{
+  // what sits where the ports would be is payload, different for every fragment of a flow
+  std::set<size_t> used;
+  for (uint16_t port = 1000; port < 1064; ++port)
+  {
+    auto frag = MakePacket(port, 53, 0);
+    frag.data()[6] = 0x20 | (port % 2);
+    frag.data()[7] = 185;
+    used.insert(vpn::QueueWorkers::FlowQueue(frag, 4));
+  }
+  REQUIRE(used.size() == 1);
+
+  // the first fragment carries the udp header and is steered like the rest of its flow
+  auto first = MakePacket(1000, 53, 0);
+  first.data()[6] = 0x20;
+  REQUIRE(
+      vpn::QueueWorkers::FlowQueue(first, 4)
+      == vpn::QueueWorkers::FlowQueue(MakePacket(1000, 53, 1), 4));
+}
+
+TEST_CASE("queue workers back off from a queue that keeps failing", "[vpn]")
+{
+  auto netif = std::make_shared<MemoryInterface>(1);
+  netif->readError = EBADFD;
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  size_t numRead = 0;
+  vpn::QueueWorkers workers{netif, [&](std::vector<net::IPPacket> pkts) {
+                              std::lock_guard<std::mutex> lock{mutex};
+                              numRead += pkts.size();
+                              cond.notify_all();
+                            }};
+  workers.Start();
+  std::this_thread::sleep_for(vpn::QueueWorkers::WakeInterval * 5);
+  {
+    std::lock_guard<std::mutex> lock{netif->mutex};
+    // one read per back off and not a spin, with some slack for a slow scheduler
+    REQUIRE(netif->reads > 0);
+    REQUIRE(netif->reads <= 10);
+    // once the queue works again it is read again
+    netif->readError = 0;
+    netif->toRead[0].emplace_back(MakePacket(1000, 53, 0));
+    netif->cond.notify_all();
+  }
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    REQUIRE(cond.wait_for(lock, std::chrono::seconds{10}, [&]() { return numRead == 1; }));
+  }
+  REQUIRE(workers.ExtractStatus()["queues"][0]["readErrors"] > 0);
+  workers.Stop();
+}
+
+TEST_CASE("queue workers read every queue and keep flows in order", "[vpn]")
+{
+  constexpr size_t queues = 4;
+  constexpr uint32_t perFlow = 50;
+  constexpr uint16_t flows = 16;
+  auto netif = std::make_shared<MemoryInterface>(queues);
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::vector<net::IPPacket> read;
+  size_t biggestBatch = 0;
+  vpn::QueueWorkers workers{netif, [&](std::vector<net::IPPacket> pkts) {
+                              std::lock_guard<std::mutex> lock{mutex};
+                              biggestBatch = std::max(biggestBatch, pkts.size());
+                              for (auto& pkt : pkts)
+                                read.emplace_back(std::move(pkt));
+                              cond.notify_all();
+                            }};
+  REQUIRE(workers.NumQueues() == queues);
+  workers.Start();
+
+  {
+    std::lock_guard<std::mutex> lock{netif->mutex};
+    for (uint32_t seqno = 0; seqno < perFlow; ++seqno)
+    {
+      for (uint16_t flow = 0; flow < flows; ++flow)
+        netif->toRead[flow % queues].emplace_back(MakePacket(flow, 53, seqno));
+    }
+    netif->cond.notify_all();
+  }
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    REQUIRE(cond.wait_for(lock, std::chrono::seconds{10}, [&]() {
+      return read.size() == perFlow * flows;
+    }));
+  }
+  REQUIRE(biggestBatch <= vpn::QueueWorkers::MaxReadBatch);
+
+  for (const auto& pkt : read)
+    REQUIRE(workers.WritePacket(pkt));
+  {
+    std::unique_lock<std::mutex> lock{netif->mutex};
+    REQUIRE(netif->cond.wait_for(lock, std::chrono::seconds{10}, [&]() {
+      return netif->NumWritten() == perFlow * flows;
+    }));
+  }
+  workers.Stop();
+
+  // every flow was written on one queue, in the order it was read
+  std::map<uint16_t, size_t> flowQueue;
+  std::map<uint16_t, uint32_t> nextSeqno;
+  for (size_t queue = 0; queue < queues; ++queue)
+  {
+    for (const auto& pkt : netif->written[queue])
+    {
+      const auto flow = SrcPort(pkt);
+      REQUIRE(flowQueue.emplace(flow, queue).first->second == queue);
+      REQUIRE(Seqno(pkt) == nextSeqno[flow]++);
+    }
+  }
+  REQUIRE(flowQueue.size() == flows);
+  REQUIRE(workers.ExtractStatus()["queues"].size() == queues);
+}